@@ -0,0 +1,145 @@
+/*
+ * arena.c - CS50 'arena' module
+ *
+ * see arena.h for more information.
+ *
+ * Blocks form a list, newest first; allocations come from the newest
+ * block until it is full. A request too big to share a block gets a
+ * block of its own, put behind the newest so that block's free space
+ * isn't wasted.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdalign.h>
+#include "mem.h"
+#include "arena.h"
+
+/**************** local constants ****************/
+static const size_t DEFAULT_BLOCK_SIZE = 65536;
+static const size_t ALIGNMENT = alignof(max_align_t);
+
+/**************** local types ****************/
+typedef struct block {
+  struct block* next;
+  size_t size;              // bytes of data
+  size_t used;              // bytes of data handed out
+  max_align_t data[];       // flexible array, aligned for any type
+} block_t;
+
+typedef struct arena {
+  block_t* blocks;          // newest first
+  size_t blockSize;
+  size_t bytes;             // total malloc'd for blocks
+} arena_t;
+
+/**************** local functions ****************/
+static block_t* newBlock(arena_t* arena, const size_t size);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** arena_new ****************/
+/* see arena.h for more information */
+arena_t* arena_new(size_t blockSize) {
+  arena_t* arena = mem_malloc(sizeof(arena_t));
+  if (arena == NULL) {
+    return NULL;
+  }
+  arena->blocks = NULL;
+  arena->blockSize = (blockSize == 0) ? DEFAULT_BLOCK_SIZE : blockSize;
+  arena->bytes = 0;
+  return arena;
+}
+
+/**************** arena_alloc ****************/
+/* see arena.h for more information */
+void* arena_alloc(arena_t* arena, size_t size) {
+  if (arena == NULL) {
+    return NULL;
+  }
+  //round up, so the next allocation stays aligned
+  size = (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+  block_t* block = arena->blocks;
+  if (block == NULL || block->size - block->used < size) {
+    if (size > arena->blockSize / 4) {
+      //big: a block of its own, behind the newest
+      block = newBlock(arena, size);
+      if (block == NULL) {
+        return NULL;
+      }
+      if (arena->blocks != NULL) {
+        block->next = arena->blocks->next;
+        arena->blocks->next = block;
+      } else {
+        arena->blocks = block;
+      }
+    } else {
+      block = newBlock(arena, arena->blockSize);
+      if (block == NULL) {
+        return NULL;
+      }
+      block->next = arena->blocks;
+      arena->blocks = block;
+    }
+  }
+  void* p = (char*)block->data + block->used;
+  block->used += size;
+  return p;
+}
+
+/**************** arena_strdup ****************/
+/* see arena.h for more information */
+char* arena_strdup(arena_t* arena, const char* s) {
+  if (s == NULL) {
+    return NULL;
+  }
+  size_t len = strlen(s) + 1;
+  char* copy = arena_alloc(arena, len);
+  if (copy != NULL) {
+    memcpy(copy, s, len);
+  }
+  return copy;
+}
+
+/**************** arena_bytes ****************/
+/* see arena.h for more information */
+size_t arena_bytes(arena_t* arena) {
+  return (arena == NULL) ? 0 : arena->bytes;
+}
+
+/**************** arena_delete ****************/
+/* see arena.h for more information */
+void arena_delete(arena_t* arena) {
+  if (arena != NULL) {
+    block_t* block = arena->blocks;
+    while (block != NULL) {
+      block_t* next = block->next;
+      free(block);
+      block = next;
+    }
+    mem_free(arena);
+  }
+}
+
+/**************** newBlock ****************/
+/* malloc a block with size bytes of data, not yet in the list;
+ * returns NULL if out of memory
+ * not visible to outsiders, not in arena.h
+ */
+static block_t* newBlock(arena_t* arena, const size_t size) {
+  block_t* block = malloc(sizeof(block_t) + size);
+  if (block == NULL) {
+    return NULL;
+  }
+  block->next = NULL;
+  block->size = size;
+  block->used = 0;
+  arena->bytes += sizeof(block_t) + size;
+  return block;
+}
@@ -0,0 +1,61 @@
+/*
+ * arena.h - header file for CS50 'arena' module
+ *
+ * an arena hands out memory by bumping a pointer through large blocks
+ * it mallocs as needed, and frees it all at once when deleted. It suits
+ * many small allocations that live and die together, like the words and
+ * postings of an index: each costs a few bytes instead of a malloc call
+ * and its bookkeeping, and freeing the lot takes one free per block.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct arena arena_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** arena_new ****************/
+/* Create a new (empty) arena.
+ *
+ * Caller provides:
+ *   size of the blocks to allocate, in bytes; 0 for a default of 64 KB.
+ * We return:
+ *   pointer to a new arena, or NULL if error.
+ * Caller is responsible for:
+ *   later calling arena_delete.
+ */
+arena_t* arena_new(size_t blockSize);
+
+/**************** arena_alloc ****************/
+/* Allocate size bytes from the arena.
+ *
+ * We return:
+ *   pointer to size bytes, aligned for any type, or NULL if arena is
+ *   NULL or out of memory. The memory is not cleared.
+ * We guarantee:
+ *   the memory stays valid until arena_delete; it cannot be freed
+ *   on its own.
+ */
+void* arena_alloc(arena_t* arena, size_t size);
+
+/**************** arena_strdup ****************/
+/* Copy a string into the arena; return the copy, or NULL if error. */
+char* arena_strdup(arena_t* arena, const char* s);
+
+/**************** arena_bytes ****************/
+/* Return the bytes the arena holds from malloc, 0 if arena is NULL. */
+size_t arena_bytes(arena_t* arena);
+
+/**************** arena_delete ****************/
+/* Free every block, and with them everything allocated from the arena;
+ * we ignore NULL arena. */
+void arena_delete(arena_t* arena);
+
+#endif // ARENA_H
@@ -0,0 +1,191 @@
+/*
+ * bitmap.c - CS50 'bitmap' module
+ *
+ * see bitmap.h for more information.
+ *
+ * Bit n is bit n % 8 of byte n / 8. Writing a byte as two hex digits,
+ * high nibble first, keeps the text independent of word size and byte
+ * order.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "bitmap.h"
+
+/**************** local types ****************/
+typedef struct bitmap {
+  unsigned char* bytes;
+  int numBytes;             // size of bytes; unset bits are zero
+} bitmap_t;
+
+/**************** local functions ****************/
+static bool grow(bitmap_t* bitmap, const int numBytes);
+static int hexValue(const char c);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** bitmap_new ****************/
+/* see bitmap.h for more information */
+bitmap_t* bitmap_new(void) {
+  bitmap_t* bitmap = mem_malloc(sizeof(bitmap_t));
+  if (bitmap == NULL) {
+    return NULL;
+  }
+  bitmap->bytes = NULL;
+  bitmap->numBytes = 0;
+  return bitmap;
+}
+
+/**************** bitmap_set ****************/
+/* see bitmap.h for more information */
+bool bitmap_set(bitmap_t* bitmap, const int n) {
+  if (bitmap == NULL || n < 0 || !grow(bitmap, n / 8 + 1)) {
+    return false;
+  }
+  bitmap->bytes[n / 8] |= 1 << (n % 8);
+  return true;
+}
+
+/**************** bitmap_test ****************/
+/* see bitmap.h for more information */
+bool bitmap_test(bitmap_t* bitmap, const int n) {
+  if (bitmap == NULL || n < 0 || n / 8 >= bitmap->numBytes) {
+    return false;
+  }
+  return (bitmap->bytes[n / 8] & (1 << (n % 8))) != 0;
+}
+
+/**************** bitmap_count ****************/
+/* see bitmap.h for more information */
+int bitmap_count(bitmap_t* bitmap) {
+  if (bitmap == NULL) {
+    return 0;
+  }
+  int count = 0;
+  for (int i = 0; i < bitmap->numBytes; i++) {
+    for (unsigned char b = bitmap->bytes[i]; b != 0; b &= b - 1) {
+      count++;    // b &= b - 1 clears the lowest set bit
+    }
+  }
+  return count;
+}
+
+/**************** bitmap_copy ****************/
+/* see bitmap.h for more information */
+bitmap_t* bitmap_copy(bitmap_t* bitmap) {
+  if (bitmap == NULL) {
+    return NULL;
+  }
+  bitmap_t* copy = bitmap_new();
+  if (copy == NULL || !grow(copy, bitmap->numBytes)) {
+    bitmap_delete(copy);
+    return NULL;
+  }
+  if (bitmap->numBytes > 0) {
+    memcpy(copy->bytes, bitmap->bytes, bitmap->numBytes);
+  }
+  return copy;
+}
+
+/**************** bitmap_write ****************/
+/* see bitmap.h for more information */
+void bitmap_write(bitmap_t* bitmap, FILE* fp) {
+  static const char digits[] = "0123456789abcdef";
+  if (bitmap == NULL || fp == NULL) {
+    return;
+  }
+  //drop trailing zero bytes, which hold nothing
+  int numBytes = bitmap->numBytes;
+  while (numBytes > 0 && bitmap->bytes[numBytes - 1] == 0) {
+    numBytes--;
+  }
+  if (numBytes == 0) {
+    fputc('0', fp);
+  }
+  for (int i = 0; i < numBytes; i++) {
+    fputc(digits[bitmap->bytes[i] >> 4], fp);
+    fputc(digits[bitmap->bytes[i] & 0xf], fp);
+  }
+}
+
+/**************** bitmap_parse ****************/
+/* see bitmap.h for more information */
+bitmap_t* bitmap_parse(const char* hex) {
+  if (hex == NULL) {
+    return NULL;
+  }
+  bitmap_t* bitmap = bitmap_new();
+  if (bitmap == NULL) {
+    return NULL;
+  }
+  //"0" is the empty bitmap; otherwise two digits per byte
+  size_t len = strlen(hex);
+  if (strcmp(hex, "0") == 0) {
+    return bitmap;
+  }
+  if (len % 2 != 0 || !grow(bitmap, len / 2)) {
+    bitmap_delete(bitmap);
+    return NULL;
+  }
+  for (size_t i = 0; i < len; i += 2) {
+    int high = hexValue(hex[i]);
+    int low = hexValue(hex[i + 1]);
+    if (high < 0 || low < 0) {
+      bitmap_delete(bitmap);
+      return NULL;
+    }
+    bitmap->bytes[i / 2] = high << 4 | low;
+  }
+  return bitmap;
+}
+
+/**************** bitmap_delete ****************/
+/* see bitmap.h for more information */
+void bitmap_delete(bitmap_t* bitmap) {
+  if (bitmap != NULL) {
+    free(bitmap->bytes);
+    mem_free(bitmap);
+  }
+}
+
+/**************** grow ****************/
+/* make sure the bitmap has at least numBytes bytes, new ones zero;
+ * returns false if out of memory
+ * not visible to outsiders, not in bitmap.h
+ */
+static bool grow(bitmap_t* bitmap, const int numBytes) {
+  if (numBytes <= bitmap->numBytes) {
+    return true;
+  }
+  //at least double, so setting increasing integers takes linear time
+  int newBytes = (numBytes < bitmap->numBytes * 2) ? bitmap->numBytes * 2 : numBytes;
+  unsigned char* bytes = realloc(bitmap->bytes, newBytes);
+  if (bytes == NULL) {
+    return false;
+  }
+  memset(bytes + bitmap->numBytes, 0, newBytes - bitmap->numBytes);
+  bitmap->bytes = bytes;
+  bitmap->numBytes = newBytes;
+  return true;
+}
+
+/**************** hexValue ****************/
+/* value of a hex digit, or -1 if c isn't one
+ * not visible to outsiders, not in bitmap.h
+ */
+static int hexValue(const char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
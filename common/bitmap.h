@@ -0,0 +1,75 @@
+/*
+ * bitmap.h - header file for CS50 'bitmap' module
+ *
+ * a bitmap is a set of non-negative integers, such as docIDs, kept as
+ * one bit per integer up to the largest in the set; it grows as needed.
+ * A bitmap can be written as a string of hex digits, two per byte,
+ * lowest integers first, so it fits on one line of a text file.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef BITMAP_H
+#define BITMAP_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct bitmap bitmap_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** bitmap_new ****************/
+/* Create a new (empty) bitmap.
+ *
+ * We return:
+ *   pointer to a new bitmap, or NULL if error.
+ * Caller is responsible for:
+ *   later calling bitmap_delete.
+ */
+bitmap_t* bitmap_new(void);
+
+/**************** bitmap_set ****************/
+/* Add n to the bitmap.
+ *
+ * We return:
+ *   true on success, false if bitmap is NULL, n is negative,
+ *   or there is no memory to grow the bitmap.
+ */
+bool bitmap_set(bitmap_t* bitmap, const int n);
+
+/**************** bitmap_test ****************/
+/* Return true if n is in the bitmap; false if not, or bitmap is NULL. */
+bool bitmap_test(bitmap_t* bitmap, const int n);
+
+/**************** bitmap_count ****************/
+/* Return the number of integers in the bitmap, 0 if bitmap is NULL. */
+int bitmap_count(bitmap_t* bitmap);
+
+/**************** bitmap_copy ****************/
+/* Return a new bitmap holding the same integers as bitmap,
+ * or NULL if bitmap is NULL or error.
+ * Caller is responsible for later calling bitmap_delete on the copy. */
+bitmap_t* bitmap_copy(bitmap_t* bitmap);
+
+/**************** bitmap_write ****************/
+/* Write the bitmap to fp as hex digits, without a newline;
+ * an empty bitmap is written as "0". */
+void bitmap_write(bitmap_t* bitmap, FILE* fp);
+
+/**************** bitmap_parse ****************/
+/* Create a bitmap from hex digits written by bitmap_write.
+ *
+ * We return:
+ *   pointer to a new bitmap, or NULL if hex isn't hex digits or error.
+ * Caller is responsible for:
+ *   later calling bitmap_delete.
+ */
+bitmap_t* bitmap_parse(const char* hex);
+
+/**************** bitmap_delete ****************/
+/* Delete the bitmap; we ignore NULL bitmap. */
+void bitmap_delete(bitmap_t* bitmap);
+
+#endif // BITMAP_H
@@ -0,0 +1,118 @@
+/*
+ * bloom.c - CS50 'bloom' module
+ *
+ * see bloom.h for more information.
+ *
+ * Each block is 512 bits, stored as 8 64-bit words. Part of the hash
+ * picks the block; two more 9-bit slices of it give a start and a step,
+ * and the key's k bits are start, start + step, start + 2*step, ...
+ * within that block.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "mem.h"
+#include "bloom.h"
+
+/**************** local constants ****************/
+static const int BLOCK_WORDS = 8;       // 64-bit words per block
+static const int BLOCK_BITS = 512;      // bits per block
+static const int MAX_HASHES = 16;       // upper bound on bits per key
+
+/**************** local types ****************/
+typedef struct bloom {
+  uint64_t* bits;       // numBlocks * BLOCK_WORDS words
+  size_t numBlocks;     // number of 512-bit blocks
+  int numHashes;        // bits set per key (k)
+} bloom_t;
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** bloom_new ****************/
+/* see bloom.h for more information */
+bloom_t* bloom_new(const int expected, const double fpRate) {
+  if (expected <= 0 || fpRate <= 0 || fpRate >= 1) {
+    return NULL;
+  }
+
+  //optimal size is -n ln(p) / ln(2)^2 bits, with k = (bits per key) ln(2)
+  double bitsPerKey = -log(fpRate) / (log(2) * log(2));
+  int numHashes = (int)(bitsPerKey * log(2) + 0.5);
+  if (numHashes < 1) {
+    numHashes = 1;
+  } else if (numHashes > MAX_HASHES) {
+    numHashes = MAX_HASHES;
+  }
+  size_t numBits = (size_t)(bitsPerKey * expected) + 1;
+
+  bloom_t* bloom = mem_malloc(sizeof(bloom_t));
+  if (bloom == NULL) {
+    return NULL;
+  }
+  bloom->numBlocks = (numBits + BLOCK_BITS - 1) / BLOCK_BITS;
+  bloom->numHashes = numHashes;
+  bloom->bits = calloc(bloom->numBlocks * BLOCK_WORDS, sizeof(uint64_t));
+  if (bloom->bits == NULL) {
+    mem_free(bloom);
+    return NULL;
+  }
+  return bloom;
+}
+
+/**************** bloom_add ****************/
+/* see bloom.h for more information */
+void bloom_add(bloom_t* bloom, const uint64_t hash) {
+  if (bloom == NULL) {
+    return;
+  }
+  uint64_t* block = bloom->bits + ((hash >> 18) % bloom->numBlocks) * BLOCK_WORDS;
+  unsigned bit = hash & (BLOCK_BITS - 1);
+  unsigned step = ((hash >> 9) & (BLOCK_BITS - 1)) | 1;   // odd, so bits differ
+  for (int i = 0; i < bloom->numHashes; i++) {
+    block[bit / 64] |= (uint64_t)1 << (bit % 64);
+    bit = (bit + step) & (BLOCK_BITS - 1);
+  }
+}
+
+/**************** bloom_check ****************/
+/* see bloom.h for more information */
+bool bloom_check(bloom_t* bloom, const uint64_t hash) {
+  if (bloom == NULL) {
+    return true;
+  }
+  uint64_t* block = bloom->bits + ((hash >> 18) % bloom->numBlocks) * BLOCK_WORDS;
+  unsigned bit = hash & (BLOCK_BITS - 1);
+  unsigned step = ((hash >> 9) & (BLOCK_BITS - 1)) | 1;
+  for (int i = 0; i < bloom->numHashes; i++) {
+    if ((block[bit / 64] & ((uint64_t)1 << (bit % 64))) == 0) {
+      //one bit unset, key was never added
+      return false;
+    }
+    bit = (bit + step) & (BLOCK_BITS - 1);
+  }
+  return true;
+}
+
+/**************** bloom_memory ****************/
+/* see bloom.h for more information */
+size_t bloom_memory(bloom_t* bloom) {
+  if (bloom == NULL) {
+    return 0;
+  }
+  return sizeof(bloom_t) + bloom->numBlocks * BLOCK_WORDS * sizeof(uint64_t);
+}
+
+/**************** bloom_delete ****************/
+/* see bloom.h for more information */
+void bloom_delete(bloom_t* bloom) {
+  if (bloom != NULL) {
+    free(bloom->bits);
+    mem_free(bloom);
+  }
+}
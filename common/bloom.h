@@ -0,0 +1,67 @@
+/*
+ * bloom.h - header file for CS50 'bloom' module
+ *
+ * a bloom filter answers "have I seen this key?" with either "definitely
+ * not" or "maybe", using about 10 bits per key for a 1% false-positive
+ * rate. Keys are given as 64-bit hashes, so the caller decides how keys
+ * are hashed (urlset uses its URL fingerprints).
+ *
+ * The filter is split into 64-byte blocks and all the bits for a key
+ * lie in one block, so each check touches a single cache line.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef BLOOM_H
+#define BLOOM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**************** global types ****************/
+typedef struct bloom bloom_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** bloom_new ****************/
+/* Create a new (empty) bloom filter.
+ *
+ * Caller provides:
+ *   expected - number of keys expected, > 0
+ *   fpRate - target false-positive rate once expected keys are added,
+ *     between 0 and 1 (e.g. 0.01)
+ * We return:
+ *   pointer to a new filter, or NULL if error or invalid parameters.
+ * Notes:
+ *   the filter does not grow; past expected keys the false-positive
+ *   rate rises above fpRate.
+ * Caller is responsible for:
+ *   later calling bloom_delete.
+ */
+bloom_t* bloom_new(const int expected, const double fpRate);
+
+/**************** bloom_add ****************/
+/* Add a key, given by its 64-bit hash, to the filter. */
+void bloom_add(bloom_t* bloom, const uint64_t hash);
+
+/**************** bloom_check ****************/
+/* Check whether a key, given by its 64-bit hash, may be in the filter.
+ *
+ * We return:
+ *   false if the key was definitely never added,
+ *   true if it may have been added.
+ * We guarantee:
+ *   the filter is unchanged.
+ */
+bool bloom_check(bloom_t* bloom, const uint64_t hash);
+
+/**************** bloom_memory ****************/
+/* Return the number of bytes allocated for the filter, 0 if NULL. */
+size_t bloom_memory(bloom_t* bloom);
+
+/**************** bloom_delete ****************/
+/* Delete the filter; we ignore NULL bloom. */
+void bloom_delete(bloom_t* bloom);
+
+#endif // BLOOM_H
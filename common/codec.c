@@ -0,0 +1,376 @@
+/*
+ * codec.c - CS50 'codec' module
+ *
+ * see codec.h for more information.
+ *
+ * Decoding is where the time goes, so each decoder works a word or a
+ * byte at a time without going back over its input: vbyte takes one
+ * byte numbers (most docID gaps and counts) in a single test, simple8b
+ * unpacks all the numbers of a 64-bit word with one shift and mask
+ * each, and pfor unpacks a block through a 64-bit accumulator, then
+ * patches its exceptions. Multi-byte words are little-endian, put
+ * together a byte at a time, so the bytes don't depend on the machine.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec.h"
+
+/**************** local constants ****************/
+//simple8b: numbers per word, and bits per number, for each selector;
+//selectors 0 and 1 are runs of 240 or 120 numbers that are all 1
+static const int S8B_COUNT[16] = { 240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1 };
+static const int S8B_BITS[16] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60 };
+
+#define PFOR_BLOCK 128                // numbers per pfor block
+
+/**************** local functions ****************/
+static size_t vbyteEncode(const uint32_t* values, const int n, unsigned char* out);
+static bool vbyteDecode(const unsigned char* in, const size_t len, uint32_t* values, const int n);
+static size_t s8bEncode(const uint32_t* values, const int n, unsigned char* out);
+static bool s8bDecode(const unsigned char* in, const size_t len, uint32_t* values, const int n);
+static size_t pforEncode(const uint32_t* values, const int n, unsigned char* out);
+static bool pforDecode(const unsigned char* in, const size_t len, uint32_t* values, const int n);
+static int bitWidth(uint32_t value);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** codec_parse ****************/
+/* see codec.h for more information */
+bool codec_parse(const char* name, codec_t* codec) {
+  static const codec_t codecs[] = { CODEC_NONE, CODEC_VBYTE, CODEC_SIMPLE8B, CODEC_PFOR };
+  for (int i = 0; name != NULL && i < (int)(sizeof(codecs) / sizeof(codecs[0])); i++) {
+    if (strcmp(name, codec_name(codecs[i])) == 0) {
+      *codec = codecs[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************** codec_name ****************/
+/* see codec.h for more information */
+const char* codec_name(const codec_t codec) {
+  switch (codec) {
+  case CODEC_VBYTE:
+    return "vbyte";
+  case CODEC_SIMPLE8B:
+    return "simple8b";
+  case CODEC_PFOR:
+    return "pfor";
+  default:
+    return "text";
+  }
+}
+
+/**************** codec_maxBytes ****************/
+/* see codec.h for more information */
+size_t codec_maxBytes(const codec_t codec, const int n) {
+  switch (codec) {
+  case CODEC_VBYTE:
+    return 5 * (size_t)n;
+  case CODEC_SIMPLE8B:
+    return 8 * (size_t)n;
+  case CODEC_PFOR:
+    //never worse than every block at 32 bits, which has no exceptions
+    return 4 * (size_t)n + 2 * ((size_t)n / PFOR_BLOCK + 1);
+  default:
+    return 0;
+  }
+}
+
+/**************** codec_encode ****************/
+/* see codec.h for more information */
+size_t codec_encode(const codec_t codec, const uint32_t* values, const int n,
+                    unsigned char* out) {
+  switch (codec) {
+  case CODEC_VBYTE:
+    return vbyteEncode(values, n, out);
+  case CODEC_SIMPLE8B:
+    return s8bEncode(values, n, out);
+  case CODEC_PFOR:
+    return pforEncode(values, n, out);
+  default:
+    return 0;
+  }
+}
+
+/**************** codec_decode ****************/
+/* see codec.h for more information */
+bool codec_decode(const codec_t codec, const unsigned char* in, const size_t len,
+                  uint32_t* values, const int n) {
+  switch (codec) {
+  case CODEC_VBYTE:
+    return vbyteDecode(in, len, values, n);
+  case CODEC_SIMPLE8B:
+    return s8bDecode(in, len, values, n);
+  case CODEC_PFOR:
+    return pforDecode(in, len, values, n);
+  default:
+    return false;
+  }
+}
+
+/**************** codec_putVByte ****************/
+/* see codec.h for more information */
+size_t codec_putVByte(uint32_t value, unsigned char* out) {
+  size_t pos = 0;
+  while (value >= 128) {
+    out[pos++] = (value & 127) | 128;
+    value >>= 7;
+  }
+  out[pos++] = value;
+  return pos;
+}
+
+/**************** codec_getVByte ****************/
+/* see codec.h for more information */
+size_t codec_getVByte(const unsigned char* in, const size_t len, uint32_t* value) {
+  uint32_t v = 0;
+  for (size_t i = 0; i < len && i < 5; i++) {
+    v |= (uint32_t)(in[i] & 127) << (7 * i);
+    if (in[i] < 128) {
+      *value = v;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/**************** vbyteEncode ****************/
+/* not visible to outsiders, not in codec.h */
+static size_t vbyteEncode(const uint32_t* values, const int n, unsigned char* out) {
+  size_t pos = 0;
+  for (int i = 0; i < n; i++) {
+    pos += codec_putVByte(values[i], out + pos);
+  }
+  return pos;
+}
+
+/**************** vbyteDecode ****************/
+/* not visible to outsiders, not in codec.h */
+static bool vbyteDecode(const unsigned char* in, const size_t len, uint32_t* values, const int n) {
+  size_t pos = 0;
+  for (int i = 0; i < n; i++) {
+    if (pos < len && in[pos] < 128) {
+      //the usual case, a number below 128
+      values[i] = in[pos++];
+    } else {
+      size_t used = codec_getVByte(in + pos, len - pos, &values[i]);
+      if (used == 0) {
+        return false;
+      }
+      pos += used;
+    }
+  }
+  return pos == len;
+}
+
+/**************** s8bEncode ****************/
+/* pick, for each word, the first selector whose numbers all fit:
+ * the one that packs the most numbers
+ * not visible to outsiders, not in codec.h */
+static size_t s8bEncode(const uint32_t* values, const int n, unsigned char* out) {
+  size_t pos = 0;
+  int i = 0;
+  while (i < n) {
+    int remaining = n - i;
+    int sel;
+    int count = 0;
+    for (sel = 0; sel < 15; sel++) {
+      count = (remaining < S8B_COUNT[sel]) ? remaining : S8B_COUNT[sel];
+      if (sel < 2 && remaining < S8B_COUNT[sel]) {
+        continue;   //a run must be full
+      }
+      int j = 0;
+      if (sel < 2) {
+        while (j < count && values[i + j] == 1) {
+          j++;
+        }
+      } else {
+        while (j < count && (values[i + j] >> S8B_BITS[sel]) == 0) {
+          j++;
+        }
+      }
+      if (j == count) {
+        break;
+      }
+    }
+    if (sel == 15) {
+      count = 1;    //60 bits hold any number
+    }
+
+    uint64_t word = (uint64_t)sel << 60;
+    for (int j = 0; sel >= 2 && j < count; j++) {
+      word |= (uint64_t)values[i + j] << (j * S8B_BITS[sel]);
+    }
+    for (int b = 0; b < 8; b++) {
+      out[pos++] = (word >> (8 * b)) & 255;
+    }
+    i += count;
+  }
+  return pos;
+}
+
+/**************** s8bDecode ****************/
+/* not visible to outsiders, not in codec.h */
+static bool s8bDecode(const unsigned char* in, const size_t len, uint32_t* values, const int n) {
+  size_t pos = 0;
+  int i = 0;
+  while (i < n) {
+    if (pos + 8 > len) {
+      return false;
+    }
+    uint64_t word = 0;
+    for (int b = 0; b < 8; b++) {
+      word |= (uint64_t)in[pos + b] << (8 * b);
+    }
+    pos += 8;
+
+    int sel = word >> 60;
+    int count = (n - i < S8B_COUNT[sel]) ? n - i : S8B_COUNT[sel];
+    if (sel < 2) {
+      for (int j = 0; j < count; j++) {
+        values[i + j] = 1;
+      }
+    } else {
+      int bits = S8B_BITS[sel];
+      uint64_t mask = ((uint64_t)1 << bits) - 1;
+      for (int j = 0; j < count; j++) {
+        values[i + j] = (word >> (j * bits)) & mask;
+      }
+    }
+    i += count;
+  }
+  return pos == len;
+}
+
+/**************** pforEncode ****************/
+/* each block: its bit width b, its number of exceptions, the numbers'
+ * low b bits packed least significant first, then each exception's
+ * position in the block and (as vbyte) the bits above b; b is the
+ * width that makes the block smallest
+ * not visible to outsiders, not in codec.h */
+static size_t pforEncode(const uint32_t* values, const int n, unsigned char* out) {
+  size_t pos = 0;
+  for (int start = 0; start < n; start += PFOR_BLOCK) {
+    int count = (n - start < PFOR_BLOCK) ? n - start : PFOR_BLOCK;
+    const uint32_t* block = values + start;
+    int widths[PFOR_BLOCK];
+    int numWidths[33] = { 0 };    // how many numbers need each width
+    int maxWidth = 0;
+    for (int j = 0; j < count; j++) {
+      widths[j] = bitWidth(block[j]);
+      numWidths[widths[j]]++;
+      if (widths[j] > maxWidth) {
+        maxWidth = widths[j];
+      }
+    }
+
+    //cost every width up to the widest number, which needs no
+    //exceptions; an exception costs its position byte and the vbyte
+    //of its bits above the width
+    int width = maxWidth;
+    size_t best = ((size_t)count * maxWidth + 7) / 8;
+    for (int b = 0; b < maxWidth; b++) {
+      size_t cost = ((size_t)count * b + 7) / 8;
+      for (int w = b + 1; w <= maxWidth; w++) {
+        cost += numWidths[w] * (1 + (w - b + 6) / 7);
+      }
+      if (cost < best) {
+        best = cost;
+        width = b;
+      }
+    }
+
+    size_t header = pos;
+    out[pos++] = width;
+    out[pos++] = 0;
+    uint64_t mask = ((uint64_t)1 << width) - 1;
+    uint64_t acc = 0;
+    int have = 0;
+    for (int j = 0; j < count; j++) {
+      acc |= (block[j] & mask) << have;
+      have += width;
+      while (have >= 8) {
+        out[pos++] = acc & 255;
+        acc >>= 8;
+        have -= 8;
+      }
+    }
+    if (have > 0) {
+      out[pos++] = acc & 255;
+    }
+    for (int j = 0; width < 32 && j < count; j++) {
+      if (widths[j] > width) {
+        out[header + 1]++;
+        out[pos++] = j;
+        pos += codec_putVByte(block[j] >> width, out + pos);
+      }
+    }
+  }
+  return pos;
+}
+
+/**************** pforDecode ****************/
+/* not visible to outsiders, not in codec.h */
+static bool pforDecode(const unsigned char* in, const size_t len, uint32_t* values, const int n) {
+  size_t pos = 0;
+  for (int start = 0; start < n; start += PFOR_BLOCK) {
+    int count = (n - start < PFOR_BLOCK) ? n - start : PFOR_BLOCK;
+    uint32_t* block = values + start;
+    if (pos + 2 > len) {
+      return false;
+    }
+    int width = in[pos];
+    int exceptions = in[pos + 1];
+    pos += 2;
+    size_t packed = ((size_t)count * width + 7) / 8;
+    if (width > 32 || pos + packed > len || (width == 32 && exceptions > 0)) {
+      return false;
+    }
+
+    uint64_t mask = ((uint64_t)1 << width) - 1;
+    uint64_t acc = 0;
+    int have = 0;
+    for (int j = 0; j < count; j++) {
+      while (have < width) {
+        acc |= (uint64_t)in[pos++] << have;
+        have += 8;
+      }
+      block[j] = acc & mask;
+      acc >>= width;
+      have -= width;
+    }
+
+    for (int e = 0; e < exceptions; e++) {
+      uint32_t high;
+      size_t used;
+      if (pos >= len || in[pos] >= count
+          || (used = codec_getVByte(in + pos + 1, len - pos - 1, &high)) == 0) {
+        return false;
+      }
+      block[in[pos]] |= high << width;
+      pos += 1 + used;
+    }
+  }
+  return pos == len;
+}
+
+/**************** bitWidth ****************/
+/* number of bits needed for value, 0 for 0
+ * not visible to outsiders, not in codec.h */
+static int bitWidth(uint32_t value) {
+  int width = 0;
+  while (value != 0) {
+    width++;
+    value >>= 1;
+  }
+  return width;
+}
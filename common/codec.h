@@ -0,0 +1,97 @@
+/*
+ * codec.h - header file for CS50 'codec' module
+ *
+ * a codec packs a list of unsigned 32-bit integers, such as the docID
+ * gaps or the counts of a word's postings, into bytes, and unpacks it.
+ * Small numbers take the fewest bytes, so it pays to store the gaps
+ * between increasing docIDs rather than the docIDs themselves.
+ *
+ *   vbyte     7 bits per byte, the high bit set on every byte but a
+ *             number's last; 1 byte for numbers below 128
+ *   simple8b  64-bit words, each a 4-bit selector saying how many
+ *             numbers of how many bits fill the other 60 bits
+ *             (60 of 1 bit, 30 of 2, ... 1 of 60; or a run of 1s)
+ *   pfor      blocks of 128 numbers packed at one bit width, chosen
+ *             for the block; the few that don't fit are patched in
+ *             from a list of exceptions after the block
+ *
+ * The bytes of every codec are the same on any machine. An encoded list
+ * doesn't record its length: the caller keeps the count of numbers and
+ * the count of bytes.
+ *
+ * CODEC_NONE stands for the plain text index format, see index.h;
+ * codec_encode and codec_decode don't accept it.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**************** global types ****************/
+typedef enum codec {
+  CODEC_NONE,
+  CODEC_VBYTE,
+  CODEC_SIMPLE8B,
+  CODEC_PFOR
+} codec_t;
+
+/**************** functions ****************/
+
+/**************** codec_parse ****************/
+/* Find the codec with the given name: "text" (CODEC_NONE), "vbyte",
+ * "simple8b" or "pfor".
+ *
+ * We return:
+ *   true and *codec set if name is one of those, false otherwise.
+ */
+bool codec_parse(const char* name, codec_t* codec);
+
+/**************** codec_name ****************/
+/* Return the name of codec, as codec_parse takes it. */
+const char* codec_name(const codec_t codec);
+
+/**************** codec_maxBytes ****************/
+/* Return the most bytes codec_encode can write for n numbers. */
+size_t codec_maxBytes(const codec_t codec, const int n);
+
+/**************** codec_encode ****************/
+/* Encode n numbers.
+ *
+ * Caller provides:
+ *   a codec other than CODEC_NONE, n numbers in values,
+ *   out - room for codec_maxBytes(codec, n) bytes.
+ * We return:
+ *   the number of bytes written to out.
+ */
+size_t codec_encode(const codec_t codec, const uint32_t* values, const int n,
+                    unsigned char* out);
+
+/**************** codec_decode ****************/
+/* Decode n numbers from the len bytes at in.
+ *
+ * Caller provides:
+ *   the codec they were encoded with, other than CODEC_NONE,
+ *   values - room for n numbers.
+ * We return:
+ *   true if the len bytes held exactly n numbers, now in values;
+ *   false if not, and values holds garbage.
+ */
+bool codec_decode(const codec_t codec, const unsigned char* in, const size_t len,
+                  uint32_t* values, const int n);
+
+/**************** codec_putVByte ****************/
+/* Write value as vbyte to out, which has room for 5 bytes;
+ * return the number of bytes written. */
+size_t codec_putVByte(uint32_t value, unsigned char* out);
+
+/**************** codec_getVByte ****************/
+/* Read one vbyte number from the len bytes at in into *value;
+ * return the number of bytes read, 0 if in doesn't start with one. */
+size_t codec_getVByte(const unsigned char* in, const size_t len, uint32_t* value);
+
+#endif // CODEC_H
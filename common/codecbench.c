@@ -0,0 +1,220 @@
+/*
+ * codecbench.c - benchmark of the 'codec' module on an index's postings
+ *
+ * usage: ./codecbench indexFilename [passes]
+ *
+ * Reads a text index file, turns each word's postings into a list of
+ * docID gaps and a list of counts, and for each codec encodes every
+ * list, checks that it decodes to the same numbers, and prints the
+ * bytes per posting (gaps and counts together; the text file's for
+ * comparison) and the decoding speed, over passes (default 5).
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "mem.h"
+#include "reader.h"
+#include "codec.h"
+
+/**************** local types ****************/
+//every word's gaps, then counts, end to end
+typedef struct lists {
+  uint32_t* values;         // the numbers of list i are values[starts[i]] on
+  size_t* starts;           // numLists + 1 entries
+  int numLists;
+  size_t numValues;
+  size_t maxValues;         // size of values
+  int maxLists;             // size of starts, less 1
+  int longest;              // numbers in the longest list
+} lists_t;
+
+typedef struct posting {
+  int docID;
+  int count;
+} posting_t;
+
+/**************** local functions ****************/
+static double now(void);
+static size_t readLists(const char* indexFilename, lists_t* lists);
+static void addList(lists_t* lists, posting_t* postings, const int n, const bool counts);
+static int comparePostings(const void* a, const void* b);
+static bool benchCodec(const codec_t codec, lists_t* lists, const int passes,
+                       const size_t numPostings);
+
+/**************** main ****************/
+int main(int argc, char* argv[]) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s indexFilename [passes]\n", argv[0]);
+    exit(1);
+  }
+  int passes = (argc == 3) ? atoi(argv[2]) : 5;
+  if (passes < 1) {
+    fprintf(stderr, "passes must be at least 1\n");
+    exit(1);
+  }
+
+  lists_t lists = { NULL, NULL, 0, 0, 0, 0, 0 };
+  size_t fileBytes = readLists(argv[1], &lists);
+  size_t numPostings = lists.numValues / 2;
+  if (numPostings == 0) {
+    fprintf(stderr, "no postings in %s\n", argv[1]);
+    exit(1);
+  }
+  printf("%d words, %lu postings\n", lists.numLists / 2, (unsigned long)numPostings);
+  printf("%-9s %6.2f bytes/posting\n", "text", (double)fileBytes / numPostings);
+
+  bool same = true;
+  same &= benchCodec(CODEC_VBYTE, &lists, passes, numPostings);
+  same &= benchCodec(CODEC_SIMPLE8B, &lists, passes, numPostings);
+  same &= benchCodec(CODEC_PFOR, &lists, passes, numPostings);
+
+  free(lists.values);
+  free(lists.starts);
+  return same ? 0 : 2;
+}
+
+/**************** now ****************/
+/* seconds on a monotonic clock */
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**************** readLists ****************/
+/* read every line of a text index into lists, docIDs in order;
+ * return the size of the file */
+static size_t readLists(const char* indexFilename, lists_t* lists) {
+  FILE* fp = fopen(indexFilename, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "can't open %s\n", indexFilename);
+    exit(1);
+  }
+  reader_t* reader = reader_new(fp);
+  size_t fileBytes = 0;
+  posting_t* postings = NULL;
+  int maxPostings = 0;
+  char* line;
+  size_t len;
+  while ((line = reader_nextLine(reader, &len)) != NULL) {
+    fileBytes += len + 1;
+    char* token = strtok(line, " ");   // the word
+    int n = 0;
+    char* docID;
+    char* count;
+    while (token != NULL && (docID = strtok(NULL, " ")) != NULL
+           && (count = strtok(NULL, " ")) != NULL) {
+      if (n == maxPostings) {
+        maxPostings = (maxPostings == 0) ? 256 : maxPostings * 2;
+        postings = mem_assert(realloc(postings, maxPostings * sizeof(posting_t)),
+                              "couldn't allocate memory");
+      }
+      postings[n].docID = atoi(docID);
+      postings[n].count = atoi(count);
+      n++;
+    }
+    if (n > 0) {
+      qsort(postings, n, sizeof(posting_t), comparePostings);
+      addList(lists, postings, n, false);
+      addList(lists, postings, n, true);
+    }
+  }
+  free(postings);
+  reader_delete(reader);
+  fclose(fp);
+  return fileBytes;
+}
+
+/**************** addList ****************/
+/* append the docID gaps, or the counts, of n postings as a list */
+static void addList(lists_t* lists, posting_t* postings, const int n, const bool counts) {
+  if (lists->numLists + 1 >= lists->maxLists) {
+    lists->maxLists = (lists->maxLists == 0) ? 1024 : lists->maxLists * 2;
+    lists->starts = mem_assert(realloc(lists->starts, (lists->maxLists + 1) * sizeof(size_t)),
+                               "couldn't allocate memory");
+  }
+  while (lists->numValues + n > lists->maxValues) {
+    lists->maxValues = (lists->maxValues == 0) ? 65536 : lists->maxValues * 2;
+    lists->values = mem_assert(realloc(lists->values, lists->maxValues * sizeof(uint32_t)),
+                               "couldn't allocate memory");
+  }
+  lists->starts[lists->numLists] = lists->numValues;
+  for (int i = 0; i < n; i++) {
+    lists->values[lists->numValues++] = counts ? (uint32_t)postings[i].count
+      : (uint32_t)(postings[i].docID - ((i == 0) ? 0 : postings[i - 1].docID));
+  }
+  lists->numLists++;
+  lists->starts[lists->numLists] = lists->numValues;
+  if (n > lists->longest) {
+    lists->longest = n;
+  }
+}
+
+/**************** comparePostings ****************/
+/* qsort comparator, orders postings by docID */
+static int comparePostings(const void* a, const void* b) {
+  int x = ((const posting_t*)a)->docID;
+  int y = ((const posting_t*)b)->docID;
+  return (x > y) - (x < y);
+}
+
+/**************** benchCodec ****************/
+/* encode every list with codec, then decode them all passes times;
+ * print one row of results, and return false if a list came back
+ * different */
+static bool benchCodec(const codec_t codec, lists_t* lists, const int passes,
+                       const size_t numPostings) {
+  unsigned char* bytes = mem_assert(malloc(codec_maxBytes(codec, lists->numValues)
+                                           + lists->numLists * 8),
+                                    "couldn't allocate memory");
+  size_t* offsets = mem_assert(malloc((lists->numLists + 1) * sizeof(size_t)),
+                               "couldn't allocate memory");
+  uint32_t* decoded = mem_assert(malloc((lists->longest + 1) * sizeof(uint32_t)),
+                                 "couldn't allocate memory");
+
+  //encode each list on its own, as an index file stores them
+  double start = now();
+  offsets[0] = 0;
+  for (int i = 0; i < lists->numLists; i++) {
+    offsets[i + 1] = offsets[i]
+      + codec_encode(codec, lists->values + lists->starts[i],
+                     lists->starts[i + 1] - lists->starts[i], bytes + offsets[i]);
+  }
+  double encodeTime = now() - start;
+
+  bool same = true;
+  uint32_t sum = 0;
+  start = now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < lists->numLists; i++) {
+      int n = lists->starts[i + 1] - lists->starts[i];
+      if (!codec_decode(codec, bytes + offsets[i], offsets[i + 1] - offsets[i], decoded, n)) {
+        same = false;
+      }
+      sum += decoded[n - 1];    // keep the decoding from being optimized away
+      if (pass == 0 && memcmp(decoded, lists->values + lists->starts[i],
+                              n * sizeof(uint32_t)) != 0) {
+        same = false;
+      }
+    }
+  }
+  double decodeTime = now() - start;
+
+  printf("%-9s %6.2f bytes/posting, encode %7.1f ms, decode %7.1f M postings/s "
+         "(%d passes)%s\n",
+         codec_name(codec), (double)offsets[lists->numLists] / numPostings,
+         encodeTime * 1000, numPostings * passes / decodeTime / 1e6, passes,
+         same ? "" : "  MISMATCH");
+  free(bytes);
+  free(offsets);
+  free(decoded);
+  return same && sum != 1;   // sum is used, whatever its value
+}
@@ -0,0 +1,369 @@
+/*
+ * dict.c - CS50 'dict' module
+ *
+ * see dict.h for more information.
+ *
+ * Each block starts with its first word, NUL-terminated. Every other
+ * word is one byte, the length of the prefix it shares with the word
+ * before (at most 255, a shorter prefix is just as good), then the rest
+ * of the word, NUL-terminated. The block offsets are not saved; loading
+ * rebuilds them in one pass over the bytes, checking them as it goes.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "reader.h"
+#include "dict.h"
+
+/**************** local constants ****************/
+static const int BLOCK_SIZE = 16;       // words per block
+static const size_t MAX_PREFIX = 255;   // longest prefix one byte holds
+
+/**************** local types ****************/
+typedef struct dict {
+  char* bytes;              // the front-coded blocks
+  size_t numBytes;
+  size_t* blocks;           // offset of each block in bytes
+  int numBlocks;
+  int numWords;
+  char* word;               // room for the longest word, to decode into
+} dict_t;
+
+/**************** local functions ****************/
+static dict_t* newDict(char* bytes, const size_t numBytes, const int numWords);
+static size_t decode(dict_t* dict, size_t pos, const bool first);
+static int lowerBound(dict_t* dict, const char* word);
+static int comparePrefix(const char* word, const char* prefix);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** dict_new ****************/
+/* see dict.h for more information */
+dict_t* dict_new(const char** words, const int numWords) {
+  if (words == NULL && numWords > 0) {
+    return NULL;
+  }
+
+  //size the blocks, checking the order on the way
+  size_t numBytes = 0;
+  for (int i = 0; i < numWords; i++) {
+    if (i > 0 && strcmp(words[i - 1], words[i]) >= 0) {
+      return NULL;
+    }
+    size_t len = strlen(words[i]);
+    if (i % BLOCK_SIZE == 0) {
+      numBytes += len + 1;
+    } else {
+      size_t prefix = 0;
+      while (prefix < MAX_PREFIX && words[i - 1][prefix] == words[i][prefix]) {
+        prefix++;
+      }
+      numBytes += 1 + len - prefix + 1;
+    }
+  }
+
+  char* bytes = malloc(numBytes + 1);
+  if (bytes == NULL) {
+    return NULL;
+  }
+  char* p = bytes;
+  for (int i = 0; i < numWords; i++) {
+    size_t prefix = 0;
+    if (i % BLOCK_SIZE != 0) {
+      while (prefix < MAX_PREFIX && words[i - 1][prefix] == words[i][prefix]) {
+        prefix++;
+      }
+      *p++ = (char)prefix;
+    }
+    size_t len = strlen(words[i] + prefix) + 1;
+    memcpy(p, words[i] + prefix, len);
+    p += len;
+  }
+  return newDict(bytes, numBytes, numWords);
+}
+
+/**************** dict_find ****************/
+/* see dict.h for more information */
+int dict_find(dict_t* dict, const char* word) {
+  if (dict == NULL || word == NULL || dict->numBlocks == 0) {
+    return -1;
+  }
+
+  //the last block whose first word is <= word
+  int lo = 0;
+  int hi = dict->numBlocks - 1;
+  while (lo < hi) {
+    int mid = lo + (hi - lo + 1) / 2;
+    if (strcmp(dict->bytes + dict->blocks[mid], word) <= 0) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  //scan it; words only grow, so stop at the first one past word
+  size_t pos = dict->blocks[lo];
+  for (int i = 0; i < BLOCK_SIZE && lo * BLOCK_SIZE + i < dict->numWords; i++) {
+    pos = decode(dict, pos, i == 0);
+    int cmp = strcmp(dict->word, word);
+    if (cmp == 0) {
+      return lo * BLOCK_SIZE + i;
+    } else if (cmp > 0) {
+      break;
+    }
+  }
+  return -1;
+}
+
+/**************** dict_prefix ****************/
+/* see dict.h for more information */
+int dict_prefix(dict_t* dict, const char* prefix, int* first) {
+  if (dict == NULL || prefix == NULL || first == NULL) {
+    return 0;
+  }
+  //the words with prefix run from the first word >= prefix to the
+  //first word past them, which sorts after prefix and doesn't start with it
+  *first = lowerBound(dict, prefix);
+  int lo = *first;
+  int hi = dict->numWords;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    size_t pos = dict->blocks[mid / BLOCK_SIZE];
+    for (int i = 0; i <= mid % BLOCK_SIZE; i++) {
+      pos = decode(dict, pos, i == 0);
+    }
+    if (comparePrefix(dict->word, prefix) == 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - *first;
+}
+
+/**************** dict_iterate ****************/
+/* see dict.h for more information */
+void dict_iterate(dict_t* dict, const int first, const int count, void* arg,
+                  void (*itemfunc)(void* arg, const int id, const char* word)) {
+  if (dict == NULL || itemfunc == NULL) {
+    return;
+  }
+  int id = (first < 0) ? 0 : first;
+  int end = (first + count < dict->numWords) ? first + count : dict->numWords;
+  if (id >= end) {
+    return;
+  }
+  //decode up to first from the start of its block, then word by word
+  size_t pos = dict->blocks[id / BLOCK_SIZE];
+  for (int i = id - id % BLOCK_SIZE; i < id; i++) {
+    pos = decode(dict, pos, i % BLOCK_SIZE == 0);
+  }
+  for (; id < end; id++) {
+    pos = decode(dict, pos, id % BLOCK_SIZE == 0);
+    (*itemfunc)(arg, id, dict->word);
+  }
+}
+
+/**************** dict_word ****************/
+/* see dict.h for more information */
+char* dict_word(dict_t* dict, const int id) {
+  if (dict == NULL || id < 0 || id >= dict->numWords) {
+    return NULL;
+  }
+  size_t pos = dict->blocks[id / BLOCK_SIZE];
+  for (int i = 0; i <= id % BLOCK_SIZE; i++) {
+    pos = decode(dict, pos, i == 0);
+  }
+  char* copy = malloc(strlen(dict->word) + 1);
+  if (copy != NULL) {
+    strcpy(copy, dict->word);
+  }
+  return copy;
+}
+
+/**************** dict_size ****************/
+/* see dict.h for more information */
+int dict_size(dict_t* dict) {
+  return (dict == NULL) ? 0 : dict->numWords;
+}
+
+/**************** dict_memory ****************/
+/* see dict.h for more information */
+size_t dict_memory(dict_t* dict) {
+  if (dict == NULL) {
+    return 0;
+  }
+  return sizeof(dict_t) + dict->numBytes + 1 + dict->numBlocks * sizeof(size_t)
+    + strlen(dict->word) + 1;
+}
+
+/**************** dict_save ****************/
+/* see dict.h for more information */
+bool dict_save(dict_t* dict, const char* filename) {
+  if (dict == NULL || filename == NULL) {
+    return false;
+  }
+  FILE* fp = fopen(filename, "w");
+  if (fp == NULL) {
+    return false;
+  }
+  fprintf(fp, "dict %d %lu\n", dict->numWords, (unsigned long)dict->numBytes);
+  bool ok = (fwrite(dict->bytes, 1, dict->numBytes, fp) == dict->numBytes);
+  return (fclose(fp) == 0) && ok;
+}
+
+/**************** dict_load ****************/
+/* see dict.h for more information */
+dict_t* dict_load(const char* filename) {
+  FILE* fp = (filename == NULL) ? NULL : fopen(filename, "r");
+  if (fp == NULL) {
+    return NULL;
+  }
+  size_t len = 0;
+  char* text = reader_readFile(fp, &len);
+  fclose(fp);
+  if (text == NULL) {
+    return NULL;
+  }
+
+  //header line, then exactly numBytes of blocks
+  int numWords = 0;
+  unsigned long numBytes = 0;
+  int header = 0;
+  if (sscanf(text, "dict %d %lu%n", &numWords, &numBytes, &header) != 2
+      || text[header] != '\n' || numWords < 0 || len - header - 1 != numBytes) {
+    free(text);
+    return NULL;
+  }
+  memmove(text, text + header + 1, numBytes);
+  return newDict(text, numBytes, numWords);
+}
+
+/**************** dict_delete ****************/
+/* see dict.h for more information */
+void dict_delete(dict_t* dict) {
+  if (dict != NULL) {
+    free(dict->bytes);
+    free(dict->blocks);
+    free(dict->word);
+    mem_free(dict);
+  }
+}
+
+/**************** newDict ****************/
+/* make a dict of numWords front-coded words in bytes, which it takes
+ * over (bytes has room for one more byte, a NUL past the end): find
+ * the blocks and the longest word, checking that every word ends
+ * within bytes and shares no more than the word before it has;
+ * returns NULL, freeing bytes, if not or if out of memory
+ * not visible to outsiders, not in dict.h
+ */
+static dict_t* newDict(char* bytes, const size_t numBytes, const int numWords) {
+  bytes[numBytes] = '\0';
+  dict_t* dict = mem_malloc(sizeof(dict_t));
+  if (dict == NULL) {
+    free(bytes);
+    return NULL;
+  }
+  dict->bytes = bytes;
+  dict->numBytes = numBytes;
+  dict->numWords = numWords;
+  dict->numBlocks = (numWords + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  dict->blocks = malloc((dict->numBlocks + 1) * sizeof(size_t));
+  dict->word = NULL;
+  if (dict->blocks == NULL) {
+    dict_delete(dict);
+    return NULL;
+  }
+
+  size_t pos = 0;
+  size_t maxLen = 0;
+  size_t prevLen = 0;
+  int i;
+  for (i = 0; i < numWords; i++) {
+    bool first = (i % BLOCK_SIZE == 0);
+    if (first) {
+      dict->blocks[i / BLOCK_SIZE] = pos;
+    } else if (pos >= numBytes || (unsigned char)bytes[pos] > prevLen) {
+      break;
+    }
+    size_t prefix = first ? 0 : (unsigned char)bytes[pos++];
+    size_t suffix = strlen(bytes + pos);
+    if (pos + suffix >= numBytes) {
+      break;   //ends at our NUL past the end, not its own
+    }
+    pos += suffix + 1;
+    prevLen = prefix + suffix;
+    if (prevLen > maxLen) {
+      maxLen = prevLen;
+    }
+  }
+  if (i < numWords || pos != numBytes || (dict->word = calloc(maxLen + 1, 1)) == NULL) {
+    //malformed, or out of memory
+    dict_delete(dict);
+    return NULL;
+  }
+  return dict;
+}
+
+/**************** decode ****************/
+/* decode the word at pos into dict->word, which holds the word before
+ * it unless first; return the position of the next word
+ * not visible to outsiders, not in dict.h
+ */
+static size_t decode(dict_t* dict, size_t pos, const bool first) {
+  size_t prefix = first ? 0 : (unsigned char)dict->bytes[pos++];
+  size_t len = strlen(dict->bytes + pos) + 1;
+  memcpy(dict->word + prefix, dict->bytes + pos, len);
+  return pos + len;
+}
+
+/**************** lowerBound ****************/
+/* return the term ID of the first word >= word in strcmp order,
+ * numWords if there is none
+ * not visible to outsiders, not in dict.h
+ */
+static int lowerBound(dict_t* dict, const char* word) {
+  if (dict->numBlocks == 0) {
+    return 0;
+  }
+  //the first block whose first word is > word; the answer is in the one before
+  int lo = 0;
+  int hi = dict->numBlocks;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (strcmp(dict->bytes + dict->blocks[mid], word) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == 0) {
+    return 0;
+  }
+  int block = lo - 1;
+  size_t pos = dict->blocks[block];
+  int i;
+  for (i = 0; i < BLOCK_SIZE && block * BLOCK_SIZE + i < dict->numWords; i++) {
+    pos = decode(dict, pos, i == 0);
+    if (strcmp(dict->word, word) >= 0) {
+      break;
+    }
+  }
+  return block * BLOCK_SIZE + i;
+}
+
+/**************** comparePrefix ****************/
+/* compare word with prefix as strcmp would compare word cut to the
+ * length of prefix: 0 if word starts with prefix
+ * not visible to outsiders, not in dict.h
+ */
+static int comparePrefix(const char* word, const char* prefix) {
+  return strncmp(word, prefix, strlen(prefix));
+}
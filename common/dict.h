@@ -0,0 +1,116 @@
+/*
+ * dict.h - header file for CS50 'dict' module
+ *
+ * a dict is a read-only term dictionary: a sorted list of distinct
+ * words, each known by its rank in strcmp order, its term ID (0 for the
+ * first word). The words are front-coded in blocks of 16: the first
+ * word of a block is stored whole, each other word as the length of the
+ * prefix it shares with the word before it plus the rest of the word.
+ * Only the offset of each block is kept besides, so a sorted vocabulary
+ * takes a fraction of the memory of one string and pointer per word.
+ * A word is found by binary search over the first words of the blocks,
+ * then a scan of one block.
+ *
+ * Words sharing a prefix are neighbours in the dict, so they are found
+ * as one range of term IDs, and read in order by decoding only the
+ * blocks that range covers.
+ *
+ * A dict is saved as a text header line, "dict numWords numBytes",
+ * followed by the front-coded blocks as they are in memory.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef DICT_H
+#define DICT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct dict dict_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** dict_new ****************/
+/* Create a dict of the given words.
+ *
+ * Caller provides:
+ *   words - array of numWords distinct strings, in strcmp order
+ *     (an empty array is fine)
+ * We return:
+ *   pointer to a new dict, where words[i] has term ID i;
+ *   NULL if the words are out of order or repeated, or error.
+ * We guarantee:
+ *   the words are copied; the caller's strings are not kept.
+ * Caller is responsible for:
+ *   later calling dict_delete.
+ */
+dict_t* dict_new(const char** words, const int numWords);
+
+/**************** dict_find ****************/
+/* Return the term ID of word, or -1 if it isn't in the dict
+ * (or dict or word is NULL). */
+int dict_find(dict_t* dict, const char* word);
+
+/**************** dict_prefix ****************/
+/* Find the words that start with prefix.
+ *
+ * Caller provides:
+ *   valid dict and prefix pointers, where to put the first term ID.
+ * We return:
+ *   the number of words that start with prefix (0 if none, or dict or
+ *   prefix is NULL); they have the term IDs *first to *first + n - 1.
+ *   The empty prefix gives every word.
+ */
+int dict_prefix(dict_t* dict, const char* prefix, int* first);
+
+/**************** dict_iterate ****************/
+/* Call itemfunc(arg, id, word) for the count words with term IDs first,
+ * first + 1, ..., in that order; IDs outside the dict are skipped. We do
+ * nothing if dict or itemfunc is NULL. The word passed is only good
+ * until itemfunc returns.
+ */
+void dict_iterate(dict_t* dict, const int first, const int count, void* arg,
+                  void (*itemfunc)(void* arg, const int id, const char* word));
+
+/**************** dict_word ****************/
+/* Return a copy of the word with term ID id, in malloc'd memory, or
+ * NULL if there is no such ID or error.
+ * Caller is responsible for freeing the copy. */
+char* dict_word(dict_t* dict, const int id);
+
+/**************** dict_size ****************/
+/* Return the number of words in the dict, 0 if dict is NULL. */
+int dict_size(dict_t* dict);
+
+/**************** dict_memory ****************/
+/* Return the number of bytes allocated for the dict, 0 if NULL. */
+size_t dict_memory(dict_t* dict);
+
+/**************** dict_save ****************/
+/* Save the dict to a file.
+ *
+ * Caller provides:
+ *   valid dict pointer, filename - the file to (over)write.
+ * We return:
+ *   true on success, false if the file can't be written.
+ */
+bool dict_save(dict_t* dict, const char* filename);
+
+/**************** dict_load ****************/
+/* Load a dict saved by dict_save.
+ *
+ * We return:
+ *   pointer to a new dict, or NULL if the file can't be read or
+ *   isn't a dict.
+ * Caller is responsible for:
+ *   later calling dict_delete.
+ */
+dict_t* dict_load(const char* filename);
+
+/**************** dict_delete ****************/
+/* Delete the dict; we ignore NULL dict. */
+void dict_delete(dict_t* dict);
+
+#endif // DICT_H
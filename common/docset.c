@@ -0,0 +1,674 @@
+/*
+ * docset.c - CS50 'docset' module
+ *
+ * see docset.h for more information.
+ *
+ * Containers are kept in an array sorted by key. A container is an
+ * array of low bits while it has at most ARRAY_MAX of them and a bitmap
+ * once it has more, and changes form when its size crosses the line,
+ * so the same set always has the same containers. The bitmap loops
+ * count bits with popcount, which compiles to a single instruction
+ * where the CPU has one.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mem.h"
+#include "docset.h"
+
+/**************** local constants ****************/
+static const int ARRAY_MAX = 4096;      // largest array container
+#define BITMAP_WORDS 1024               // 65536 bits
+
+/**************** local types ****************/
+typedef struct container {
+  uint16_t key;             // high 16 bits of its integers
+  int size;                 // number of integers
+  uint16_t* array;          // sorted low bits, while size <= ARRAY_MAX
+  int capacity;             // size of array
+  uint64_t* bits;           // BITMAP_WORDS words, once size > ARRAY_MAX
+} container_t;
+
+typedef struct docset {
+  container_t* containers;  // in increasing order of key
+  int count;
+  int capacity;             // size of containers
+} docset_t;
+
+/**************** local functions ****************/
+static int findContainer(const docset_t* docset, const uint16_t key);
+static container_t* getContainer(docset_t* docset, const uint16_t key);
+static bool containerAdd(container_t* c, const uint16_t low);
+static int containerIndex(const container_t* c, const uint16_t low);
+static bool containerContains(const container_t* c, const uint16_t low);
+static int gallop(const uint16_t* array, int lo, const int n, const uint16_t target);
+static bool containerAnd(const container_t* a, const container_t* b, container_t* out);
+static bool containerOr(container_t* c, const container_t* other);
+static bool toBitmap(container_t* c);
+static bool toArray(container_t* c);
+static void freeContainer(container_t* c);
+static int popcount(const uint64_t word);
+static int ctz(const uint64_t word);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** docset_new ****************/
+/* see docset.h for more information */
+docset_t* docset_new(void) {
+  docset_t* docset = mem_malloc(sizeof(docset_t));
+  if (docset == NULL) {
+    return NULL;
+  }
+  docset->containers = NULL;
+  docset->count = 0;
+  docset->capacity = 0;
+  return docset;
+}
+
+/**************** docset_add ****************/
+/* see docset.h for more information */
+bool docset_add(docset_t* docset, const int n) {
+  if (docset == NULL || n < 0) {
+    return false;
+  }
+  container_t* c = getContainer(docset, (uint16_t)(n >> 16));
+  return c != NULL && containerAdd(c, (uint16_t)(n & 0xffff));
+}
+
+/**************** docset_contains ****************/
+/* see docset.h for more information */
+bool docset_contains(const docset_t* docset, const int n) {
+  if (docset == NULL || n < 0) {
+    return false;
+  }
+  //no need to count the integers before n, as docset_index does
+  int i = findContainer(docset, (uint16_t)(n >> 16));
+  return i >= 0 && containerContains(&docset->containers[i], (uint16_t)(n & 0xffff));
+}
+
+/**************** docset_index ****************/
+/* see docset.h for more information */
+int docset_index(const docset_t* docset, const int n) {
+  if (docset == NULL || n < 0) {
+    return -1;
+  }
+  int i = findContainer(docset, (uint16_t)(n >> 16));
+  if (i < 0) {
+    return -1;
+  }
+  int index = containerIndex(&docset->containers[i], (uint16_t)(n & 0xffff));
+  if (index < 0) {
+    return -1;
+  }
+  //add the integers of the containers before
+  for (int j = 0; j < i; j++) {
+    index += docset->containers[j].size;
+  }
+  return index;
+}
+
+/**************** docset_indexes ****************/
+/* see docset.h for more information */
+void docset_indexes(const docset_t* docset, const int* ns, const int count, int* indexes) {
+  if (ns == NULL || indexes == NULL) {
+    return;
+  }
+  //walk the containers along with ns: c is the container of the last
+  //integer looked up, base the integers before it, and j how far into
+  //it we are, a place in its array, or a word of its bitmap, with rank
+  //the integers in the words before
+  int c = 0;
+  int base = 0;
+  int j = 0;
+  int rank = 0;
+  for (int i = 0; i < count; i++) {
+    indexes[i] = -1;
+    if (docset == NULL || ns[i] < 0) {
+      continue;
+    }
+    uint16_t key = (uint16_t)(ns[i] >> 16);
+    uint16_t low = (uint16_t)(ns[i] & 0xffff);
+    while (c < docset->count && docset->containers[c].key < key) {
+      base += docset->containers[c].size;
+      c++;
+      j = 0;
+      rank = 0;
+    }
+    if (c == docset->count || docset->containers[c].key != key) {
+      continue;
+    }
+    const container_t* container = &docset->containers[c];
+    if (container->bits != NULL) {
+      while (j < low / 64) {
+        rank += popcount(container->bits[j++]);
+      }
+      uint64_t word = container->bits[j];
+      uint64_t bit = (uint64_t)1 << (low % 64);
+      if ((word & bit) != 0) {
+        indexes[i] = base + rank + popcount(word & (bit - 1));
+      }
+    } else {
+      j = gallop(container->array, j, container->size, low);
+      if (j < container->size && container->array[j] == low) {
+        indexes[i] = base + j;
+      }
+    }
+  }
+}
+
+/**************** docset_size ****************/
+/* see docset.h for more information */
+int docset_size(const docset_t* docset) {
+  int size = 0;
+  for (int i = 0; docset != NULL && i < docset->count; i++) {
+    size += docset->containers[i].size;
+  }
+  return size;
+}
+
+/**************** docset_copy ****************/
+/* see docset.h for more information */
+docset_t* docset_copy(const docset_t* docset) {
+  if (docset == NULL) {
+    return NULL;
+  }
+  docset_t* copy = docset_new();
+  if (copy == NULL) {
+    return NULL;
+  }
+  if (!docset_or(copy, docset)) {
+    docset_delete(copy);
+    return NULL;
+  }
+  return copy;
+}
+
+/**************** docset_and ****************/
+/* see docset.h for more information */
+bool docset_and(docset_t* docset, const docset_t* other) {
+  if (docset == NULL || other == NULL) {
+    return false;
+  }
+  //the result has at most as many containers as the smaller set;
+  //build it aside, so docset is unchanged if we run out of memory
+  int max = (docset->count < other->count) ? docset->count : other->count;
+  container_t* result = malloc((max + 1) * sizeof(container_t));
+  if (result == NULL) {
+    return false;
+  }
+  int count = 0;
+  int i = 0, j = 0;
+  while (i < docset->count && j < other->count) {
+    const container_t* a = &docset->containers[i];
+    const container_t* b = &other->containers[j];
+    if (a->key < b->key) {
+      i++;
+    } else if (a->key > b->key) {
+      j++;
+    } else {
+      if (!containerAnd(a, b, &result[count])) {
+        for (int k = 0; k < count; k++) {
+          freeContainer(&result[k]);
+        }
+        free(result);
+        return false;
+      }
+      //an empty intersection leaves no container
+      if (result[count].size > 0) {
+        count++;
+      } else {
+        freeContainer(&result[count]);
+      }
+      i++;
+      j++;
+    }
+  }
+  for (int k = 0; k < docset->count; k++) {
+    freeContainer(&docset->containers[k]);
+  }
+  free(docset->containers);
+  docset->containers = result;
+  docset->count = count;
+  docset->capacity = max + 1;
+  return true;
+}
+
+/**************** docset_or ****************/
+/* see docset.h for more information */
+bool docset_or(docset_t* docset, const docset_t* other) {
+  if (docset == NULL || other == NULL) {
+    return false;
+  }
+  for (int j = 0; j < other->count; j++) {
+    container_t* c = getContainer(docset, other->containers[j].key);
+    if (c == NULL || !containerOr(c, &other->containers[j])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**************** docset_iterate ****************/
+/* see docset.h for more information */
+void docset_iterate(const docset_t* docset, void* arg,
+                    void (*itemfunc)(void* arg, const int n)) {
+  if (docset == NULL || itemfunc == NULL) {
+    return;
+  }
+  for (int i = 0; i < docset->count; i++) {
+    const container_t* c = &docset->containers[i];
+    int high = (int)c->key << 16;
+    if (c->bits == NULL) {
+      for (int j = 0; j < c->size; j++) {
+        (*itemfunc)(arg, high | c->array[j]);
+      }
+    } else {
+      //visit the set bits of each word, lowest first
+      for (int w = 0; w < BITMAP_WORDS; w++) {
+        for (uint64_t word = c->bits[w]; word != 0; word &= word - 1) {
+          (*itemfunc)(arg, high | (w * 64 + ctz(word)));
+        }
+      }
+    }
+  }
+}
+
+/**************** docset_memory ****************/
+/* see docset.h for more information */
+size_t docset_memory(const docset_t* docset) {
+  if (docset == NULL) {
+    return 0;
+  }
+  size_t bytes = sizeof(docset_t) + docset->capacity * sizeof(container_t);
+  for (int i = 0; i < docset->count; i++) {
+    const container_t* c = &docset->containers[i];
+    bytes += (c->bits != NULL) ? BITMAP_WORDS * sizeof(uint64_t)
+                               : c->capacity * sizeof(uint16_t);
+  }
+  return bytes;
+}
+
+/**************** docset_delete ****************/
+/* see docset.h for more information */
+void docset_delete(docset_t* docset) {
+  if (docset != NULL) {
+    for (int i = 0; i < docset->count; i++) {
+      freeContainer(&docset->containers[i]);
+    }
+    free(docset->containers);
+    mem_free(docset);
+  }
+}
+
+/**************** findContainer ****************/
+/* return the position of the container with key, or if there is none,
+ * -1 less the position it would go at
+ * not visible to outsiders, not in docset.h
+ */
+static int findContainer(const docset_t* docset, const uint16_t key) {
+  int lo = 0, hi = docset->count;
+  //integers usually come in increasing order: try the last one first
+  if (hi > 0 && docset->containers[hi - 1].key < key) {
+    return -hi - 1;
+  }
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (docset->containers[mid].key < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < docset->count && docset->containers[lo].key == key) ? lo : -lo - 1;
+}
+
+/**************** getContainer ****************/
+/* return the container with key, adding an empty one if there is none;
+ * NULL if out of memory
+ * not visible to outsiders, not in docset.h
+ */
+static container_t* getContainer(docset_t* docset, const uint16_t key) {
+  int i = findContainer(docset, key);
+  if (i >= 0) {
+    return &docset->containers[i];
+  }
+  i = -i - 1;
+  if (docset->count == docset->capacity) {
+    int capacity = (docset->capacity == 0) ? 4 : docset->capacity * 2;
+    container_t* containers = realloc(docset->containers, capacity * sizeof(container_t));
+    if (containers == NULL) {
+      return NULL;
+    }
+    docset->containers = containers;
+    docset->capacity = capacity;
+  }
+  memmove(&docset->containers[i + 1], &docset->containers[i],
+          (docset->count - i) * sizeof(container_t));
+  docset->count++;
+  container_t* c = &docset->containers[i];
+  c->key = key;
+  c->size = 0;
+  c->array = NULL;
+  c->capacity = 0;
+  c->bits = NULL;
+  return c;
+}
+
+/**************** containerAdd ****************/
+/* add low to a container; false if out of memory
+ * not visible to outsiders, not in docset.h
+ */
+static bool containerAdd(container_t* c, const uint16_t low) {
+  if (c->bits != NULL) {
+    uint64_t bit = (uint64_t)1 << (low % 64);
+    if ((c->bits[low / 64] & bit) == 0) {
+      c->bits[low / 64] |= bit;
+      c->size++;
+    }
+    return true;
+  }
+  //find where low goes, at the end if it is the largest yet
+  int lo = c->size, hi = c->size;
+  if (c->size > 0 && c->array[c->size - 1] >= low) {
+    lo = 0;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (c->array[mid] < low) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    if (c->array[lo] == low) {
+      return true;
+    }
+  }
+  if (c->size == ARRAY_MAX) {
+    return toBitmap(c) && containerAdd(c, low);
+  }
+  if (c->size == c->capacity) {
+    int capacity = (c->capacity == 0) ? 4 : c->capacity * 2;
+    capacity = (capacity > ARRAY_MAX) ? ARRAY_MAX : capacity;
+    uint16_t* array = realloc(c->array, capacity * sizeof(uint16_t));
+    if (array == NULL) {
+      return false;
+    }
+    c->array = array;
+    c->capacity = capacity;
+  }
+  memmove(&c->array[lo + 1], &c->array[lo], (c->size - lo) * sizeof(uint16_t));
+  c->array[lo] = low;
+  c->size++;
+  return true;
+}
+
+/**************** containerIndex ****************/
+/* return the position of low among a container's integers, -1 if absent
+ * not visible to outsiders, not in docset.h
+ */
+static int containerIndex(const container_t* c, const uint16_t low) {
+  if (c->bits != NULL) {
+    uint64_t word = c->bits[low / 64];
+    uint64_t bit = (uint64_t)1 << (low % 64);
+    if ((word & bit) == 0) {
+      return -1;
+    }
+    int index = popcount(word & (bit - 1));
+    for (int w = 0; w < low / 64; w++) {
+      index += popcount(c->bits[w]);
+    }
+    return index;
+  }
+  int lo = 0, hi = c->size;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (c->array[mid] < low) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo < c->size && c->array[lo] == low) ? lo : -1;
+}
+
+/**************** gallop ****************/
+/* the first place from lo where array[0..n) has target or more, found
+ * by doubling steps then binary search, so skipping far costs little
+ * not visible to outsiders, not in docset.h
+ */
+static int gallop(const uint16_t* array, int lo, const int n, const uint16_t target) {
+  int hi = lo;
+  int step = 1;
+  while (hi < n && array[hi] < target) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  if (hi > n) {
+    hi = n;
+  }
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (array[mid] < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**************** containerContains ****************/
+/* true if low is among a container's integers: one bit, or a binary
+ * search, without the popcounts of containerIndex
+ * not visible to outsiders, not in docset.h
+ */
+static bool containerContains(const container_t* c, const uint16_t low) {
+  if (c->bits != NULL) {
+    return (c->bits[low / 64] >> (low % 64)) & 1;
+  }
+  int lo = 0, hi = c->size;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (c->array[mid] < low) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < c->size && c->array[lo] == low;
+}
+
+/**************** containerAnd ****************/
+/* fill out with the intersection of two containers with the same key;
+ * false if out of memory
+ * not visible to outsiders, not in docset.h
+ */
+static bool containerAnd(const container_t* a, const container_t* b, container_t* out) {
+  out->key = a->key;
+  out->size = 0;
+  out->array = NULL;
+  out->capacity = 0;
+  out->bits = NULL;
+
+  if (a->bits != NULL && b->bits != NULL) {
+    //two bitmaps: a word at a time
+    out->bits = malloc(BITMAP_WORDS * sizeof(uint64_t));
+    if (out->bits == NULL) {
+      return false;
+    }
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+      out->bits[w] = a->bits[w] & b->bits[w];
+      out->size += popcount(out->bits[w]);
+    }
+    return out->size > ARRAY_MAX || toArray(out);
+  }
+
+  //otherwise at least one array, which bounds the result
+  if (a->bits != NULL) {
+    const container_t* swap = a;
+    a = b;
+    b = swap;
+  }
+  if (a->size == 0) {
+    return true;
+  }
+  out->array = malloc(a->size * sizeof(uint16_t));
+  if (out->array == NULL) {
+    return false;
+  }
+  out->capacity = a->size;
+  if (b->bits != NULL) {
+    //keep the array's integers that have a bit
+    for (int i = 0; i < a->size; i++) {
+      uint16_t low = a->array[i];
+      if (b->bits[low / 64] & ((uint64_t)1 << (low % 64))) {
+        out->array[out->size++] = low;
+      }
+    }
+  } else {
+    //two sorted arrays: merge
+    int i = 0, j = 0;
+    while (i < a->size && j < b->size) {
+      if (a->array[i] < b->array[j]) {
+        i++;
+      } else if (a->array[i] > b->array[j]) {
+        j++;
+      } else {
+        out->array[out->size++] = a->array[i];
+        i++;
+        j++;
+      }
+    }
+  }
+  return true;
+}
+
+/**************** containerOr ****************/
+/* add the integers of other, with the same key, to a container;
+ * false if out of memory
+ * not visible to outsiders, not in docset.h
+ */
+static bool containerOr(container_t* c, const container_t* other) {
+  if (c->bits == NULL && c->size + other->size > ARRAY_MAX) {
+    //the union may not fit an array; toArray below undoes this if it does
+    if (!toBitmap(c)) {
+      return false;
+    }
+  }
+  if (c->bits != NULL) {
+    if (other->bits != NULL) {
+      //two bitmaps: a word at a time
+      c->size = 0;
+      for (int w = 0; w < BITMAP_WORDS; w++) {
+        c->bits[w] |= other->bits[w];
+        c->size += popcount(c->bits[w]);
+      }
+    } else {
+      for (int i = 0; i < other->size; i++) {
+        containerAdd(c, other->array[i]);
+      }
+    }
+    return c->size > ARRAY_MAX || toArray(c);
+  }
+
+  //two arrays whose union fits an array: merge from the back, in place
+  int size = c->size + other->size;
+  if (size > c->capacity) {
+    uint16_t* array = realloc(c->array, size * sizeof(uint16_t));
+    if (array == NULL) {
+      return false;
+    }
+    c->array = array;
+    c->capacity = size;
+  }
+  int i = c->size - 1, j = other->size - 1, k = size - 1;
+  while (j >= 0) {
+    if (i >= 0 && c->array[i] > other->array[j]) {
+      c->array[k--] = c->array[i--];
+    } else {
+      c->array[k--] = other->array[j--];
+    }
+  }
+  //drop duplicates
+  int n = 0;
+  for (k = 0; k < size; k++) {
+    if (n == 0 || c->array[n - 1] != c->array[k]) {
+      c->array[n++] = c->array[k];
+    }
+  }
+  c->size = n;
+  return true;
+}
+
+/**************** toBitmap ****************/
+/* turn an array container into a bitmap one; false if out of memory
+ * not visible to outsiders, not in docset.h
+ */
+static bool toBitmap(container_t* c) {
+  uint64_t* bits = calloc(BITMAP_WORDS, sizeof(uint64_t));
+  if (bits == NULL) {
+    return false;
+  }
+  for (int i = 0; i < c->size; i++) {
+    bits[c->array[i] / 64] |= (uint64_t)1 << (c->array[i] % 64);
+  }
+  free(c->array);
+  c->array = NULL;
+  c->capacity = 0;
+  c->bits = bits;
+  return true;
+}
+
+/**************** toArray ****************/
+/* turn a bitmap container of at most ARRAY_MAX integers into an array
+ * one; false if out of memory
+ * not visible to outsiders, not in docset.h
+ */
+static bool toArray(container_t* c) {
+  uint16_t* array = malloc((c->size + 1) * sizeof(uint16_t));
+  if (array == NULL) {
+    return false;
+  }
+  int n = 0;
+  for (int w = 0; w < BITMAP_WORDS; w++) {
+    for (uint64_t word = c->bits[w]; word != 0; word &= word - 1) {
+      array[n++] = (uint16_t)(w * 64 + ctz(word));
+    }
+  }
+  free(c->bits);
+  c->bits = NULL;
+  c->array = array;
+  c->capacity = c->size + 1;
+  return true;
+}
+
+/**************** freeContainer ****************/
+/* free what a container holds
+ * not visible to outsiders, not in docset.h
+ */
+static void freeContainer(container_t* c) {
+  free(c->array);
+  free(c->bits);
+}
+
+/**************** popcount ****************/
+/* return the number of set bits in word
+ * not visible to outsiders, not in docset.h
+ */
+static int popcount(const uint64_t word) {
+  return __builtin_popcountll(word);
+}
+
+/**************** ctz ****************/
+/* return the position of the lowest set bit of word, which isn't 0
+ * not visible to outsiders, not in docset.h
+ */
+static int ctz(const uint64_t word) {
+  return __builtin_ctzll(word);
+}
@@ -0,0 +1,115 @@
+/*
+ * docset.h - header file for CS50 'docset' module
+ *
+ * a docset is a compressed set of non-negative integers, such as the
+ * docIDs a common word appears in, kept the way roaring bitmaps are:
+ * integers are grouped by their high 16 bits, and each group (a
+ * container) holds the low 16 bits either as a sorted array, while it
+ * has at most 4096 of them, or as a bitmap of 65536 bits once it has
+ * more. Either way a container takes at most 8 KB, and two bitmap
+ * containers are intersected or united 64 integers at a time.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef DOCSET_H
+#define DOCSET_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct docset docset_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** docset_new ****************/
+/* Create a new (empty) docset.
+ *
+ * We return:
+ *   pointer to a new docset, or NULL if error.
+ * Caller is responsible for:
+ *   later calling docset_delete.
+ */
+docset_t* docset_new(void);
+
+/**************** docset_add ****************/
+/* Add n to the docset.
+ *
+ * We return:
+ *   true on success (also if n was already there), false if docset is
+ *   NULL, n is negative, or out of memory.
+ * Notes:
+ *   adding in increasing order is fastest; any order works.
+ */
+bool docset_add(docset_t* docset, const int n);
+
+/**************** docset_contains ****************/
+/* Return true if n is in the docset, false if not or docset is NULL;
+ * cheaper than docset_index, which counts the integers before n. */
+bool docset_contains(const docset_t* docset, const int n);
+
+/**************** docset_index ****************/
+/* Return the position of n among the docset's integers in increasing
+ * order (0 for the smallest), or -1 if n isn't in the docset; so an
+ * array of values kept beside the docset can be looked up by integer.
+ */
+int docset_index(const docset_t* docset, const int n);
+
+/**************** docset_indexes ****************/
+/* Look up many integers at once, as docset_index does one at a time.
+ *
+ * Caller provides:
+ *   count integers in ns, in increasing order, and room for count
+ *   positions in indexes.
+ * We guarantee:
+ *   indexes[i] is docset_index(docset, ns[i]), -1 for each if docset
+ *   is NULL; ns and the docset are walked side by side, once, so this
+ *   costs about as much as merging two sorted lists, not count searches.
+ */
+void docset_indexes(const docset_t* docset, const int* ns, const int count, int* indexes);
+
+/**************** docset_size ****************/
+/* Return the number of integers in the docset, 0 if docset is NULL. */
+int docset_size(const docset_t* docset);
+
+/**************** docset_copy ****************/
+/* Return a new docset with the integers of docset, or NULL if error;
+ * the caller is responsible for later calling docset_delete. */
+docset_t* docset_copy(const docset_t* docset);
+
+/**************** docset_and ****************/
+/* Intersect docset with other, in place: keep only integers in both.
+ *
+ * We return:
+ *   true on success, false if either is NULL or out of memory
+ *   (docset is then left unchanged).
+ */
+bool docset_and(docset_t* docset, const docset_t* other);
+
+/**************** docset_or ****************/
+/* Unite docset with other, in place: add every integer of other.
+ *
+ * We return:
+ *   true on success, false if either is NULL or out of memory
+ *   (docset then holds some of other's integers).
+ */
+bool docset_or(docset_t* docset, const docset_t* other);
+
+/**************** docset_iterate ****************/
+/* Call itemfunc(arg, n) for each integer n of the docset, in
+ * increasing order; we do nothing if docset or itemfunc is NULL.
+ * The docset must not be changed by itemfunc.
+ */
+void docset_iterate(const docset_t* docset, void* arg,
+                    void (*itemfunc)(void* arg, const int n));
+
+/**************** docset_memory ****************/
+/* Return the bytes the docset holds from malloc, 0 if docset is NULL. */
+size_t docset_memory(const docset_t* docset);
+
+/**************** docset_delete ****************/
+/* Delete the docset; we ignore NULL docset. */
+void docset_delete(docset_t* docset);
+
+#endif // DOCSET_H
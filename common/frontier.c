@@ -0,0 +1,653 @@
+/*
+ * frontier.c - CS50 'frontier' module
+ *
+ * see frontier.h for more information.
+ *
+ * Every policy keeps an array of queues: bfs uses one, host uses one
+ * per host (with a parallel array of host names), and depth uses one
+ * per depth, indexed by depth. Each queue is a ring buffer whose
+ * capacity is a power of 2, so positions wrap with a mask.
+ *
+ * When spilling, a queue is its ring buffer (the oldest pages) followed
+ * by numbered segment files in the spill directory (newer pages, in
+ * order). Each segment holds one "depth url" line per page. Once a
+ * queue has pages on disk, new pages go to disk behind them; when its
+ * ring buffer runs dry, the oldest segment is read back into it and
+ * removed. The newest segment stays open, with the offset of each of
+ * its lines, so its newest page can be evicted by seeking back over
+ * it; a segment emptied this way is removed, and the one before it
+ * reopened.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "file.h"
+#include "webpage.h"
+#include "frontier.h"
+
+/**************** local types ****************/
+typedef struct queue {
+  webpage_t** items;        // ring buffer of pages, NULL until first push
+  size_t head;              // position of the oldest page
+  size_t count;             // number of pages in the queue
+  size_t capacity;          // size of items, 0 or a power of 2
+  long onDisk;              // pages spilled, all newer than those in items
+  long readSeg;             // oldest segment still on disk
+  long writeSeg;            // segment being appended to
+  int writeCount;           // pages in writeSeg so far
+  FILE* writeFp;            // writeSeg, while it is open for appending
+  long* offsets;            // where each page of writeSeg starts in it
+} queue_t;
+
+typedef struct frontier {
+  frontierPolicy_t policy;
+  queue_t* queues;          // see above for what each queue holds
+  char** hosts;             // host policy: host name for each queue
+  int numQueues;            // queues in use
+  int maxQueues;            // queues allocated
+  int next;                 // host: queue to serve next
+                            // depth: shallowest queue that may be non-empty
+  size_t count;             // pages in all queues
+  size_t maxPending;        // bound on count, 0 if none
+  long dropped;             // pages dropped or evicted when full
+  char* spillDir;           // directory for segment files, NULL if none
+  size_t memLimit;          // pages held in memory before spilling
+  size_t memCount;          // pages in memory, in all ring buffers
+  int segPages;             // pages per segment file
+  long spilled;             // pages ever written to disk
+} frontier_t;
+
+/**************** local constants ****************/
+static const int MAX_SEGMENT_PAGES = 4096;
+
+/**************** local functions ****************/
+static bool queuePush(queue_t* queue, webpage_t* page);
+static webpage_t* queuePop(queue_t* queue);
+static webpage_t* queuePopBack(queue_t* queue);
+static bool unspillPage(frontier_t* frontier, const int which);
+static webpage_t* takeFrom(frontier_t* frontier, const int which);
+static bool spillPage(frontier_t* frontier, const int which, webpage_t* page);
+static void loadSegment(frontier_t* frontier, const int which);
+static char* segmentName(frontier_t* frontier, const int which, const long seg);
+static int queueFor(frontier_t* frontier, webpage_t* page);
+static int addQueue(frontier_t* frontier);
+static bool evictDeeper(frontier_t* frontier, const int depth);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** frontier_parsePolicy ****************/
+/* see frontier.h for more information */
+bool frontier_parsePolicy(const char* name, frontierPolicy_t* policy) {
+  if (name == NULL || policy == NULL) {
+    return false;
+  }
+  if (strcmp(name, "bfs") == 0) {
+    *policy = FRONTIER_BFS;
+  } else if (strcmp(name, "host") == 0) {
+    *policy = FRONTIER_HOST;
+  } else if (strcmp(name, "depth") == 0) {
+    *policy = FRONTIER_DEPTH;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**************** frontier_new ****************/
+/* see frontier.h for more information */
+frontier_t* frontier_new(const frontierPolicy_t policy, const size_t maxPending) {
+  frontier_t* frontier = mem_malloc(sizeof(frontier_t));
+  if (frontier == NULL) {
+    return NULL;
+  }
+  frontier->policy = policy;
+  frontier->queues = NULL;
+  frontier->hosts = NULL;
+  frontier->numQueues = 0;
+  frontier->maxQueues = 0;
+  frontier->next = 0;
+  frontier->count = 0;
+  frontier->maxPending = maxPending;
+  frontier->dropped = 0;
+  frontier->spillDir = NULL;
+  frontier->memLimit = 0;
+  frontier->memCount = 0;
+  frontier->segPages = 0;
+  frontier->spilled = 0;
+
+  //bfs has its single queue from the start
+  if (policy == FRONTIER_BFS && addQueue(frontier) < 0) {
+    frontier_delete(frontier);
+    return NULL;
+  }
+  return frontier;
+}
+
+/**************** frontier_setSpill ****************/
+/* see frontier.h for more information */
+bool frontier_setSpill(frontier_t* frontier, const char* spillDir,
+                       const size_t memLimit) {
+  if (frontier == NULL || spillDir == NULL || memLimit == 0
+      || frontier->count != 0 || frontier->spillDir != NULL) {
+    return false;
+  }
+  frontier->spillDir = malloc(strlen(spillDir) + 1);
+  if (frontier->spillDir == NULL) {
+    return false;
+  }
+  strcpy(frontier->spillDir, spillDir);
+  frontier->memLimit = memLimit;
+  //segments no bigger than the memory limit, so reading one back
+  //at most doubles the pages in memory
+  frontier->segPages = (memLimit < (size_t)MAX_SEGMENT_PAGES)
+                       ? (int)memLimit : MAX_SEGMENT_PAGES;
+  return true;
+}
+
+/**************** frontier_insert ****************/
+/* see frontier.h for more information */
+bool frontier_insert(frontier_t* frontier, webpage_t* page) {
+  if (frontier == NULL || page == NULL) {
+    webpage_delete(page);
+    return false;
+  }
+
+  //when full, only a shallower page under the depth policy gets in
+  if (frontier->maxPending > 0 && frontier->count >= frontier->maxPending) {
+    if (frontier->policy != FRONTIER_DEPTH
+        || !evictDeeper(frontier, webpage_getDepth(page))) {
+      webpage_delete(page);
+      frontier->dropped++;
+      return false;
+    }
+  }
+
+  int which = queueFor(frontier, page);
+  if (which < 0) {
+    webpage_delete(page);
+    return false;
+  }
+  //once a queue has pages on disk, newer ones must follow them there
+  queue_t* queue = &frontier->queues[which];
+  if (frontier->spillDir != NULL
+      && (queue->onDisk > 0 || frontier->memCount >= frontier->memLimit)) {
+    if (!spillPage(frontier, which, page)) {
+      frontier->dropped++;
+      return false;
+    }
+  } else {
+    if (!queuePush(queue, page)) {
+      webpage_delete(page);
+      return false;
+    }
+    frontier->memCount++;
+  }
+  frontier->count++;
+  if (frontier->policy == FRONTIER_DEPTH && which < frontier->next) {
+    frontier->next = which;
+  }
+  return true;
+}
+
+/**************** frontier_extract ****************/
+/* see frontier.h for more information */
+webpage_t* frontier_extract(frontier_t* frontier) {
+  if (frontier == NULL || frontier->count == 0) {
+    return NULL;
+  }
+
+  webpage_t* page = NULL;
+  switch (frontier->policy) {
+  case FRONTIER_BFS:
+    page = takeFrom(frontier, 0);
+    break;
+  case FRONTIER_HOST:
+    //first non-empty queue at or after next, wrapping around
+    for (int i = 0; i < frontier->numQueues && page == NULL; i++) {
+      int which = (frontier->next + i) % frontier->numQueues;
+      page = takeFrom(frontier, which);
+      if (page != NULL) {
+        frontier->next = (which + 1) % frontier->numQueues;
+      }
+    }
+    break;
+  case FRONTIER_DEPTH:
+    //shallowest non-empty queue
+    while (frontier->next < frontier->numQueues
+           && (page = takeFrom(frontier, frontier->next)) == NULL) {
+      frontier->next++;
+    }
+    break;
+  }
+
+  if (page != NULL) {
+    frontier->count--;
+  }
+  return page;
+}
+
+/**************** frontier_size ****************/
+/* see frontier.h for more information */
+size_t frontier_size(frontier_t* frontier) {
+  return (frontier == NULL) ? 0 : frontier->count;
+}
+
+/**************** frontier_dropped ****************/
+/* see frontier.h for more information */
+long frontier_dropped(frontier_t* frontier) {
+  return (frontier == NULL) ? 0 : frontier->dropped;
+}
+
+/**************** frontier_spilled ****************/
+/* see frontier.h for more information */
+long frontier_spilled(frontier_t* frontier) {
+  return (frontier == NULL) ? 0 : frontier->spilled;
+}
+
+/**************** frontier_delete ****************/
+/* see frontier.h for more information */
+void frontier_delete(frontier_t* frontier) {
+  if (frontier != NULL) {
+    for (int i = 0; i < frontier->numQueues; i++) {
+      webpage_t* page;
+      while ((page = queuePop(&frontier->queues[i])) != NULL) {
+        webpage_delete(page);
+      }
+      free(frontier->queues[i].items);
+
+      //close and remove any segments still on disk
+      queue_t* queue = &frontier->queues[i];
+      if (queue->writeFp != NULL) {
+        fclose(queue->writeFp);
+      }
+      free(queue->offsets);
+      for (long seg = queue->readSeg; queue->onDisk > 0 && seg <= queue->writeSeg; seg++) {
+        char* name = segmentName(frontier, i, seg);
+        if (name != NULL) {
+          remove(name);
+          free(name);
+        }
+      }
+      if (frontier->hosts != NULL) {
+        free(frontier->hosts[i]);
+      }
+    }
+    free(frontier->queues);
+    free(frontier->hosts);
+    free(frontier->spillDir);
+    mem_free(frontier);
+  }
+}
+
+/**************** queuePush ****************/
+/* append page to the queue, doubling its ring buffer if full
+ * returns false if out of memory
+ * not visible to outsiders, not in frontier.h
+ */
+static bool queuePush(queue_t* queue, webpage_t* page) {
+  if (queue->count == queue->capacity) {
+    size_t newCapacity = (queue->capacity == 0) ? 16 : queue->capacity * 2;
+    webpage_t** newItems = malloc(newCapacity * sizeof(webpage_t*));
+    if (newItems == NULL) {
+      return false;
+    }
+    //unwrap the old ring so the oldest page lands at 0
+    for (size_t i = 0; i < queue->count; i++) {
+      newItems[i] = queue->items[(queue->head + i) & (queue->capacity - 1)];
+    }
+    free(queue->items);
+    queue->items = newItems;
+    queue->head = 0;
+    queue->capacity = newCapacity;
+  }
+  queue->items[(queue->head + queue->count) & (queue->capacity - 1)] = page;
+  queue->count++;
+  return true;
+}
+
+/**************** queuePop ****************/
+/* remove and return the oldest page, or NULL if the queue is empty
+ * not visible to outsiders, not in frontier.h
+ */
+static webpage_t* queuePop(queue_t* queue) {
+  if (queue->count == 0) {
+    return NULL;
+  }
+  webpage_t* page = queue->items[queue->head];
+  queue->head = (queue->head + 1) & (queue->capacity - 1);
+  queue->count--;
+  return page;
+}
+
+/**************** queuePopBack ****************/
+/* remove and return the newest page, or NULL if the queue is empty
+ * not visible to outsiders, not in frontier.h
+ */
+static webpage_t* queuePopBack(queue_t* queue) {
+  if (queue->count == 0) {
+    return NULL;
+  }
+  queue->count--;
+  return queue->items[(queue->head + queue->count) & (queue->capacity - 1)];
+}
+
+/**************** takeFrom ****************/
+/* remove and return the oldest page of queue which, reading its next
+ * segment back from disk if its ring buffer is empty
+ * returns NULL if the queue is empty
+ * not visible to outsiders, not in frontier.h
+ */
+static webpage_t* takeFrom(frontier_t* frontier, const int which) {
+  queue_t* queue = &frontier->queues[which];
+  while (queue->count == 0 && queue->onDisk > 0) {
+    loadSegment(frontier, which);
+  }
+  webpage_t* page = queuePop(queue);
+  if (page != NULL) {
+    frontier->memCount--;
+  }
+  return page;
+}
+
+/**************** spillPage ****************/
+/* append page to the newest segment of queue which, and delete it
+ * returns false if the segment can't be opened or written (the page is
+ * deleted, and not counted as on disk)
+ * not visible to outsiders, not in frontier.h
+ */
+static bool spillPage(frontier_t* frontier, const int which, webpage_t* page) {
+  queue_t* queue = &frontier->queues[which];
+  //start a new segment once this one is full; it is kept open until
+  //then, so that its newest page can still be evicted
+  if (queue->writeFp != NULL && queue->writeCount == frontier->segPages) {
+    fclose(queue->writeFp);
+    queue->writeFp = NULL;
+    queue->writeSeg++;
+    queue->writeCount = 0;
+  }
+  if (queue->offsets == NULL) {
+    queue->offsets = malloc(frontier->segPages * sizeof(long));
+  }
+  if (queue->writeFp == NULL && queue->offsets != NULL) {
+    char* name = segmentName(frontier, which, queue->writeSeg);
+    if (name != NULL) {
+      queue->writeFp = fopen(name, "w");
+      free(name);
+    }
+  }
+  if (queue->writeFp == NULL) {
+    webpage_delete(page);
+    return false;
+  }
+
+  //a full disk shows up here, rather than as pages missing on read back
+  long offset = ftell(queue->writeFp);
+  if (offset < 0 || fprintf(queue->writeFp, "%d %s\n", webpage_getDepth(page),
+                            webpage_getURL(page)) < 0) {
+    webpage_delete(page);
+    return false;
+  }
+  webpage_delete(page);
+  queue->offsets[queue->writeCount] = offset;
+  queue->writeCount++;
+  queue->onDisk++;
+  frontier->spilled++;
+  return true;
+}
+
+/**************** unspillPage ****************/
+/* remove the newest page on disk of queue which, by seeking its segment
+ * back over it (what follows is overwritten, or never read back); a
+ * segment left empty is removed and the one before it reopened, with
+ * the offsets of its lines read back
+ * returns false if the queue has no pages on disk, or on error
+ * not visible to outsiders, not in frontier.h
+ */
+static bool unspillPage(frontier_t* frontier, const int which) {
+  queue_t* queue = &frontier->queues[which];
+  if (queue->onDisk == 0 || queue->writeFp == NULL) {
+    return false;
+  }
+
+  if (queue->writeCount == 0) {
+    //every page of this segment was evicted; the one before it is full
+    char* name = segmentName(frontier, which, queue->writeSeg);
+    fclose(queue->writeFp);
+    queue->writeFp = NULL;
+    if (name != NULL) {
+      remove(name);
+      free(name);
+    }
+    queue->writeSeg--;
+    name = segmentName(frontier, which, queue->writeSeg);
+    queue->writeFp = (name == NULL) ? NULL : fopen(name, "r+");
+    free(name);
+    if (queue->writeFp == NULL) {
+      //leave the full segment alone; the next spill starts a new one
+      queue->writeSeg++;
+      return false;
+    }
+    long offset = 0;
+    bool lineStart = true;
+    int c;
+    while (queue->writeCount < frontier->segPages && (c = getc(queue->writeFp)) != EOF) {
+      if (lineStart) {
+        queue->offsets[queue->writeCount++] = offset;
+      }
+      lineStart = (c == '\n');
+      offset++;
+    }
+  }
+
+  queue->writeCount--;
+  queue->onDisk--;
+  if (fseek(queue->writeFp, queue->offsets[queue->writeCount], SEEK_SET) != 0) {
+    return false;
+  }
+
+  //nothing left on disk: the segment is the oldest too, remove it
+  if (queue->onDisk == 0) {
+    char* name = segmentName(frontier, which, queue->writeSeg);
+    fclose(queue->writeFp);
+    queue->writeFp = NULL;
+    if (name != NULL) {
+      remove(name);
+      free(name);
+    }
+    queue->writeSeg++;
+    queue->readSeg = queue->writeSeg;
+    queue->writeCount = 0;
+  }
+  return true;
+}
+
+/**************** loadSegment ****************/
+/* read the oldest segment of queue which into its ring buffer, in order,
+ * and remove the segment file; pages that can't be read back are
+ * counted as dropped
+ * not visible to outsiders, not in frontier.h
+ */
+static void loadSegment(frontier_t* frontier, const int which) {
+  queue_t* queue = &frontier->queues[which];
+
+  //every segment but the newest is full, so the oldest holds this many
+  long expected = (queue->onDisk < frontier->segPages)
+                  ? queue->onDisk : frontier->segPages;
+  long loaded = 0;
+
+  //the oldest segment may be the one still being written
+  if (queue->readSeg == queue->writeSeg) {
+    if (queue->writeFp != NULL) {
+      fclose(queue->writeFp);
+      queue->writeFp = NULL;
+    }
+    queue->writeSeg++;
+    queue->writeCount = 0;
+  }
+
+  char* name = segmentName(frontier, which, queue->readSeg);
+  FILE* fp = (name == NULL) ? NULL : fopen(name, "r");
+  if (fp != NULL) {
+    int depth;
+    while (loaded < expected && fscanf(fp, "%d ", &depth) == 1) {
+      char* url = file_readLine(fp);
+      webpage_t* page = (url == NULL) ? NULL : webpage_new(url, depth, NULL);
+      if (page == NULL) {
+        free(url);
+        break;
+      }
+      if (!queuePush(queue, page)) {
+        webpage_delete(page);
+        break;
+      }
+      loaded++;
+    }
+    fclose(fp);
+    remove(name);
+  }
+  free(name);
+  queue->readSeg++;
+
+  queue->onDisk -= expected;
+  frontier->memCount += loaded;
+  frontier->count -= expected - loaded;
+  frontier->dropped += expected - loaded;
+}
+
+/**************** segmentName ****************/
+/* return the path of segment seg of queue which, or NULL if out of memory
+ * caller must free the path
+ * not visible to outsiders, not in frontier.h
+ */
+static char* segmentName(frontier_t* frontier, const int which, const long seg) {
+  char* name = malloc(strlen(frontier->spillDir) + 64);
+  if (name != NULL) {
+    sprintf(name, "%s/frontier-%d-%ld", frontier->spillDir, which, seg);
+  }
+  return name;
+}
+
+/**************** queueFor ****************/
+/* return the index of the queue page belongs in, adding it if needed,
+ * or -1 if out of memory
+ * not visible to outsiders, not in frontier.h
+ */
+static int queueFor(frontier_t* frontier, webpage_t* page) {
+  if (frontier->policy == FRONTIER_BFS) {
+    return 0;
+  }
+
+  if (frontier->policy == FRONTIER_DEPTH) {
+    int depth = webpage_getDepth(page);
+    while (frontier->numQueues <= depth) {
+      if (addQueue(frontier) < 0) {
+        return -1;
+      }
+    }
+    return depth;
+  }
+
+  //host: the url between "://" and the next '/', ':', '?', '#' or end
+  const char* host = webpage_getURL(page);
+  const char* scheme = strstr(host, "://");
+  if (scheme != NULL) {
+    host = scheme + 3;
+  }
+  size_t len = strcspn(host, "/:?#");
+
+  //hosts are few, so a linear search is enough
+  for (int i = 0; i < frontier->numQueues; i++) {
+    if (strncmp(frontier->hosts[i], host, len) == 0
+        && frontier->hosts[i][len] == '\0') {
+      return i;
+    }
+  }
+  char* copy = malloc(len + 1);
+  if (copy == NULL) {
+    return -1;
+  }
+  memcpy(copy, host, len);
+  copy[len] = '\0';
+  int which = addQueue(frontier);
+  if (which < 0) {
+    free(copy);
+    return -1;
+  }
+  frontier->hosts[which] = copy;
+  return which;
+}
+
+/**************** addQueue ****************/
+/* add an empty queue (and host slot, for the host policy)
+ * returns its index, or -1 if out of memory
+ * not visible to outsiders, not in frontier.h
+ */
+static int addQueue(frontier_t* frontier) {
+  if (frontier->numQueues == frontier->maxQueues) {
+    int newMax = (frontier->maxQueues == 0) ? 8 : frontier->maxQueues * 2;
+    queue_t* newQueues = realloc(frontier->queues, newMax * sizeof(queue_t));
+    if (newQueues == NULL) {
+      return -1;
+    }
+    frontier->queues = newQueues;
+    if (frontier->policy == FRONTIER_HOST) {
+      char** newHosts = realloc(frontier->hosts, newMax * sizeof(char*));
+      if (newHosts == NULL) {
+        return -1;
+      }
+      frontier->hosts = newHosts;
+    }
+    frontier->maxQueues = newMax;
+  }
+
+  queue_t* queue = &frontier->queues[frontier->numQueues];
+  queue->items = NULL;
+  queue->head = 0;
+  queue->count = 0;
+  queue->capacity = 0;
+  queue->onDisk = 0;
+  queue->readSeg = 0;
+  queue->writeSeg = 0;
+  queue->writeCount = 0;
+  queue->writeFp = NULL;
+  queue->offsets = NULL;
+  if (frontier->hosts != NULL) {
+    frontier->hosts[frontier->numQueues] = NULL;
+  }
+  return frontier->numQueues++;
+}
+
+/**************** evictDeeper ****************/
+/* make room by deleting the newest page of the deepest non-empty queue,
+ * if that queue is deeper than depth; a queue's newest pages are on
+ * disk, if it has any there
+ * returns true if a page was evicted
+ * not visible to outsiders, not in frontier.h
+ */
+static bool evictDeeper(frontier_t* frontier, const int depth) {
+  for (int d = frontier->numQueues - 1; d > depth; d--) {
+    queue_t* queue = &frontier->queues[d];
+    if (queue->onDisk > 0) {
+      if (!unspillPage(frontier, d)) {
+        continue;
+      }
+    } else {
+      webpage_t* victim = queuePopBack(queue);
+      if (victim == NULL) {
+        continue;
+      }
+      webpage_delete(victim);
+      frontier->memCount--;
+    }
+    frontier->count--;
+    frontier->dropped++;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,127 @@
+/*
+ * frontier.h - header file for CS50 'frontier' module
+ *
+ * a frontier holds the webpages the crawler has found but not yet
+ * fetched, and decides which one comes next. Three policies are offered:
+ *
+ *   bfs   - first in, first out: pages are fetched in the order found,
+ *           so every page at depth d is fetched before any at depth d+1.
+ *   host  - one first-in-first-out queue per host, served round robin,
+ *           so a host with many links cannot starve the others.
+ *   depth - one queue per depth, always served from the shallowest;
+ *           when the frontier is full, a new page evicts a pending page
+ *           that is deeper than it.
+ *
+ * Queues are ring buffers of page pointers, one contiguous array each,
+ * that double in size as they fill. The frontier may be given a bound on
+ * the number of pending pages; past it, pages are dropped (and counted)
+ * rather than queued.
+ *
+ * For crawls too big to keep in memory, the frontier can spill: past a
+ * set number of pages in memory, newly found pages are appended to
+ * segment files in a spill directory and read back, in order, when
+ * their turn comes. Pending pages are then bounded by disk, not memory.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "webpage.h"
+
+/**************** global types ****************/
+typedef struct frontier frontier_t;  // opaque to users of the module
+
+typedef enum frontierPolicy {
+  FRONTIER_BFS,
+  FRONTIER_HOST,
+  FRONTIER_DEPTH
+} frontierPolicy_t;
+
+/**************** functions ****************/
+
+/**************** frontier_parsePolicy ****************/
+/* Look up a policy by name: "bfs", "host" or "depth".
+ *
+ * We return:
+ *   true and set *policy if name is known, false otherwise.
+ */
+bool frontier_parsePolicy(const char* name, frontierPolicy_t* policy);
+
+/**************** frontier_new ****************/
+/* Create a new (empty) frontier.
+ *
+ * Caller provides:
+ *   policy - the order in which pages are extracted
+ *   maxPending - most pages held at once, or 0 for no bound
+ * We return:
+ *   pointer to a new frontier, or NULL if error.
+ * Caller is responsible for:
+ *   later calling frontier_delete.
+ */
+frontier_t* frontier_new(const frontierPolicy_t policy, const size_t maxPending);
+
+/**************** frontier_setSpill ****************/
+/* Let an empty frontier spill pages to disk.
+ *
+ * Caller provides:
+ *   valid frontier pointer, for a frontier with nothing inserted yet
+ *   spillDir - existing, writable directory for segment files
+ *   memLimit - pages to hold in memory before spilling, > 0
+ * We return:
+ *   true if spilling is set up, false if error or invalid parameters.
+ * We guarantee:
+ *   segment files are named frontier-<queue>-<segment>, and removed
+ *   once read back or when the frontier is deleted.
+ * Notes:
+ *   reading a segment back may hold up to twice memLimit pages in memory.
+ */
+bool frontier_setSpill(frontier_t* frontier, const char* spillDir,
+                       const size_t memLimit);
+
+/**************** frontier_insert ****************/
+/* Add a page to the frontier.
+ *
+ * Caller provides:
+ *   valid frontier pointer, valid page pointer.
+ * We return:
+ *   true if the page was queued, in memory or on disk,
+ *   false if it was dropped because the frontier is full, or on error.
+ * We guarantee:
+ *   the frontier owns the page from now on; a page that is dropped, now
+ *   or when evicted later, is deleted with webpage_delete.
+ */
+bool frontier_insert(frontier_t* frontier, webpage_t* page);
+
+/**************** frontier_extract ****************/
+/* Remove and return the next page, according to the policy.
+ *
+ * We return:
+ *   the next page, or NULL if the frontier is empty or NULL.
+ * Caller is responsible for:
+ *   later calling webpage_delete on the page.
+ */
+webpage_t* frontier_extract(frontier_t* frontier);
+
+/**************** frontier_size ****************/
+/* Return the number of pending pages, or 0 if frontier is NULL. */
+size_t frontier_size(frontier_t* frontier);
+
+/**************** frontier_dropped ****************/
+/* Return the number of pages dropped or evicted because the frontier
+ * was full (or lost reading a segment back), or 0 if frontier is NULL. */
+long frontier_dropped(frontier_t* frontier);
+
+/**************** frontier_spilled ****************/
+/* Return the number of pages ever spilled to disk, or 0 if frontier
+ * is NULL. */
+long frontier_spilled(frontier_t* frontier);
+
+/**************** frontier_delete ****************/
+/* Delete the frontier and every page still in it; we ignore NULL. */
+void frontier_delete(frontier_t* frontier);
+
+#endif // FRONTIER_H
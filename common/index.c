@@ -7,23 +7,78 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <limits.h>
 #include <math.h>
 #include "mem.h"
 #include "webpage.h"
-#include "hashtable.h"
 #include "counters.h"
 #include "bag.h"
 #include "pagedir.h"
 #include "file.h"
+#include "reader.h"
+#include "writer.h"
+#include "manifest.h"
+#include "bitmap.h"
+#include "arena.h"
+#include "intern.h"
+#include "dict.h"
+#include "codec.h"
+#include "docset.h"
 #include "index.h"
 #include "word.h"
 
 
+/**************** local constants ****************/
+//first word of an index file written with a codec, see index_saveWith
+static const char COMPRESSED_MAGIC[] = "cindex";
+//fewest docIDs a word needs to have its postings kept as a docset too
+static const int COMMON_DF = 64;
+
 /**************** local types ****************/
+typedef struct docNode {
+  int docID;
+  int count;
+  struct docNode* next;     // docIDs in decreasing order
+} docNode_t;
+
+typedef struct segment {
+  docNode_t** postings;     // by term ID, NULL if the word isn't in the segment
+  int numIDs;               // size of postings
+  arena_t* arena;           // holds the nodes, or NULL to malloc each
+  bitmap_t* deleted;        // docIDs whose postings here are dead, or NULL
+} segment_t;
+
+typedef struct common {
+  bool checked;             // whether index_docSet has looked at the word
+  docset_t* docs;           // its live docIDs, if it is common, else NULL
+  int* counts;              // the count of each, in docID order
+} common_t;
+
 typedef struct index {
-  hashtable_t* ht;          // hashtable keyed by word, storing counters as items
+  intern_t* terms;          // every word of every segment, once, by term ID
+  segment_t* segments;      // oldest first, the last one takes new postings
+  int numSegments;
+  int maxSegments;          // size of segments array
+  bool useArena;            // whether new segments allocate from an arena
+  common_t* common;         // by term ID, made by index_docSet; NULL if none
+  int numCommon;            // size of common
+  dict_t* dict;             // its words in order, made by index_prefixDocSet; or NULL
 } index_t;
 
+/**************** local functions ****************/
+static segment_t* index_active(index_t* index);
+static int index_termID(index_t* index, const char* word);
+static docNode_t* segment_docs(segment_t* segment, const int id);
+static docNode_t** segment_postings(segment_t* segment, const int id);
+static docNode_t* segment_doc(segment_t* segment, docNode_t** docs, const int docID);
+static void* segment_alloc(segment_t* segment, const size_t size);
+static void segment_free(segment_t* segment);
+static int index_docFreq(index_t* index, const int id);
+static void index_countPosting(void* arg, const int key, int count);
+static void segment_drop(segment_t* segment, const int id);
+static void index_buildCommon(index_t* index, const int id, common_t* common);
+static void index_dropCaches(index_t* index);
+
 /**************** global functions ****************/
 /* that is, visible outside this file */
 
@@ -31,6 +86,13 @@ typedef struct index {
 /* Allocate and initialize an index */
 /* see index.h for more information */
 index_t* index_new(int numSlots) {
+  return index_newWith(numSlots, true);
+}
+
+/**************** index_newWith ****************/
+/* Allocate and initialize an index, choosing how it allocates */
+/* see index.h for more information */
+index_t* index_newWith(int numSlots, bool useArena) {
   index_t* index = mem_malloc(sizeof(index_t));
 
   if (index == NULL) {
@@ -38,24 +100,90 @@ index_t* index_new(int numSlots) {
     fprintf(stderr, "can't allocate memory for index");
     return NULL;
   }
-  index->ht = hashtable_new(numSlots);
+  index->terms = intern_new(numSlots);
+  index->segments = NULL;
+  index->numSegments = 0;
+  index->maxSegments = 0;
+  index->useArena = useArena;
+  index->common = NULL;
+  index->numCommon = 0;
+  index->dict = NULL;
+  if (index->terms == NULL || !index_addSegment(index, numSlots)) {
+    fprintf(stderr, "can't allocate memory for index");
+    intern_delete(index->terms);
+    free(index->segments);
+    mem_free(index);
+    return NULL;
+  }
   return index;
 }
 
+/**************** index_addSegment ****************/
+/* start a new segment that takes every later posting */
+/* see index.h for more information */
+bool index_addSegment(index_t* index, int numSlots) {
+  if (index == NULL) {
+    return false;
+  }
+  index_dropCaches(index);
+  if (index->numSegments == index->maxSegments) {
+    int newMax = (index->maxSegments == 0) ? 4 : index->maxSegments * 2;
+    segment_t* newSegments = realloc(index->segments, newMax * sizeof(segment_t));
+    if (newSegments == NULL) {
+      return false;
+    }
+    index->segments = newSegments;
+    index->maxSegments = newMax;
+  }
+  segment_t* segment = &index->segments[index->numSegments];
+  segment->numIDs = (numSlots < 1) ? 1 : numSlots;
+  segment->postings = calloc(segment->numIDs, sizeof(docNode_t*));
+  segment->arena = index->useArena ? arena_new(0) : NULL;
+  segment->deleted = NULL;
+  if (segment->postings == NULL || (index->useArena && segment->arena == NULL)) {
+    free(segment->postings);
+    arena_delete(segment->arena);
+    return false;
+  }
+  index->numSegments++;
+  return true;
+}
+
+/**************** index_setDeleted ****************/
+/* see index.h for more information */
+void index_setDeleted(index_t* index, const int i, bitmap_t* deleted) {
+  if (index == NULL || i < 0 || i >= index->numSegments) {
+    bitmap_delete(deleted);
+    return;
+  }
+  index_dropCaches(index);
+  bitmap_delete(index->segments[i].deleted);
+  index->segments[i].deleted = deleted;
+}
+
+/**************** index_numSegments ****************/
+/* see index.h for more information */
+int index_numSegments(index_t* index) {
+  return (index == NULL) ? 0 : index->numSegments;
+}
+
 /**************** index_add ****************/
 /* add a word to the index */
 /* see index.h for more information */
 void index_add(index_t* index, char* word, int docID) {
-  //check if key exists in index
-  hashtable_t* ht = index->ht;
-  counters_t* ctrs;
-  if ((ctrs = hashtable_find(ht, word)) == NULL) {
-    //key doesn't exist, create new counter with count as 0
-    hashtable_insert(ht, word, ctrs = counters_new());
-    counters_set(ctrs, docID, 0); //0 because gets incremented in indexer
+  //cached docsets and dict no longer hold every posting
+  if (index->common != NULL || index->dict != NULL) {
+    index_dropCaches(index);
+  }
+  //check if key exists in the newest segment
+  segment_t* segment = index_active(index);
+  docNode_t** docs = segment_postings(segment, index_termID(index, word));
+  if (*docs == NULL) {
+    //key doesn't exist, create new posting with count as 0
+    segment_doc(segment, docs, docID); //0 because gets incremented in indexer
   } else {
-    //key exists, increase counter by 1
-    counters_add(ctrs, docID);
+    //key exists, increase count by 1 (a new docID starts at 0)
+    segment_doc(segment, docs, docID)->count++;
   }
 }
 
@@ -63,10 +191,8 @@ void index_add(index_t* index, char* word, int docID) {
 /* find counters for a word */
 /* see index.h for more information */
 counters_t* index_find(index_t* index, char* word) {
-  //check if key exists in index
-  hashtable_t* ht = index->ht;
-  counters_t* ctrs;
-  if ((ctrs = hashtable_find(ht, word)) == NULL) {
+  counters_t* ctrs = index_postings(index, word);
+  if (ctrs == NULL) {
     //key doesn't exist, print error and exist nonzero
     fprintf(stderr, "word doesn't exist in index\n");
     exit(1);
@@ -79,68 +205,673 @@ counters_t* index_find(index_t* index, char* word) {
 /* set a counter value of index */
 /* see index.h for more information */
 void index_set(index_t* index, char* word, char* docID, int count) {
-  //check if key exists in index
-  hashtable_t* ht = index->ht;
-  counters_t* ctrs;
-  if ((ctrs = hashtable_find(ht, word)) == NULL) {
-    //key doesn't exist, create new counter with count as 0
-    hashtable_insert(ht, word, ctrs = counters_new());
-    counters_set(ctrs, atoi(docID), count);
-  } else {
-    //key exists, increase counter by 1
-    counters_set(ctrs, atoi(docID), count);
-  }
+  //find or create the word in the newest segment, then its docID
+  index_dropCaches(index);
+  segment_t* segment = index_active(index);
+  docNode_t** docs = segment_postings(segment, index_termID(index, word));
+  segment_doc(segment, docs, atoi(docID))->count = count;
 }
 
+/**************** index_cutoff ****************/
+/* remove the words in more than maxDocs docIDs */
+/* see index.h for more information */
+int index_cutoff(index_t* index, const int maxDocs, void* arg,
+                 void (*itemfunc)(void* arg, const char* word)) {
+  if (index == NULL) {
+    return 0;
+  }
+  index_dropCaches(index);
+  int removed = 0;
+  for (int id = 0; id < intern_size(index->terms); id++) {
+    if (index_docFreq(index, id) > maxDocs) {
+      //the word stays in the intern pool, with no postings
+      for (int i = 0; i < index->numSegments; i++) {
+        segment_drop(&index->segments[i], id);
+      }
+      if (itemfunc != NULL) {
+        (*itemfunc)(arg, intern_string(index->terms, id));
+      }
+      removed++;
+    }
+  }
+  return removed;
+}
 
 /**************** index_check ****************/
 /* check if a word is in index */
 /* see index.h for more information */
 bool index_check(index_t* index, char* word) {
-  //true if hashtable finds word, else, false
-  return (hashtable_find(index->ht, word) != NULL);
+  //true if any segment has postings for word, else, false
+  int id = intern_find(index->terms, word);
+  for (int i = 0; id >= 0 && i < index->numSegments; i++) {
+    if (segment_docs(&index->segments[i], id) != NULL) {
+      return true;
+    }
+  }
+  return false;
 }
 
-/**************** index_printValues ****************/
-/* helper function that prints values of counters to a file */
+/**************** index_postings ****************/
+/* merge a word's postings across segments */
+/* see index.h for more information */
+counters_t* index_postings(index_t* index, char* word) {
+  if (index == NULL || word == NULL) {
+    return NULL;
+  }
+  //hash the word once; each segment then looks up its term ID
+  int id = intern_find(index->terms, word);
+  counters_t* merged = NULL;
+  for (int i = 0; id >= 0 && i < index->numSegments; i++) {
+    docNode_t* docs = segment_docs(&index->segments[i], id);
+    if (docs != NULL) {
+      if (merged == NULL && (merged = counters_new()) == NULL) {
+        return NULL;
+      }
+      //oldest first, so a newer segment's count for a docID wins;
+      //a dead posting (its docID has a tombstone) is left out
+      for (docNode_t* doc = docs; doc != NULL; doc = doc->next) {
+        if (!bitmap_test(index->segments[i].deleted, doc->docID)) {
+          counters_set(merged, doc->docID, doc->count);
+        }
+      }
+    }
+  }
+  return merged;
+}
+
+/**************** index_postingArray ****************/
+/* a word's postings merged across segments, as arrays in docID order */
+/* see index.h for more information */
+int index_postingArray(index_t* index, char* word, int** docIDs, int** counts) {
+  if (index == NULL || word == NULL || docIDs == NULL || counts == NULL) {
+    return -1;
+  }
+  *docIDs = NULL;
+  *counts = NULL;
+  int id = intern_find(index->terms, word);
+  int total = 0;
+  for (int i = 0; id >= 0 && i < index->numSegments; i++) {
+    for (docNode_t* doc = segment_docs(&index->segments[i], id); doc != NULL; doc = doc->next) {
+      total++;
+    }
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  //the merged postings so far go at the front, each segment's after
+  //position total, so they fit however the segments overlap
+  int* ids = malloc(2 * total * sizeof(int));
+  int* cts = malloc(2 * total * sizeof(int));
+  if (ids == NULL || cts == NULL) {
+    free(ids);
+    free(cts);
+    return -1;
+  }
+  int n = 0;
+  for (int i = 0; i < index->numSegments; i++) {
+    //the segment's live postings, in increasing docID order
+    int m = 0;
+    for (docNode_t* doc = segment_docs(&index->segments[i], id); doc != NULL; doc = doc->next) {
+      m += !bitmap_test(index->segments[i].deleted, doc->docID);
+    }
+    int k = total + m;
+    for (docNode_t* doc = segment_docs(&index->segments[i], id); doc != NULL; doc = doc->next) {
+      if (!bitmap_test(index->segments[i].deleted, doc->docID)) {
+        k--;
+        ids[k] = doc->docID;
+        cts[k] = doc->count;
+      }
+    }
+    if (m == 0) {
+      continue;
+    }
+
+    //merge from the largest docID down, into the front, the newer
+    //segment's count winning; the n + m places there are enough
+    int a = n - 1;
+    int b = total + m - 1;
+    int out = n + m;
+    while (a >= 0 || b >= total) {
+      out--;
+      if (b < total || (a >= 0 && ids[a] > ids[b])) {
+        ids[out] = ids[a];
+        cts[out] = cts[a];
+        a--;
+      } else {
+        if (a >= 0 && ids[a] == ids[b]) {
+          a--;
+        }
+        ids[out] = ids[b];
+        cts[out] = cts[b];
+        b--;
+      }
+    }
+    //a docID in both leaves a gap at the front
+    n = n + m - out;
+    memmove(ids, ids + out, n * sizeof(int));
+    memmove(cts, cts + out, n * sizeof(int));
+  }
+  if (n == 0) {
+    //every posting is dead
+    free(ids);
+    free(cts);
+    return 0;
+  }
+  *docIDs = ids;
+  *counts = cts;
+  return n;
+}
+
+/**************** index_docSet ****************/
+/* a common word's postings as a docset and counts, made once and kept */
+/* see index.h for more information */
+const docset_t* index_docSet(index_t* index, char* word, const int** counts) {
+  if (index == NULL || word == NULL || counts == NULL) {
+    return NULL;
+  }
+  int id = intern_find(index->terms, word);
+  if (id < 0) {
+    return NULL;
+  }
+  if (id >= index->numCommon) {
+    //room for every term ID so far
+    int numCommon = intern_size(index->terms);
+    common_t* common = realloc(index->common, numCommon * sizeof(common_t));
+    if (common == NULL) {
+      return NULL;
+    }
+    memset(common + index->numCommon, 0, (numCommon - index->numCommon) * sizeof(common_t));
+    index->common = common;
+    index->numCommon = numCommon;
+  }
+  common_t* common = &index->common[id];
+  if (!common->checked) {
+    common->checked = true;
+    index_buildCommon(index, id, common);
+  }
+  *counts = common->counts;
+  return common->docs;
+}
+
+/**************** local types for index_save ****************/
+typedef struct term {
+  const char* word;
+  int id;                   // its term ID
+} term_t;
+
+typedef struct posting {
+  int docID;
+  int count;
+} posting_t;
+
+//growable arrays of terms, and of postings filled by counters_iterate
+typedef struct termList {
+  term_t* terms;
+  int count;
+  int capacity;
+} termList_t;
+
+typedef struct postingList {
+  posting_t* postings;
+  int count;
+  int capacity;
+} postingList_t;
+
+/**************** index_collectTerms ****************/
+/* helper function that appends to a termList each word that some
+ * segment has live postings for */
 /* not visible to outsiders, not in index.h */
-static void index_printValues(void* arg, const int key, int count) {
-  //write the docID (key) and count (int) pair on the file (arg)
-  FILE* fp = arg;
-  fprintf(fp, " %d %d", key, count);
+static void index_collectTerms(termList_t* list, index_t* index) {
+  for (int id = 0; id < intern_size(index->terms); id++) {
+    bool found = false;
+    for (int i = 0; i < index->numSegments && !found; i++) {
+      docNode_t* doc = segment_docs(&index->segments[i], id);
+      while (doc != NULL && bitmap_test(index->segments[i].deleted, doc->docID)) {
+        doc = doc->next;
+      }
+      found = (doc != NULL);
+    }
+    if (found) {
+      if (list->count == list->capacity) {
+        list->capacity = (list->capacity == 0) ? 1024 : list->capacity * 2;
+        list->terms = mem_assert(realloc(list->terms, list->capacity * sizeof(term_t)),
+                                 "couldn't allocate memory for index_save");
+      }
+      list->terms[list->count].word = intern_string(index->terms, id);
+      list->terms[list->count].id = id;
+      list->count++;
+    }
+  }
 }
 
-/**************** index_getCounters ****************/
-/* helper function that gets counters for index_save
- * and calls printValues for all of them
- */
+/**************** index_collectPosting ****************/
+/* helper function that appends each docID and count to a postingList */
 /* not visible to outsiders, not in index.h */
-static void index_getCounters(void* arg, const char* key, void* item) {
-  FILE* fp = arg;
-  counters_t* ctrs = item;
-  //write the key (word) on the beginning of the file (arg)
-  fprintf(fp, "%s", key);
-  //call iterate on item (counters)
-  counters_iterate(ctrs, fp, index_printValues);
-  fprintf(fp, "\n");
+static void index_collectPosting(void* arg, const int key, int count) {
+  postingList_t* list = arg;
+  if (list->count == list->capacity) {
+    list->capacity = (list->capacity == 0) ? 256 : list->capacity * 2;
+    list->postings = mem_assert(realloc(list->postings, list->capacity * sizeof(posting_t)),
+                                "couldn't allocate memory for index_save");
+  }
+  list->postings[list->count].docID = key;
+  list->postings[list->count].count = count;
+  list->count++;
 }
 
+/**************** index_compareTerms ****************/
+/* qsort comparator, orders terms by word */
+/* not visible to outsiders, not in index.h */
+static int index_compareTerms(const void* a, const void* b) {
+  return strcmp(((const term_t*)a)->word, ((const term_t*)b)->word);
+}
+
+/**************** index_comparePostings ****************/
+/* qsort comparator, orders postings by docID */
+/* not visible to outsiders, not in index.h */
+static int index_comparePostings(const void* a, const void* b) {
+  int x = ((const posting_t*)a)->docID;
+  int y = ((const posting_t*)b)->docID;
+  return (x > y) - (x < y);
+}
+
+/**************** index_putCompressed ****************/
+/* helper function that writes a word and its postings, in docID order,
+ * with codec: the word and a NUL, then as vbyte the number of
+ * postings and the byte length of the docID gaps, the gaps, then the
+ * byte length of the counts, and the counts */
+/* not visible to outsiders, not in index.h */
+static void index_putCompressed(writer_t* writer, const char* word,
+                                postingList_t* postings, const codec_t codec) {
+  int n = postings->count;
+  uint32_t* values = mem_assert(malloc(n * sizeof(uint32_t)),
+                                "couldn't allocate memory for index_save");
+  unsigned char* bytes = mem_assert(malloc(codec_maxBytes(codec, n) + 5),
+                                    "couldn't allocate memory for index_save");
+  unsigned char length[5];
+
+  writer_putBytes(writer, word, strlen(word) + 1);
+  writer_putBytes(writer, length, codec_putVByte(n, length));
+  for (int pass = 0; pass < 2; pass++) {
+    //docID gaps, then counts
+    for (int j = 0; j < n; j++) {
+      posting_t* posting = &postings->postings[j];
+      values[j] = (pass == 1) ? (uint32_t)posting->count
+        : (uint32_t)posting->docID - ((j == 0) ? 0 : (uint32_t)posting[-1].docID);
+    }
+    size_t len = codec_encode(codec, values, n, bytes);
+    writer_putBytes(writer, length, codec_putVByte(len, length));
+    writer_putBytes(writer, bytes, len);
+  }
+  free(values);
+  free(bytes);
+}
 
 /**************** index_save ****************/
-/* save index content to a file */
+/* save index content to a file, words in strcmp order, each
+ * word's docIDs in increasing order, so that equal indexes are saved
+ * as identical files */
 /* see index.h for more information */
 void index_save(index_t* index, char* indexFilename) {
+  index_saveWith(index, indexFilename, CODEC_NONE);
+}
+
+/**************** index_saveWith ****************/
+/* save index content to a file, as text or compressed with a codec */
+/* see index.h for more information */
+void index_saveWith(index_t* index, char* indexFilename, const codec_t codec) {
   //check if the file can be opened to write
-  hashtable_t* ht = index->ht;
   FILE* fp = fopen(indexFilename, "w");
-  if (fp != NULL) {
-    //loop over each element (word) of hashtable, call index_getCounters on each
-    hashtable_iterate(ht, fp, index_getCounters);
-    fclose(fp);
-  } else {
+  writer_t* writer = writer_new(fp);
+  if (writer == NULL) {
     fprintf(stderr, "couldn't open file\n");
     exit(1);
   }
+  if (codec != CODEC_NONE) {
+    writer_putString(writer, COMPRESSED_MAGIC);
+    writer_putChar(writer, ' ');
+    writer_putString(writer, codec_name(codec));
+    writer_putChar(writer, '\n');
+  }
+
+  //gather and sort the words of every segment
+  termList_t terms = { NULL, 0, 0 };
+  index_collectTerms(&terms, index);
+  if (terms.count > 0) {
+    qsort(terms.terms, terms.count, sizeof(term_t), index_compareTerms);
+  }
+
+  //write each word once, then its docID count pairs in docID order
+  postingList_t postings = { NULL, 0, 0 };
+  for (int i = 0; i < terms.count; i++) {
+    postings.count = 0;
+    if (index->numSegments == 1 && index->segments[0].deleted == NULL) {
+      for (docNode_t* doc = segment_docs(&index->segments[0], terms.terms[i].id);
+           doc != NULL; doc = doc->next) {
+        index_collectPosting(&postings, doc->docID, doc->count);
+      }
+    } else {
+      //the word may be in several segments, save them as one, live postings only
+      counters_t* merged = index_postings(index, (char*)terms.terms[i].word);
+      counters_iterate(merged, &postings, index_collectPosting);
+      counters_delete(merged);
+    }
+    if (postings.count == 0) {
+      //every page that had the word is deleted
+      continue;
+    }
+    qsort(postings.postings, postings.count, sizeof(posting_t), index_comparePostings);
+
+    if (codec != CODEC_NONE) {
+      index_putCompressed(writer, terms.terms[i].word, &postings, codec);
+      continue;
+    }
+    writer_putString(writer, terms.terms[i].word);
+    for (int j = 0; j < postings.count; j++) {
+      writer_putChar(writer, ' ');
+      writer_putInt(writer, postings.postings[j].docID);
+      writer_putChar(writer, ' ');
+      writer_putInt(writer, postings.postings[j].count);
+    }
+    writer_putChar(writer, '\n');
+  }
+  free(terms.terms);
+  free(postings.postings);
+
+  if (!writer_delete(writer) || fclose(fp) != 0) {
+    fprintf(stderr, "couldn't write file\n");
+    exit(1);
+  }
+}
+
+/**************** index_dict ****************/
+/* make a term dictionary of the words index_save would save */
+/* see index.h for more information */
+dict_t* index_dict(index_t* index) {
+  if (index == NULL) {
+    return NULL;
+  }
+  termList_t terms = { NULL, 0, 0 };
+  index_collectTerms(&terms, index);
+  if (terms.count > 0) {
+    qsort(terms.terms, terms.count, sizeof(term_t), index_compareTerms);
+  }
+
+  const char** words = malloc((terms.count + 1) * sizeof(char*));
+  dict_t* dict = NULL;
+  if (words != NULL) {
+    for (int i = 0; i < terms.count; i++) {
+      words[i] = terms.terms[i].word;
+    }
+    dict = dict_new(words, terms.count);
+  }
+  free(words);
+  free(terms.terms);
+  return dict;
+}
+
+/**************** local types for index_prefixDocSet ****************/
+//the postings of a prefix's words, gathered by index_addExpansion
+typedef struct expansion {
+  index_t* index;
+  postingList_t postings;
+} expansion_t;
+
+/**************** index_addExpansion ****************/
+/* helper function that appends the live postings of one word of a
+ * prefix to an expansion, as index_save gathers a word's postings */
+/* not visible to outsiders, not in index.h */
+static void index_addExpansion(void* arg, const int id, const char* word) {
+  expansion_t* expansion = arg;
+  index_t* index = expansion->index;
+  if (index->numSegments == 1 && index->segments[0].deleted == NULL) {
+    for (docNode_t* doc = segment_docs(&index->segments[0], intern_find(index->terms, word));
+         doc != NULL; doc = doc->next) {
+      index_collectPosting(&expansion->postings, doc->docID, doc->count);
+    }
+  } else {
+    counters_t* merged = index_postings(index, (char*)word);
+    counters_iterate(merged, &expansion->postings, index_collectPosting);
+    counters_delete(merged);
+  }
+}
+
+/**************** index_prefixDocSet ****************/
+/* unite the postings of the words that start with a prefix */
+/* see index.h for more information */
+docset_t* index_prefixDocSet(index_t* index, const char* prefix, const int maxWords,
+                             int** counts, int* numWords) {
+  if (index == NULL || prefix == NULL || counts == NULL || numWords == NULL) {
+    return NULL;
+  }
+  //the words in order, once; a prefix is then a range of them
+  if (index->dict == NULL && (index->dict = index_dict(index)) == NULL) {
+    return NULL;
+  }
+  int first = 0;
+  *numWords = dict_prefix(index->dict, prefix, &first);
+  expansion_t expansion = { index, { NULL, 0, 0 } };
+  dict_iterate(index->dict, first, (*numWords < maxWords) ? *numWords : maxWords,
+               &expansion, index_addExpansion);
+
+  //sort every word's postings together, then add up each docID's run of
+  //counts; the docIDs go into the docset in increasing order
+  postingList_t* postings = &expansion.postings;
+  docset_t* docs = NULL;
+  *counts = NULL;
+  if (postings->count > 0 && (docs = docset_new()) != NULL
+      && (*counts = malloc(postings->count * sizeof(int))) != NULL) {
+    qsort(postings->postings, postings->count, sizeof(posting_t), index_comparePostings);
+    int n = 0;
+    for (int i = 0; i < postings->count && docs != NULL; ) {
+      int docID = postings->postings[i].docID;
+      int count = 0;
+      for (; i < postings->count && postings->postings[i].docID == docID; i++) {
+        count += postings->postings[i].count;
+      }
+      if (docset_add(docs, docID)) {
+        (*counts)[n++] = count;
+      } else {
+        docset_delete(docs);
+        docs = NULL;
+      }
+    }
+  }
+  if (docs == NULL || *counts == NULL) {
+    //no such words, or out of memory
+    docset_delete(docs);
+    free(*counts);
+    *counts = NULL;
+    docs = NULL;
+  }
+  free(postings->postings);
+  return docs;
+}
+
+/**************** index_parseInt ****************/
+/* helper function that parses a decimal integer starting at *pos,
+ * stopping at the first non-digit; like atoi, but advances *pos past
+ * the digits and reports whether there were any and they fit in an
+ * int. DocIDs and counts are never negative, so a '-' is no number */
+/* not visible to outsiders, not in index.h */
+static bool index_parseInt(char** pos, const char* end, int* value) {
+  char* p = *pos;
+  char* digits = p;
+  int n = 0;
+  bool fits = true;
+  while (p < end && *p >= '0' && *p <= '9') {
+    int digit = *p - '0';
+    if (n > (INT_MAX - digit) / 10) {
+      fits = false;
+    } else {
+      n = n * 10 + digit;
+    }
+    p++;
+  }
+  *value = n;
+  *pos = p;
+  return p > digits && fits;
+}
+
+/**************** index_parseCompressed ****************/
+/* helper function that adds every posting in text, the contents of an
+ * index file written by index_saveWith with a codec, to the newest
+ * segment of index; returns false, with index unchanged, if text
+ * doesn't start with the header of one. Otherwise returns true, and
+ * sets *malformed if the postings couldn't all be decoded, in which
+ * case those before the fault are in the segment */
+/* not visible to outsiders, not in index.h */
+static bool index_parseCompressed(index_t* index, char* text, const size_t len,
+                                  bool* malformed) {
+  //header: magic, a space, the codec's name, a newline
+  size_t magic = strlen(COMPRESSED_MAGIC);
+  char* newline = memchr(text, '\n', len);
+  char name[16];
+  codec_t codec;
+  if (newline == NULL || newline - text <= (long)magic + 1
+      || newline - text - magic - 1 >= sizeof(name)
+      || memcmp(text, COMPRESSED_MAGIC, magic) != 0 || text[magic] != ' ') {
+    return false;
+  }
+  memcpy(name, text + magic + 1, newline - text - magic - 1);
+  name[newline - text - magic - 1] = '\0';
+  if (!codec_parse(name, &codec) || codec == CODEC_NONE) {
+    return false;
+  }
+
+  segment_t* segment = index_active(index);
+  const unsigned char* p = (unsigned char*)newline + 1;
+  const unsigned char* end = (unsigned char*)text + len;
+  uint32_t* gaps = NULL;
+  uint32_t* counts = NULL;
+  uint32_t capacity = 0;
+  bool ok = true;
+  while (ok && p < end) {
+    //the word, its number of postings, then the gaps and the counts
+    const unsigned char* nul = memchr(p, '\0', end - p);
+    uint32_t n, gapBytes, countBytes;
+    size_t used;
+    ok = (nul != NULL);
+    const char* word = (const char*)p;
+    if (ok) {
+      p = nul + 1;
+      ok = (used = codec_getVByte(p, end - p, &n)) > 0
+        && (p += used, (used = codec_getVByte(p, end - p, &gapBytes)) > 0)
+        && (p += used, gapBytes <= (size_t)(end - p))
+        && n <= 240 * (size_t)(end - p);   //simple8b packs 240 to 8 bytes at most
+    }
+    if (ok && n > capacity) {
+      capacity = n;
+      gaps = mem_assert(realloc(gaps, capacity * sizeof(uint32_t)), "couldn't allocate memory for index");
+      counts = mem_assert(realloc(counts, capacity * sizeof(uint32_t)), "couldn't allocate memory for index");
+    }
+    ok = ok && codec_decode(codec, p, gapBytes, gaps, n)
+      && (p += gapBytes, (used = codec_getVByte(p, end - p, &countBytes)) > 0)
+      && (p += used, countBytes <= (size_t)(end - p))
+      && codec_decode(codec, p, countBytes, counts, n);
+    if (ok) {
+      p += countBytes;
+      docNode_t** docs = segment_postings(segment, index_termID(index, word));
+      uint32_t docID = 0;
+      for (uint32_t j = 0; j < n; j++) {
+        docID += gaps[j];
+        segment_doc(segment, docs, (int)docID)->count = (int)counts[j];
+      }
+    }
+  }
+  if (!ok) {
+    fprintf(stderr, "malformed compressed index, read up to byte %ld\n",
+            (long)(p - (unsigned char*)text));
+  }
+  free(gaps);
+  free(counts);
+  *malformed = !ok;
+  return true;
+}
+
+/**************** index_parse ****************/
+/* helper function that adds every posting in text, the contents of
+ * an index file, to the newest segment of index; text is modified,
+ * then freed. Returns false if text is a compressed index that
+ * couldn't be decoded; a text index is read up to a malformed pair,
+ * such as a negative docID or one too big for an int, and the rest of
+ * its line is skipped */
+/* not visible to outsiders, not in index.h */
+static bool index_parse(index_t* index, char* text, const size_t len) {
+    if (text == NULL) {
+        return true;
+    }
+    index_dropCaches(index);
+    bool malformed = false;
+    if (index_parseCompressed(index, text, len, &malformed)) {
+        free(text);
+        return !malformed;
+    }
+
+    segment_t* segment = index_active(index);
+
+    //parse each line in a single pass over text, in place:
+    //word docID count [docID count]..., separated by spaces
+    char* p = text;
+    char* end = text + len;
+    while (p < end) {
+        //skip spaces, and blank lines
+        while (p < end && *p == ' ') {
+            p++;
+        }
+        if (p == end) {
+            break;
+        }
+        if (*p == '\n') {
+            p++;
+            continue;
+        }
+
+        //the word runs to the next space or newline; end it in place
+        char* word = p;
+        while (p < end && *p != ' ' && *p != '\n') {
+            p++;
+        }
+        bool lineEnded = (p == end || *p == '\n');
+        if (p < end) {
+            *p++ = '\0';
+        } else {
+            *p = '\0';   //reader_readFile leaves room for this NUL
+        }
+
+        //look the word up once for the whole line, at its first pair
+        docNode_t** docs = NULL;
+
+        //docID count pairs, until the end of the line
+        while (!lineEnded) {
+            int docID, count;
+            while (p < end && *p == ' ') {
+                p++;
+            }
+            if (!index_parseInt(&p, end, &docID)) {
+                break;
+            }
+            while (p < end && *p == ' ') {
+                p++;
+            }
+            if (!index_parseInt(&p, end, &count)) {
+                break;
+            }
+            if (docs == NULL) {
+                docs = segment_postings(segment, index_termID(index, word));
+            }
+            segment_doc(segment, docs, docID)->count = count;
+        }
+
+        //skip whatever is left of the line, and its newline
+        if (!lineEnded) {
+            char* newline = memchr(p, '\n', end - p);
+            p = (newline == NULL) ? end : newline + 1;
+        }
+    }
+    free(text);
+    return true;
 }
 
 /**************** index_load() ****************/ 
@@ -150,51 +881,101 @@ index_t* index_load(char* indexFilename) {
     //get file pointer, no need to check again after validateParams
     FILE* fp = fopen(indexFilename, "r");
 
+    //read the whole file in one go
+    size_t len = 0;
+    char* text = NULL;
+    if (fp != NULL) {
+        text = reader_readFile(fp, &len);
+        fclose(fp);
+    }
+
     /*
-    create index, use number of lines as hashtable slots as every line 
-    corresponds to a word in the file that's being read. This is being 
-    done instead of an arbitary number to be more memory-efficient.
+    create index, sizing the hashtable from the file size: every line
+    is one word, and a line takes a few dozen bytes, so this gives
+    about one slot per word without a separate pass to count lines.
     */
-    index_t* index = index_new(file_numLines(fp));
-
-    char* line;
-    //read each line
-    while ((line = file_readLine(fp)) != NULL) {
-        
-        //get words and initialize variables
-        char** words = splitWords(line);
-        int count = 0;
-
-        //loop over words
-        //starting from 1, pattern is 'docID counter' repeated
-        //0 is the word itself, skip
-        for (int i = 1; words[i] != NULL; i+=2) {
-            char* docID = words[i];
-            count = atoi(words[i+1]);
-            index_set(index, words[0], docID, count);
-        }
+    index_t* index = index_new(len / 32 + 1);
+    if (index == NULL) {
+        free(text);
+    } else if (!index_parse(index, text, len)) {
+        //a corrupt file isn't passed off as a smaller index
+        index_delete(index);
+        index = NULL;
+    }
+    return index;
+}
 
-        //free the array of words and the line
-        freeWords(words);
-        free(line);
+/**************** index_loadInto() ****************/ 
+ /* add the postings in an index file to an existing index */
+ /* see index.h for more information*/
+bool index_loadInto(index_t* index, char* indexFilename) {
+    FILE* fp = fopen(indexFilename, "r");
+    if (index == NULL || fp == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        return false;
+    }
+    size_t len = 0;
+    char* text = reader_readFile(fp, &len);
+    fclose(fp);
+    return index_parse(index, text, len);
+}
 
+/**************** index_loadSegment() ****************/ 
+ /* load an index file into a new segment, sized to the file */
+ /* see index.h for more information*/
+bool index_loadSegment(index_t* index, char* indexFilename) {
+    FILE* fp = fopen(indexFilename, "r");
+    if (index == NULL || fp == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        return false;
     }
+    size_t len = 0;
+    char* text = reader_readFile(fp, &len);
     fclose(fp);
-    return index;
+    if (!index_addSegment(index, len / 32 + 1)) {
+        free(text);
+        return false;
+    }
+    if (!index_parse(index, text, len)) {
+        //drop the segment, and whatever was decoded into it
+        segment_free(&index->segments[--index->numSegments]);
+        index_dropCaches(index);
+        return false;
+    }
+    return true;
 }
 
-/**************** itemdelete ****************/
-/* index_delete helper function
- * 
- * deletes the counter
- * wrapper function for counters_delete to prevent compiler warnings
- * returns void
- *
-*/
-/* not visible to outsiders, not in index.h */
-static void itemdelete(void* item) {
-  counters_t* ctrs = item;
-  counters_delete(ctrs);
+/**************** index_loadAll() ****************/ 
+ /* load an index file and every segment its manifest lists */
+ /* see index.h for more information*/
+index_t* index_loadAll(char* indexFilename) {
+    index_t* index = index_load(indexFilename);
+    manifest_t* manifest = manifest_load(indexFilename);
+    if (index != NULL) {
+        index_setDeleted(index, 0, bitmap_copy(manifest_getDeleted(manifest, 0)));
+    }
+
+    //each segment file stays a segment of its own, merged at query time
+    for (int i = 0; index != NULL && i < manifest_numSegments(manifest); i++) {
+        int segment = manifest_getSegment(manifest, i);
+        char* segmentName = manifest_segmentName(indexFilename, segment);
+        if (segmentName == NULL || !index_loadSegment(index, segmentName)) {
+            //rather than serve the index without the segment's postings
+            fprintf(stderr, "couldn't read segment %d of %s\n", segment, indexFilename);
+            index_delete(index);
+            index = NULL;
+        } else {
+            index_setDeleted(index, index_numSegments(index) - 1,
+                             bitmap_copy(manifest_getDeleted(manifest, segment)));
+        }
+        free(segmentName);
+    }
+    manifest_delete(manifest);
+    return index;
 }
 
 /**************** index_delete ****************/
@@ -203,11 +984,239 @@ static void itemdelete(void* item) {
 void index_delete(index_t* index) {
   if (index != NULL) {
     //index is null, do nothing
-    hashtable_delete(index->ht, itemdelete);
-    free(index);
-  } else if (index->ht == NULL) {
-    //index is valid but hashtable null, just free index
+    for (int i = 0; i < index->numSegments; i++) {
+      segment_free(&index->segments[i]);
+    }
+    free(index->segments);
+    index_dropCaches(index);
+    intern_delete(index->terms);
     free(index);
   }
 }
 
+/**************** index_active ****************/
+/* return the newest segment, the one that takes new postings
+ * not visible to outsiders, not in index.h
+ */
+static segment_t* index_active(index_t* index) {
+  return &index->segments[index->numSegments - 1];
+}
+
+/**************** index_termID ****************/
+/* return the term ID of word, adding it to the index's terms if new;
+ * exits if out of memory
+ * not visible to outsiders, not in index.h
+ */
+static int index_termID(index_t* index, const char* word) {
+  int id = intern_add(index->terms, word);
+  if (id < 0) {
+    fprintf(stderr, "couldn't allocate memory for index\n");
+    exit(1);
+  }
+  return id;
+}
+
+/**************** segment_docs ****************/
+/* return the segment's postings for a term ID, NULL if it has none
+ * not visible to outsiders, not in index.h
+ */
+static docNode_t* segment_docs(segment_t* segment, const int id) {
+  return (id < segment->numIDs) ? segment->postings[id] : NULL;
+}
+
+/**************** segment_postings ****************/
+/* return where the segment keeps the postings for a term ID, making
+ * room for the ID if needed; exits if out of memory
+ * not visible to outsiders, not in index.h
+ */
+static docNode_t** segment_postings(segment_t* segment, const int id) {
+  if (id >= segment->numIDs) {
+    //at least double, so adding new words takes linear time
+    int numIDs = (id + 1 < segment->numIDs * 2) ? segment->numIDs * 2 : id + 1;
+    docNode_t** postings = mem_assert(realloc(segment->postings, numIDs * sizeof(docNode_t*)),
+                                      "couldn't allocate memory for index");
+    memset(postings + segment->numIDs, 0, (numIDs - segment->numIDs) * sizeof(docNode_t*));
+    segment->postings = postings;
+    segment->numIDs = numIDs;
+  }
+  return &segment->postings[id];
+}
+
+/**************** segment_doc ****************/
+/* return the node for docID in a word's postings, adding it with count
+ * 0 if it isn't there; the indexer and index files give docIDs in
+ * increasing order, so a new docID almost always goes at the head
+ * not visible to outsiders, not in index.h
+ */
+static docNode_t* segment_doc(segment_t* segment, docNode_t** docs, const int docID) {
+  docNode_t** prev = docs;
+  while (*prev != NULL && (*prev)->docID > docID) {
+    prev = &(*prev)->next;
+  }
+  if (*prev != NULL && (*prev)->docID == docID) {
+    return *prev;
+  }
+  docNode_t* doc = segment_alloc(segment, sizeof(docNode_t));
+  doc->docID = docID;
+  doc->count = 0;
+  doc->next = *prev;
+  *prev = doc;
+  return doc;
+}
+
+/**************** segment_alloc ****************/
+/* allocate size bytes for the segment, from its arena if it has one;
+ * exits if out of memory
+ * not visible to outsiders, not in index.h
+ */
+static void* segment_alloc(segment_t* segment, const size_t size) {
+  void* p = (segment->arena != NULL) ? arena_alloc(segment->arena, size) : malloc(size);
+  return mem_assert(p, "couldn't allocate memory for index");
+}
+
+/**************** segment_free ****************/
+/* free everything the segment holds: with an arena, in one go;
+ * otherwise posting by posting
+ * not visible to outsiders, not in index.h
+ */
+static void segment_free(segment_t* segment) {
+  if (segment->arena != NULL) {
+    arena_delete(segment->arena);
+  } else {
+    for (int id = 0; id < segment->numIDs; id++) {
+      docNode_t* doc = segment->postings[id];
+      while (doc != NULL) {
+        docNode_t* next = doc->next;
+        free(doc);
+        doc = next;
+      }
+    }
+  }
+  free(segment->postings);
+  bitmap_delete(segment->deleted);
+}
+
+/**************** index_docFreq ****************/
+/* return the number of docIDs the word with term ID id has live
+ * postings for, across every segment
+ * not visible to outsiders, not in index.h
+ */
+static int index_docFreq(index_t* index, const int id) {
+  int df = 0;
+  if (index->numSegments == 1) {
+    for (docNode_t* doc = segment_docs(&index->segments[0], id); doc != NULL; doc = doc->next) {
+      df += !bitmap_test(index->segments[0].deleted, doc->docID);
+    }
+  } else {
+    //segments may share docIDs; count them once
+    counters_t* merged = index_postings(index, (char*)intern_string(index->terms, id));
+    counters_iterate(merged, &df, index_countPosting);
+    counters_delete(merged);
+  }
+  return df;
+}
+
+/**************** index_countPosting ****************/
+/* helper function that counts the postings of counters
+ * not visible to outsiders, not in index.h
+ */
+static void index_countPosting(void* arg, const int key, int count) {
+  (*(int*)arg)++;
+}
+
+/**************** segment_drop ****************/
+/* remove the segment's postings for a term ID; with an arena, their
+ * memory is freed with the segment
+ * not visible to outsiders, not in index.h
+ */
+static void segment_drop(segment_t* segment, const int id) {
+  if (id >= segment->numIDs) {
+    return;
+  }
+  docNode_t* doc = segment->postings[id];
+  while (segment->arena == NULL && doc != NULL) {
+    docNode_t* next = doc->next;
+    free(doc);
+    doc = next;
+  }
+  segment->postings[id] = NULL;
+}
+
+/**************** index_buildCommon ****************/
+/* if the word with term ID id has live postings for at least COMMON_DF
+ * docIDs, fill common with them: the docIDs as a docset, the counts
+ * alongside, the newest segment's count where several have the docID;
+ * otherwise, or if out of memory, leave it empty
+ * not visible to outsiders, not in index.h
+ */
+static void index_buildCommon(index_t* index, const int id, common_t* common) {
+  //the postings of every segment bound the docIDs; most words stop here
+  int total = 0;
+  int longest = 0;
+  for (int i = 0; i < index->numSegments; i++) {
+    int length = 0;
+    for (docNode_t* doc = segment_docs(&index->segments[i], id); doc != NULL; doc = doc->next) {
+      length++;
+    }
+    total += length;
+    longest = (length > longest) ? length : longest;
+  }
+  if (total < COMMON_DF) {
+    return;
+  }
+
+  //unite the segments' live docIDs, each added in increasing order
+  docset_t* docs = docset_new();
+  docset_t* segmentDocs = NULL;
+  int* docIDs = malloc(longest * sizeof(int));
+  bool ok = (docs != NULL && docIDs != NULL);
+  for (int i = 0; ok && i < index->numSegments; i++) {
+    int n = 0;
+    for (docNode_t* doc = segment_docs(&index->segments[i], id); doc != NULL; doc = doc->next) {
+      if (!bitmap_test(index->segments[i].deleted, doc->docID)) {
+        docIDs[n++] = doc->docID;
+      }
+    }
+    ok = ((segmentDocs = docset_new()) != NULL);
+    while (ok && n > 0) {
+      ok = docset_add(segmentDocs, docIDs[--n]);
+    }
+    ok = ok && docset_or(docs, segmentDocs);
+    docset_delete(segmentDocs);
+  }
+  free(docIDs);
+  int size = docset_size(docs);
+  int* counts = NULL;
+  if (!ok || size < COMMON_DF || (counts = malloc(size * sizeof(int))) == NULL) {
+    docset_delete(docs);
+    return;
+  }
+
+  //oldest first, so a newer segment's count for a docID wins
+  for (int i = 0; i < index->numSegments; i++) {
+    for (docNode_t* doc = segment_docs(&index->segments[i], id); doc != NULL; doc = doc->next) {
+      if (!bitmap_test(index->segments[i].deleted, doc->docID)) {
+        counts[docset_index(docs, doc->docID)] = doc->count;
+      }
+    }
+  }
+  common->docs = docs;
+  common->counts = counts;
+}
+
+/**************** index_dropCaches ****************/
+/* forget what index_docSet and index_prefixDocSet have made, when
+ * the index changes
+ * not visible to outsiders, not in index.h
+ */
+static void index_dropCaches(index_t* index) {
+  dict_delete(index->dict);
+  index->dict = NULL;
+  for (int id = 0; id < index->numCommon; id++) {
+    docset_delete(index->common[id].docs);
+    free(index->common[id].counts);
+  }
+  free(index->common);
+  index->common = NULL;
+  index->numCommon = 0;
+}
@@ -1,10 +1,29 @@
 /* 
  * index.h - header file for CS50 'index' module
  * 
- * an index is a data structure that consists of a hashtable that
- * holds a word (char*) as key, and counters (counters_t*) as items
- * each counter holds docID (char*) as key with number of occurences of
- * the word on the file with corresponding docID (int) as items
+ * an index maps each word to its postings: the docIDs of the pages
+ * that have the word, each with the number of occurences of the word
+ * on that page.
+ *
+ * an index may be made of several segments, each holding postings of
+ * its own, queried as one index: new postings go to the newest segment, and
+ * where segments disagree on a word's count for a docID, the newest wins.
+ * A segment may have tombstones, docIDs whose postings in it are dead
+ * (the page was deleted, or updated into a newer segment).
+ * An index built by the indexer has a single segment; index_loadAll
+ * makes one segment per file.
+ *
+ * The index keeps each distinct word once, in an intern pool (see
+ * intern.h) shared by its segments, which find a word's postings by
+ * its term ID; a word is hashed once per lookup however many segments
+ * there are. The postings of a segment are small and numerous, and live
+ * as long as the segment; by default they come from an arena (see
+ * arena.h) rather than a malloc each, and are freed with the segment
+ * all at once.
+ *
+ * The postings of a common word, one in many pages, can also be had as
+ * a docset (see docset.h), with the counts kept beside it: sets of
+ * common words intersect much faster than their postings.
  *
  * Bora Bozdogan, April 2025
  */
@@ -24,6 +43,10 @@
 #include "file.h"
 #include "index.h"
 #include "word.h"
+#include "bitmap.h"
+#include "dict.h"
+#include "codec.h"
+#include "docset.h"
 
 /**************** global types ****************/
 typedef struct index index_t;  // opaque to users of the module
@@ -36,13 +59,56 @@ typedef struct index index_t;  // opaque to users of the module
  * We return:
  *   pointer to a new index, or NULL if error.
  * We guarantee:
- *   The hashtable of index is initialized empty
- *   with numSlots as slot count.
+ *   The index is initialized empty, sized for about numSlots
+ *   words; it grows as words are added.
+ *   Postings are allocated from an arena.
  * Caller is responsible for:
  *   later calling index_delete.
  */
 index_t* index_new(int numSlots);
 
+/**************** index_newWith ****************/
+/* Create a new (empty) index, like index_new, choosing how it allocates.
+ *
+ * Caller provides:
+ *   slot count, as for index_new;
+ *   useArena - true to allocate postings from an arena per segment,
+ *   false to malloc and free each on its own.
+ * We return:
+ *   pointer to a new index, or NULL if error.
+ * Caller is responsible for:
+ *   later calling index_delete.
+ */
+index_t* index_newWith(int numSlots, bool useArena);
+
+/**************** index_addSegment ****************/
+/* Start a new, empty segment; later postings go to it, and the
+ * segments before it are no longer changed.
+ *
+ * Caller provides:
+ *   a valid index pointer, about how many words the segment will hold.
+ * We return:
+ *   true on success, false if index is NULL or out of memory.
+ */
+bool index_addSegment(index_t* index, int numSlots);
+
+/**************** index_setDeleted ****************/
+/* Give the i'th segment (0 is the oldest) the tombstones in deleted,
+ * replacing any it had; its postings for those docIDs are left out of
+ * index_postings and index_save.
+ *
+ * Caller provides:
+ *   a valid index pointer, a bitmap of docIDs, or NULL for none.
+ * We guarantee:
+ *   the index takes deleted over, deleting it with the index
+ *   (or right away, if there is no i'th segment).
+ */
+void index_setDeleted(index_t* index, const int i, bitmap_t* deleted);
+
+/**************** index_numSegments ****************/
+/* Return the number of segments, or 0 if index is NULL. */
+int index_numSegments(index_t* index);
+
 /**************** index_add ****************/
 /* Add new item to the index.
  *
@@ -62,12 +128,86 @@ void index_add(index_t* index, char* word, int docID);
  * Caller provides:
  *   a valid index pointer, a valid word string
  * We guarantee:
- *   if valid params, counters representing the word is returned
+ *   if valid params, new counters representing the word is returned,
+ *   as by index_postings; if the word isn't in the index, exit nonzero
  * Caller is responsible for:
- *   providing valid parameters
+ *   providing valid parameters, later calling counters_delete
 */
 counters_t* index_find(index_t* index, char* word);
 
+/**************** index_postings ****************/
+/* Get a word's postings, merged across every segment.
+ *
+ * Caller provides:
+ *   a valid index pointer, a valid word string
+ * We return:
+ *   new counters holding docID -> count for every live docID of the
+ *   word, the newest segment's count where several have the docID;
+ *   NULL if no segment has the word (or out of memory)
+ * Caller is responsible for:
+ *   later calling counters_delete on the result
+*/
+counters_t* index_postings(index_t* index, char* word);
+
+/**************** index_postingArray ****************/
+/* Get a word's postings, merged across every segment, as arrays.
+ *
+ * Caller provides:
+ *   a valid index pointer, a valid word string, where to put the
+ *   arrays of docIDs and counts.
+ * We return:
+ *   the number of live docIDs of the word, the same postings that
+ *   index_postings gives, with *docIDs in increasing order and *counts
+ *   the count of each; 0 (and NULL arrays) if no segment has the word,
+ *   -1 if out of memory or a parameter is NULL.
+ * Caller is responsible for:
+ *   later freeing *docIDs and *counts.
+ */
+int index_postingArray(index_t* index, char* word, int** docIDs, int** counts);
+
+/**************** index_docSet ****************/
+/* Get a common word's postings as a docset, with its counts.
+ *
+ * Caller provides:
+ *   a valid index pointer, a valid word string, where to put the counts.
+ * We return:
+ *   if the word has live postings for at least 64 docIDs, a docset of
+ *   those docIDs, and in *counts the count of each, in docID order, so
+ *   docset_index gives a docID's place; the same postings that
+ *   index_postings gives. NULL if the word isn't common (or error).
+ * We guarantee:
+ *   a word's docset is made when first asked for, and kept until the
+ *   index next changes.
+ * Caller is responsible for:
+ *   not changing or freeing the docset or counts, and not using them
+ *   once the index changes or is deleted.
+ */
+const docset_t* index_docSet(index_t* index, char* word, const int** counts);
+
+/**************** index_prefixDocSet ****************/
+/* Get the postings of every word that starts with prefix, as one word.
+ *
+ * Caller provides:
+ *   a valid index pointer, a valid prefix string, the most words to
+ *   expand it to, where to put the counts, and where to put how many
+ *   words have the prefix.
+ * We return:
+ *   a new docset of every docID with any of the words found, and in
+ *   *counts the sum of their counts for each, in docID order, as
+ *   index_docSet does for one word; at most maxWords words are looked
+ *   at, the first in strcmp order. *numWords is set to the number of
+ *   words with the prefix, which may be more than maxWords.
+ *   NULL if no word has the prefix (or out of memory).
+ * We guarantee:
+ *   the index's words are sorted into a dict (see dict.h) when a prefix
+ *   is first asked for, and kept until the index next changes; a prefix
+ *   then costs a binary search and a scan of its own words.
+ * Caller is responsible for:
+ *   later calling docset_delete on the result, and freeing *counts.
+ */
+docset_t* index_prefixDocSet(index_t* index, const char* prefix, const int maxWords,
+                             int** counts, int* numWords);
+
 /**************** index_set ****************/
 /* Set an item value of index.
  *
@@ -81,6 +221,22 @@ counters_t* index_find(index_t* index, char* word);
  */
 void index_set(index_t* index, char* word, char* docID, int count);
 
+/**************** index_cutoff ****************/
+/* Remove every word that has live postings for more than maxDocs docIDs.
+ *
+ * Caller provides:
+ *   a valid index pointer, the most docIDs a word may be in, and a
+ *   function to call with each word removed, and its arg; itemfunc
+ *   may be NULL.
+ * We return:
+ *   the number of words removed.
+ * We guarantee:
+ *   a removed word has no postings left in any segment, so index_check
+ *   is false for it and index_save leaves it out.
+ */
+int index_cutoff(index_t* index, const int maxDocs, void* arg,
+                 void (*itemfunc)(void* arg, const char* word));
+
 /**************** index_check ****************/
 /* check if a word is in the index
  *
@@ -106,10 +262,61 @@ bool index_check(index_t* index, char* word);
  *    nonzero if error, index_t* else    
  *
  *  Behavior:
- *    reads a file, creates index based on it  
+ *    reads a file, creates index based on it; the file may be text,
+ *    or compressed by index_saveWith. A compressed file that can't be
+ *    decoded gives NULL; a text line is read up to a malformed docID or
+ *    count (not a number, negative, or too big for an int), and the rest
+ *    of it is skipped
  */
 index_t* index_load(char* indexFilename);
 
+/**************** index_loadInto ****************/
+/* Add the postings of an index file to an existing index.
+ *
+ *  Caller provides:
+ *    a valid index pointer, indexFilename - char* location of an index file
+ *    whose postings go into the newest segment
+ *
+ *  We return:
+ *    true if the file was read, false if it couldn't be opened or
+ *    is a compressed file that can't be decoded, in which case the
+ *    postings before the fault are already in the index
+ *
+ *  Notes:
+ *    a docID already in the index for a word takes the file's count
+ */
+bool index_loadInto(index_t* index, char* indexFilename);
+
+/**************** index_loadSegment ****************/
+/* Load an index file as a new segment of an existing index, after
+ * the others (see index_addSegment).
+ *
+ *  Caller provides:
+ *    a valid index pointer, indexFilename - char* location of an index file
+ *
+ *  We return:
+ *    true if the file was read, false, without the new segment, if
+ *    it couldn't be opened or decoded or there is no memory for it
+ */
+bool index_loadSegment(index_t* index, char* indexFilename);
+
+/**************** index_loadAll ****************/
+/* Load an index file together with the segments its manifest lists
+ * (see manifest.h), as one index of one segment per file; without a
+ * manifest, like index_load.
+ *
+ *  Caller provides:
+ *    indexFilename - char* location of existing index
+ *
+ *  We return:
+ *    index_t* holding every posting of the base and its segments, or
+ *    NULL if the base is malformed or a segment can't be read
+ *
+ *  Caller is responsible for:
+ *    later calling index_delete
+ */
+index_t* index_loadAll(char* indexFilename);
+
 /**************** index_save ****************/
 /* Save the index to a file. 
  *
@@ -120,19 +327,52 @@ index_t* index_load(char* indexFilename);
  *   for valid parameters and memory, print contents to indexFilename
  * We print: 
  *   a space-seperated list in the form of word docID count [docID count]
+ *   one line per word, words in strcmp order, docIDs in increasing order,
+ *   the segments of index merged into one, without dead postings;
+ *   the same index is always saved as the same file, and saved indexes
+ *   can be diffed, or merged line by line without sorting again.
  */
 void index_save(index_t* index, char* indexFilename);
 
+/**************** index_dict ****************/
+/* Make a term dictionary (see dict.h) of the index's words.
+ *
+ * Caller provides:
+ *   a valid index pointer.
+ * We return:
+ *   a new dict of the words index_save would save, those with live
+ *   postings, so a word's term ID is its line in the saved file less 1;
+ *   NULL if index is NULL or error.
+ * Caller is responsible for:
+ *   later calling dict_delete.
+ */
+dict_t* index_dict(index_t* index);
+
+/**************** index_saveWith ****************/
+/* Save the index to a file, as text or compressed.
+ *
+ * Caller provides:
+ *   a valid index pointer, valid file location, a codec (see codec.h);
+ *   CODEC_NONE saves text, as index_save does.
+ * We guarantee:
+ *   if fp null, exit nonzero
+ * We print:
+ *   with a codec, a binary file that index_load and the others read as
+ *   they read text: a line "cindex codecName", then for each word, in
+ *   strcmp order, the word and a NUL, its number of postings (vbyte),
+ *   then its docID gaps and its counts, each encoded with the codec
+ *   and preceded by its length in bytes (vbyte).
+ */
+void index_saveWith(index_t* index, char* indexFilename, const codec_t codec);
+
 /**************** index_delete ****************/
 /* Delete the whole index.
  *
  * Caller provides:
  *   a valid index pointer.
  * We guarantee:
- *   we call itemdelete() on each item.
+ *   every word and posting is freed, a segment's arena in one go.
  *   we ignore NULL index.
- * Notes:
- *   the order in which items are deleted is undefined.
  */
 void index_delete(index_t* index);
 
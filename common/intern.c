@@ -0,0 +1,219 @@
+/*
+ * intern.c - CS50 'intern' module
+ *
+ * see intern.h for more information.
+ *
+ * The table is an array of IDs probed linearly, holding ID + 1 so that
+ * 0 marks an empty slot. Per ID we keep the string and its hash, so the
+ * table can grow without hashing the strings again, and a probe only
+ * compares strings whose hashes match.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "arena.h"
+#include "intern.h"
+
+/**************** local types ****************/
+typedef struct intern {
+  int* slots;               // ID + 1 of each slot's string, 0 if empty
+  size_t capacity;          // number of slots, a power of 2
+  const char** strings;     // by ID, copies in arena
+  uint64_t* hashes;         // by ID
+  int count;                // number of strings, the next ID
+  int maxCount;             // size of strings and hashes
+  arena_t* arena;           // the string bytes
+} intern_t;
+
+/**************** local functions ****************/
+static uint64_t hashString(const char* s);
+static size_t findSlot(intern_t* pool, const uint64_t hash, const char* s);
+static bool grow(intern_t* pool);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** intern_new ****************/
+/* see intern.h for more information */
+intern_t* intern_new(const int expected) {
+  intern_t* pool = mem_malloc(sizeof(intern_t));
+  if (pool == NULL) {
+    return NULL;
+  }
+
+  //smallest power of 2 that holds expected strings below 3/4 full
+  size_t capacity = 64;
+  while (expected > 0 && capacity * 3 < (size_t)expected * 4) {
+    capacity *= 2;
+  }
+
+  pool->capacity = capacity;
+  pool->slots = calloc(capacity, sizeof(int));
+  pool->strings = NULL;
+  pool->hashes = NULL;
+  pool->count = 0;
+  pool->maxCount = 0;
+  pool->arena = arena_new(0);
+  if (pool->slots == NULL || pool->arena == NULL) {
+    intern_delete(pool);
+    return NULL;
+  }
+  return pool;
+}
+
+/**************** intern_add ****************/
+/* see intern.h for more information */
+int intern_add(intern_t* pool, const char* s) {
+  if (pool == NULL || s == NULL) {
+    return -1;
+  }
+  uint64_t hash = hashString(s);
+  size_t slot = findSlot(pool, hash, s);
+  if (pool->slots[slot] != 0) {
+    return pool->slots[slot] - 1;
+  }
+
+  //keep the table under 3/4 full
+  if ((size_t)(pool->count + 1) * 4 > pool->capacity * 3) {
+    if (!grow(pool)) {
+      return -1;
+    }
+    slot = findSlot(pool, hash, s);
+  }
+  if (pool->count == pool->maxCount) {
+    int newMax = (pool->maxCount == 0) ? 256 : pool->maxCount * 2;
+    const char** strings = realloc(pool->strings, newMax * sizeof(char*));
+    if (strings == NULL) {
+      return -1;
+    }
+    pool->strings = strings;
+    uint64_t* hashes = realloc(pool->hashes, newMax * sizeof(uint64_t));
+    if (hashes == NULL) {
+      return -1;
+    }
+    pool->hashes = hashes;
+    pool->maxCount = newMax;
+  }
+  const char* copy = arena_strdup(pool->arena, s);
+  if (copy == NULL) {
+    return -1;
+  }
+
+  int id = pool->count++;
+  pool->strings[id] = copy;
+  pool->hashes[id] = hash;
+  pool->slots[slot] = id + 1;
+  return id;
+}
+
+/**************** intern_find ****************/
+/* see intern.h for more information */
+int intern_find(intern_t* pool, const char* s) {
+  if (pool == NULL || s == NULL) {
+    return -1;
+  }
+  return pool->slots[findSlot(pool, hashString(s), s)] - 1;
+}
+
+/**************** intern_string ****************/
+/* see intern.h for more information */
+const char* intern_string(intern_t* pool, const int id) {
+  if (pool == NULL || id < 0 || id >= pool->count) {
+    return NULL;
+  }
+  return pool->strings[id];
+}
+
+/**************** intern_size ****************/
+/* see intern.h for more information */
+int intern_size(intern_t* pool) {
+  return (pool == NULL) ? 0 : pool->count;
+}
+
+/**************** intern_memory ****************/
+/* see intern.h for more information */
+size_t intern_memory(intern_t* pool) {
+  if (pool == NULL) {
+    return 0;
+  }
+  return sizeof(intern_t) + pool->capacity * sizeof(int)
+    + pool->maxCount * (sizeof(char*) + sizeof(uint64_t))
+    + arena_bytes(pool->arena);
+}
+
+/**************** intern_delete ****************/
+/* see intern.h for more information */
+void intern_delete(intern_t* pool) {
+  if (pool != NULL) {
+    free(pool->slots);
+    free(pool->strings);
+    free(pool->hashes);
+    arena_delete(pool->arena);
+    mem_free(pool);
+  }
+}
+
+/**************** hashString ****************/
+/* 64-bit FNV-1a, with a final mix so the low bits used to pick a slot
+ * depend on every character
+ * not visible to outsiders, not in intern.h
+ */
+static uint64_t hashString(const char* s) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const unsigned char* p = (const unsigned char*)s; *p != '\0'; p++) {
+    hash ^= *p;
+    hash *= 0x100000001b3ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+/**************** findSlot ****************/
+/* find the slot holding s, or the empty slot where it would go
+ * not visible to outsiders, not in intern.h
+ */
+static size_t findSlot(intern_t* pool, const uint64_t hash, const char* s) {
+  size_t mask = pool->capacity - 1;
+  size_t slot = hash & mask;
+  while (pool->slots[slot] != 0) {
+    int id = pool->slots[slot] - 1;
+    if (pool->hashes[id] == hash && strcmp(pool->strings[id], s) == 0) {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+/**************** grow ****************/
+/* double the number of slots and re-insert every ID
+ * returns false, leaving the pool unchanged, if out of memory
+ * not visible to outsiders, not in intern.h
+ */
+static bool grow(intern_t* pool) {
+  size_t newCapacity = pool->capacity * 2;
+  size_t mask = newCapacity - 1;
+  int* newSlots = calloc(newCapacity, sizeof(int));
+  if (newSlots == NULL) {
+    return false;
+  }
+  for (int id = 0; id < pool->count; id++) {
+    size_t slot = pool->hashes[id] & mask;
+    while (newSlots[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    newSlots[slot] = id + 1;
+  }
+  free(pool->slots);
+  pool->slots = newSlots;
+  pool->capacity = newCapacity;
+  return true;
+}
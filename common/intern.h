@@ -0,0 +1,74 @@
+/*
+ * intern.h - header file for CS50 'intern' module
+ *
+ * an intern pool stores each distinct string once and gives it a small
+ * integer ID: 0 for the first string added, 1 for the next, and so on.
+ * The strings are packed into large blocks (see arena.h) and never move,
+ * so a string's ID and pointer stay valid as long as the pool. Code
+ * that holds IDs can compare and index by them instead of hashing and
+ * comparing the strings again.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct intern intern_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** intern_new ****************/
+/* Create a new (empty) intern pool.
+ *
+ * Caller provides:
+ *   expected - number of distinct strings expected, used to size the
+ *     table (the pool grows past it as needed; 0 picks a small default)
+ * We return:
+ *   pointer to a new pool, or NULL if error.
+ * Caller is responsible for:
+ *   later calling intern_delete.
+ */
+intern_t* intern_new(const int expected);
+
+/**************** intern_add ****************/
+/* Add a string to the pool, if it isn't there already.
+ *
+ * Caller provides:
+ *   valid pool pointer, valid string.
+ * We return:
+ *   the string's ID, a new one if the string is new;
+ *   -1 if pool or s is NULL, or out of memory.
+ * We guarantee:
+ *   s is not kept; the pool keeps a copy.
+ */
+int intern_add(intern_t* pool, const char* s);
+
+/**************** intern_find ****************/
+/* Return the ID of a string in the pool, or -1 if it isn't there
+ * (or pool or s is NULL); the pool is unchanged. */
+int intern_find(intern_t* pool, const char* s);
+
+/**************** intern_string ****************/
+/* Return the pool's copy of the string with the given ID, or NULL if
+ * there is no such ID. The caller must not change or free it. */
+const char* intern_string(intern_t* pool, const int id);
+
+/**************** intern_size ****************/
+/* Return the number of strings in the pool, 0 if pool is NULL;
+ * IDs run from 0 to one less than this. */
+int intern_size(intern_t* pool);
+
+/**************** intern_memory ****************/
+/* Return the number of bytes allocated for the pool, 0 if NULL. */
+size_t intern_memory(intern_t* pool);
+
+/**************** intern_delete ****************/
+/* Delete the pool and every string in it; we ignore NULL pool. */
+void intern_delete(intern_t* pool);
+
+#endif // INTERN_H
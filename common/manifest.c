@@ -0,0 +1,553 @@
+/*
+ * manifest.c - CS50 'manifest' module
+ *
+ * see manifest.h for more information.
+ *
+ * Lines start with a keyword; lines with a keyword we don't know are
+ * skipped, so later versions can add settings to the file. Tombstones
+ * are written after the segments, as "deleted <segment> <bitmap>",
+ * segment 0 being the base; see bitmap.h for the bitmap's text.
+ * Stop words are kept sorted, so they are found by binary search and
+ * written in the same order every time.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "reader.h"
+#include "bitmap.h"
+#include "codec.h"
+#include "stem.h"
+#include "manifest.h"
+
+/**************** local types ****************/
+typedef struct segment {
+  int number;               // names the file, indexFilename.seg<number>
+  int firstDocID;           // docIDs held, inclusive
+  int lastDocID;
+  int numDocs;              // pages indexed in it, for the merge policy
+  bitmap_t* deleted;        // tombstones: docIDs whose postings here are dead
+} segment_t;
+
+typedef struct manifest {
+  int lastDocID;            // highest docID indexed, in base or segments
+  int nextSegment;          // number for the next segment added
+  int numShards;            // index files the docIDs are split over, 1 if not sharded
+  codec_t codec;            // how the index files are written
+  char stemmer[32];         // name of the stemmer the words went through, "" if none
+  segment_t* segments;      // oldest first
+  int numSegments;
+  int maxSegments;          // size of segments array
+  bitmap_t* baseDeleted;    // tombstones of the base
+  char** stopwords;         // words left out of the index, in strcmp order
+  int numStopwords;
+  int maxStopwords;         // size of stopwords array
+} manifest_t;
+
+/**************** local functions ****************/
+static bool appendSegment(manifest_t* manifest, const int number,
+                          const int firstDocID, const int lastDocID,
+                          const int numDocs);
+static bitmap_t** deletedOf(manifest_t* manifest, const int seg);
+static void writeDeleted(FILE* fp, const int seg, bitmap_t* deleted);
+static char* metaName(const char* indexFilename, const char* suffix);
+static int findStopword(manifest_t* manifest, const char* word);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** manifest_new ****************/
+/* see manifest.h for more information */
+manifest_t* manifest_new(void) {
+  manifest_t* manifest = mem_malloc(sizeof(manifest_t));
+  if (manifest == NULL) {
+    return NULL;
+  }
+  manifest->lastDocID = 0;
+  manifest->nextSegment = 1;
+  manifest->numShards = 1;
+  manifest->codec = CODEC_NONE;
+  manifest->stemmer[0] = '\0';
+  manifest->segments = NULL;
+  manifest->numSegments = 0;
+  manifest->maxSegments = 0;
+  manifest->baseDeleted = NULL;
+  manifest->stopwords = NULL;
+  manifest->numStopwords = 0;
+  manifest->maxStopwords = 0;
+  return manifest;
+}
+
+/**************** manifest_load ****************/
+/* see manifest.h for more information */
+manifest_t* manifest_load(const char* indexFilename) {
+  char* name = metaName(indexFilename, ".meta");
+  FILE* fp = (name == NULL) ? NULL : fopen(name, "r");
+  free(name);
+  if (fp == NULL) {
+    return NULL;
+  }
+  manifest_t* manifest = manifest_new();
+  if (manifest == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+
+  reader_t* reader = reader_new(fp);
+  char* line;
+  while (reader != NULL && (line = reader_nextLine(reader, NULL)) != NULL) {
+    char key[32];
+    int number, first, last, numDocs, offset;
+    if (sscanf(line, "%31s", key) != 1) {
+      continue;
+    }
+    if (strcmp(key, "lastDocID") == 0) {
+      sscanf(line, "%*s %d", &manifest->lastDocID);
+    } else if (strcmp(key, "nextSegment") == 0) {
+      sscanf(line, "%*s %d", &manifest->nextSegment);
+    } else if (strcmp(key, "shards") == 0) {
+      sscanf(line, "%*s %d", &manifest->numShards);
+    } else if (strcmp(key, "codec") == 0) {
+      char name[32];
+      if (sscanf(line, "%*s %31s", name) == 1) {
+        codec_parse(name, &manifest->codec);
+      }
+    } else if (strcmp(key, "stem") == 0) {
+      //kept by name, even if we don't know it; see manifest_getStemmer
+      sscanf(line, "%*s %31s", manifest->stemmer);
+    } else if (strcmp(key, "stop") == 0) {
+      char* word = strtok(line + strlen(key), " ");
+      if (word != NULL) {
+        manifest_addStopword(manifest, word);
+      }
+    } else if (strcmp(key, "segment") == 0) {
+      //older manifests have no page count; assume the range is full
+      int fields = sscanf(line, "%*s %d %d %d %d", &number, &first, &last, &numDocs);
+      if (fields == 3) {
+        numDocs = last - first + 1;
+      }
+      if (fields >= 3) {
+        appendSegment(manifest, number, first, last, numDocs);
+      }
+    } else if (strcmp(key, "deleted") == 0) {
+      bitmap_t** deleted;
+      if (sscanf(line, "%*s %d %n", &number, &offset) == 1
+          && (deleted = deletedOf(manifest, number)) != NULL) {
+        bitmap_delete(*deleted);
+        *deleted = bitmap_parse(strtok(line + offset, " "));
+      }
+    }
+  }
+  reader_delete(reader);
+  fclose(fp);
+  return manifest;
+}
+
+/**************** manifest_save ****************/
+/* see manifest.h for more information */
+bool manifest_save(manifest_t* manifest, const char* indexFilename) {
+  if (manifest == NULL || indexFilename == NULL) {
+    return false;
+  }
+  char* name = metaName(indexFilename, ".meta");
+  char* tmpName = metaName(indexFilename, ".meta.tmp");
+  FILE* fp = (tmpName == NULL) ? NULL : fopen(tmpName, "w");
+  bool ok = (name != NULL && fp != NULL);
+  if (ok) {
+    fprintf(fp, "lastDocID %d\n", manifest->lastDocID);
+    fprintf(fp, "nextSegment %d\n", manifest->nextSegment);
+    if (manifest->numShards > 1) {
+      fprintf(fp, "shards %d\n", manifest->numShards);
+    }
+    if (manifest->codec != CODEC_NONE) {
+      fprintf(fp, "codec %s\n", codec_name(manifest->codec));
+    }
+    if (manifest->stemmer[0] != '\0') {
+      fprintf(fp, "stem %s\n", manifest->stemmer);
+    }
+    for (int i = 0; i < manifest->numStopwords; i++) {
+      fprintf(fp, "stop %s\n", manifest->stopwords[i]);
+    }
+    for (int i = 0; i < manifest->numSegments; i++) {
+      segment_t* seg = &manifest->segments[i];
+      fprintf(fp, "segment %d %d %d %d\n", seg->number, seg->firstDocID,
+              seg->lastDocID, seg->numDocs);
+    }
+    writeDeleted(fp, 0, manifest->baseDeleted);
+    for (int i = 0; i < manifest->numSegments; i++) {
+      writeDeleted(fp, manifest->segments[i].number, manifest->segments[i].deleted);
+    }
+    ok = (fclose(fp) == 0 && rename(tmpName, name) == 0);
+    if (!ok) {
+      remove(tmpName);
+    }
+  } else if (fp != NULL) {
+    fclose(fp);
+  }
+  free(name);
+  free(tmpName);
+  return ok;
+}
+
+/**************** manifest_getLastDocID ****************/
+/* see manifest.h for more information */
+int manifest_getLastDocID(manifest_t* manifest) {
+  return (manifest == NULL) ? 0 : manifest->lastDocID;
+}
+
+/**************** manifest_setLastDocID ****************/
+/* see manifest.h for more information */
+void manifest_setLastDocID(manifest_t* manifest, const int lastDocID) {
+  if (manifest != NULL) {
+    manifest->lastDocID = lastDocID;
+  }
+}
+
+/**************** manifest_getShards ****************/
+/* see manifest.h for more information */
+int manifest_getShards(manifest_t* manifest) {
+  return (manifest == NULL || manifest->numShards < 1) ? 1 : manifest->numShards;
+}
+
+/**************** manifest_setShards ****************/
+/* see manifest.h for more information */
+void manifest_setShards(manifest_t* manifest, const int numShards) {
+  if (manifest != NULL && numShards >= 1) {
+    manifest->numShards = numShards;
+  }
+}
+
+/**************** manifest_getCodec ****************/
+/* see manifest.h for more information */
+codec_t manifest_getCodec(manifest_t* manifest) {
+  return (manifest == NULL) ? CODEC_NONE : manifest->codec;
+}
+
+/**************** manifest_setCodec ****************/
+/* see manifest.h for more information */
+void manifest_setCodec(manifest_t* manifest, const codec_t codec) {
+  if (manifest != NULL) {
+    manifest->codec = codec;
+  }
+}
+
+/**************** manifest_getStemmer ****************/
+/* see manifest.h for more information */
+bool manifest_getStemmer(manifest_t* manifest, stemmer_t* stemmer) {
+  *stemmer = STEM_NONE;
+  if (manifest == NULL || manifest->stemmer[0] == '\0') {
+    return true;
+  }
+  return stem_parse(manifest->stemmer, stemmer);
+}
+
+/**************** manifest_setStemmer ****************/
+/* see manifest.h for more information */
+void manifest_setStemmer(manifest_t* manifest, const stemmer_t stemmer) {
+  if (manifest != NULL) {
+    strcpy(manifest->stemmer, (stemmer == STEM_NONE) ? "" : stem_name(stemmer));
+  }
+}
+
+/**************** manifest_addStopword ****************/
+/* see manifest.h for more information */
+bool manifest_addStopword(manifest_t* manifest, const char* word) {
+  if (manifest == NULL || word == NULL) {
+    return false;
+  }
+  int i = findStopword(manifest, word);
+  if (i < manifest->numStopwords && strcmp(manifest->stopwords[i], word) == 0) {
+    return true;
+  }
+  if (manifest->numStopwords == manifest->maxStopwords) {
+    int newMax = (manifest->maxStopwords == 0) ? 16 : manifest->maxStopwords * 2;
+    char** newStopwords = realloc(manifest->stopwords, newMax * sizeof(char*));
+    if (newStopwords == NULL) {
+      return false;
+    }
+    manifest->stopwords = newStopwords;
+    manifest->maxStopwords = newMax;
+  }
+  char* copy = malloc(strlen(word) + 1);
+  if (copy == NULL) {
+    return false;
+  }
+  strcpy(copy, word);
+  memmove(&manifest->stopwords[i + 1], &manifest->stopwords[i],
+          (manifest->numStopwords - i) * sizeof(char*));
+  manifest->stopwords[i] = copy;
+  manifest->numStopwords++;
+  return true;
+}
+
+/**************** manifest_isStopword ****************/
+/* see manifest.h for more information */
+bool manifest_isStopword(manifest_t* manifest, const char* word) {
+  if (manifest == NULL || word == NULL) {
+    return false;
+  }
+  int i = findStopword(manifest, word);
+  return i < manifest->numStopwords && strcmp(manifest->stopwords[i], word) == 0;
+}
+
+/**************** manifest_numStopwords ****************/
+/* see manifest.h for more information */
+int manifest_numStopwords(manifest_t* manifest) {
+  return (manifest == NULL) ? 0 : manifest->numStopwords;
+}
+
+/**************** manifest_addSegment ****************/
+/* see manifest.h for more information */
+int manifest_addSegment(manifest_t* manifest, const int firstDocID,
+                        const int lastDocID, const int numDocs) {
+  if (manifest == NULL
+      || !appendSegment(manifest, manifest->nextSegment, firstDocID, lastDocID, numDocs)) {
+    return -1;
+  }
+  if (lastDocID > manifest->lastDocID) {
+    manifest->lastDocID = lastDocID;
+  }
+  return manifest->nextSegment++;
+}
+
+/**************** manifest_numSegments ****************/
+/* see manifest.h for more information */
+int manifest_numSegments(manifest_t* manifest) {
+  return (manifest == NULL) ? 0 : manifest->numSegments;
+}
+
+/**************** manifest_getSegment ****************/
+/* see manifest.h for more information */
+int manifest_getSegment(manifest_t* manifest, const int i) {
+  if (manifest == NULL || i < 0 || i >= manifest->numSegments) {
+    return -1;
+  }
+  return manifest->segments[i].number;
+}
+
+/**************** manifest_getRange ****************/
+/* see manifest.h for more information */
+bool manifest_getRange(manifest_t* manifest, const int i,
+                       int* firstDocID, int* lastDocID) {
+  if (manifest == NULL || i < 0 || i >= manifest->numSegments) {
+    return false;
+  }
+  *firstDocID = manifest->segments[i].firstDocID;
+  *lastDocID = manifest->segments[i].lastDocID;
+  return true;
+}
+
+/**************** manifest_getNumDocs ****************/
+/* see manifest.h for more information */
+int manifest_getNumDocs(manifest_t* manifest, const int i) {
+  if (manifest == NULL || i < 0 || i >= manifest->numSegments) {
+    return 0;
+  }
+  return manifest->segments[i].numDocs;
+}
+
+/**************** manifest_replaceSegments ****************/
+/* see manifest.h for more information */
+int manifest_replaceSegments(manifest_t* manifest, const int i, const int count) {
+  if (manifest == NULL || i < 0 || count < 1 || i + count > manifest->numSegments) {
+    return -1;
+  }
+  //the first of the run takes the merged segment's place, the rest close up;
+  //the merge leaves out dead postings, so their tombstones go
+  segment_t* seg = &manifest->segments[i];
+  seg->number = manifest->nextSegment;
+  for (int j = 1; j < count; j++) {
+    segment_t* other = &manifest->segments[i + j];
+    if (other->firstDocID < seg->firstDocID) {
+      seg->firstDocID = other->firstDocID;
+    }
+    if (other->lastDocID > seg->lastDocID) {
+      seg->lastDocID = other->lastDocID;
+    }
+    seg->numDocs += other->numDocs;
+  }
+  for (int j = 0; j < count; j++) {
+    bitmap_delete(manifest->segments[i + j].deleted);
+  }
+  seg->deleted = NULL;
+  memmove(seg + 1, seg + count,
+          (manifest->numSegments - i - count) * sizeof(segment_t));
+  manifest->numSegments -= count - 1;
+  return manifest->nextSegment++;
+}
+
+/**************** manifest_deleteDoc ****************/
+/* see manifest.h for more information */
+bool manifest_deleteDoc(manifest_t* manifest, const int docID) {
+  if (manifest == NULL) {
+    return false;
+  }
+  //the base, then each segment
+  for (int i = -1; i < manifest->numSegments; i++) {
+    bitmap_t** deleted = (i < 0) ? &manifest->baseDeleted : &manifest->segments[i].deleted;
+    if (*deleted == NULL && (*deleted = bitmap_new()) == NULL) {
+      return false;
+    }
+    if (!bitmap_set(*deleted, docID)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**************** manifest_getDeleted ****************/
+/* see manifest.h for more information */
+bitmap_t* manifest_getDeleted(manifest_t* manifest, const int seg) {
+  bitmap_t** deleted = deletedOf(manifest, seg);
+  return (deleted == NULL) ? NULL : *deleted;
+}
+
+/**************** manifest_clearSegments ****************/
+/* see manifest.h for more information */
+void manifest_clearSegments(manifest_t* manifest) {
+  if (manifest != NULL) {
+    for (int i = 0; i < manifest->numSegments; i++) {
+      bitmap_delete(manifest->segments[i].deleted);
+    }
+    manifest->numSegments = 0;
+    bitmap_delete(manifest->baseDeleted);
+    manifest->baseDeleted = NULL;
+  }
+}
+
+/**************** manifest_segmentName ****************/
+/* see manifest.h for more information */
+char* manifest_segmentName(const char* indexFilename, const int seg) {
+  char suffix[24];
+  sprintf(suffix, ".seg%d", seg);
+  return metaName(indexFilename, suffix);
+}
+
+/**************** manifest_shardName ****************/
+/* see manifest.h for more information */
+char* manifest_shardName(const char* indexFilename, const int shard) {
+  char suffix[24];
+  sprintf(suffix, ".shard%d", shard);
+  return metaName(indexFilename, suffix);
+}
+
+/**************** manifest_dictName ****************/
+/* see manifest.h for more information */
+char* manifest_dictName(const char* indexFilename) {
+  return metaName(indexFilename, ".dict");
+}
+
+/**************** manifest_trigramName ****************/
+/* see manifest.h for more information */
+char* manifest_trigramName(const char* indexFilename) {
+  return metaName(indexFilename, ".trigram");
+}
+
+/**************** manifest_delete ****************/
+/* see manifest.h for more information */
+void manifest_delete(manifest_t* manifest) {
+  if (manifest != NULL) {
+    manifest_clearSegments(manifest);
+    free(manifest->segments);
+    for (int i = 0; i < manifest->numStopwords; i++) {
+      free(manifest->stopwords[i]);
+    }
+    free(manifest->stopwords);
+    mem_free(manifest);
+  }
+}
+
+/**************** appendSegment ****************/
+/* add a segment record after the others, growing the array if needed
+ * returns false if out of memory
+ * not visible to outsiders, not in manifest.h
+ */
+static bool appendSegment(manifest_t* manifest, const int number,
+                          const int firstDocID, const int lastDocID,
+                          const int numDocs) {
+  if (manifest->numSegments == manifest->maxSegments) {
+    int newMax = (manifest->maxSegments == 0) ? 8 : manifest->maxSegments * 2;
+    segment_t* newSegments = realloc(manifest->segments, newMax * sizeof(segment_t));
+    if (newSegments == NULL) {
+      return false;
+    }
+    manifest->segments = newSegments;
+    manifest->maxSegments = newMax;
+  }
+  segment_t* seg = &manifest->segments[manifest->numSegments++];
+  seg->number = number;
+  seg->firstDocID = firstDocID;
+  seg->lastDocID = lastDocID;
+  seg->numDocs = numDocs;
+  seg->deleted = NULL;
+  return true;
+}
+
+/**************** deletedOf ****************/
+/* where the tombstones of segment number seg live, 0 being the base;
+ * NULL if there is no such segment
+ * not visible to outsiders, not in manifest.h
+ */
+static bitmap_t** deletedOf(manifest_t* manifest, const int seg) {
+  if (manifest == NULL) {
+    return NULL;
+  }
+  if (seg == 0) {
+    return &manifest->baseDeleted;
+  }
+  for (int i = 0; i < manifest->numSegments; i++) {
+    if (manifest->segments[i].number == seg) {
+      return &manifest->segments[i].deleted;
+    }
+  }
+  return NULL;
+}
+
+/**************** writeDeleted ****************/
+/* write a "deleted" line for segment number seg, unless it has no tombstones
+ * not visible to outsiders, not in manifest.h
+ */
+static void writeDeleted(FILE* fp, const int seg, bitmap_t* deleted) {
+  if (bitmap_count(deleted) > 0) {
+    fprintf(fp, "deleted %d ", seg);
+    bitmap_write(deleted, fp);
+    fputc('\n', fp);
+  }
+}
+
+/**************** metaName ****************/
+/* return indexFilename followed by suffix, in malloc'd memory
+ * not visible to outsiders, not in manifest.h
+ */
+static char* metaName(const char* indexFilename, const char* suffix) {
+  if (indexFilename == NULL) {
+    return NULL;
+  }
+  char* name = malloc(strlen(indexFilename) + strlen(suffix) + 1);
+  if (name != NULL) {
+    strcpy(name, indexFilename);
+    strcat(name, suffix);
+  }
+  return name;
+}
+
+/**************** findStopword ****************/
+/* return the position of word among the stop words, or where it would go
+ * not visible to outsiders, not in manifest.h
+ */
+static int findStopword(manifest_t* manifest, const char* word) {
+  int lo = 0, hi = manifest->numStopwords;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (strcmp(manifest->stopwords[mid], word) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
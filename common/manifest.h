@@ -0,0 +1,250 @@
+/*
+ * manifest.h - header file for CS50 'manifest' module
+ *
+ * a manifest records how an index on disk is made up, in a small text
+ * file next to it, named indexFilename.meta:
+ *
+ *   lastDocID 420
+ *   nextSegment 4
+ *   segment 1 381 400 20
+ *   segment 2 401 420 20
+ *   segment 3 12 12 1
+ *   deleted 0 0010
+ *   deleted 1 0010
+ *   deleted 2 0010
+ *
+ * The index file itself is the base, holding docIDs up to the first
+ * segment; each segment line gives a segment's number and the range of
+ * docIDs it holds, oldest first. A segment's postings are in an index
+ * file of its own, indexFilename.seg<number>, in the usual index format.
+ *
+ * A segment line may also give the number of pages indexed in the
+ * segment, which is fewer than its range if it holds updated pages.
+ * Deleting or updating a page puts a tombstone on its docID in the base
+ * and in every segment there is at the time: the postings already
+ * indexed for it are dead, while any indexed later (a new segment
+ * holding the page's new content) are live. Above, page 12 was updated
+ * into segment 3; "deleted" lines give a segment's tombstones (0 for
+ * the base) as a bitmap, see bitmap.h.
+ *
+ * A line "shards N" says the index is split into N shards by docID
+ * range, each an index file of its own, indexFilename.shard1 to
+ * indexFilename.shardN, meant to be searched by separate processes;
+ * the base is then empty.
+ *
+ * A line "codec NAME" says the base, segments and shards are written
+ * compressed with that codec (see codec.h and index_saveWith), as are
+ * the index files written for it later; without one, they are text.
+ *
+ * A line "stem NAME" says the words were stemmed with that stemmer
+ * (see stem.h), by the indexer and so by the querier; a manifest naming
+ * a stemmer we don't know is kept as it is, but the index can't be
+ * searched or added to, as its words wouldn't match ours.
+ *
+ * Lines "stop WORD" give the words left out of the index: a stop list
+ * given to the full build, and words it found in too many pages. Later
+ * runs leave them out too, and the querier skips them in queries.
+ *
+ * Beside an unsharded base, indexFilename.dict holds the base's words
+ * as a term dictionary (see dict.h), rewritten whenever the base is,
+ * and indexFilename.trigram the trigram index of those words (see
+ * trigram.h), which the querier uses to correct misspelled words.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "bitmap.h"
+#include "codec.h"
+#include "stem.h"
+
+/**************** global types ****************/
+typedef struct manifest manifest_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** manifest_new ****************/
+/* Create a new manifest: no segments, lastDocID 0.
+ *
+ * We return:
+ *   pointer to a new manifest, or NULL if error.
+ * Caller is responsible for:
+ *   later calling manifest_delete.
+ */
+manifest_t* manifest_new(void);
+
+/**************** manifest_load ****************/
+/* Read the manifest of indexFilename (indexFilename.meta).
+ *
+ * We return:
+ *   pointer to the manifest, or NULL if there is none or it can't be read.
+ * Caller is responsible for:
+ *   later calling manifest_delete.
+ */
+manifest_t* manifest_load(const char* indexFilename);
+
+/**************** manifest_save ****************/
+/* Write the manifest of indexFilename, replacing any earlier one.
+ *
+ * We return:
+ *   true on success, false if the manifest can't be written.
+ * We guarantee:
+ *   the manifest is written to a temporary file and renamed into place,
+ *   so readers see either the old manifest or the new one, never a mix.
+ */
+bool manifest_save(manifest_t* manifest, const char* indexFilename);
+
+/**************** manifest_getLastDocID ****************/
+/* Return the highest docID indexed, or 0 if manifest is NULL. */
+int manifest_getLastDocID(manifest_t* manifest);
+
+/**************** manifest_setLastDocID ****************/
+/* Record the highest docID indexed; we ignore NULL manifest. */
+void manifest_setLastDocID(manifest_t* manifest, const int lastDocID);
+
+/**************** manifest_getShards ****************/
+/* Return the number of shards, 1 if the index isn't sharded or
+ * manifest is NULL. */
+int manifest_getShards(manifest_t* manifest);
+
+/**************** manifest_setShards ****************/
+/* Record the number of shards, at least 1; we ignore NULL manifest. */
+void manifest_setShards(manifest_t* manifest, const int numShards);
+
+/**************** manifest_getCodec ****************/
+/* Return the codec the index files are written with, CODEC_NONE for
+ * text (also if manifest is NULL). */
+codec_t manifest_getCodec(manifest_t* manifest);
+
+/**************** manifest_setCodec ****************/
+/* Set the codec the index files are written with; we ignore NULL manifest. */
+void manifest_setCodec(manifest_t* manifest, const codec_t codec);
+
+/**************** manifest_getStemmer ****************/
+/* Get the stemmer the index's words were stemmed with.
+ *
+ * We return:
+ *   true, with *stemmer set (STEM_NONE if there is none, or manifest
+ *   is NULL); false if the manifest names a stemmer we don't know.
+ */
+bool manifest_getStemmer(manifest_t* manifest, stemmer_t* stemmer);
+
+/**************** manifest_setStemmer ****************/
+/* Set the stemmer the index's words are stemmed with; we ignore NULL manifest. */
+void manifest_setStemmer(manifest_t* manifest, const stemmer_t stemmer);
+
+/**************** manifest_addStopword ****************/
+/* Record word as left out of the index; a word already there is kept once.
+ *
+ * We return:
+ *   true on success, false if manifest or word is NULL, or out of memory.
+ */
+bool manifest_addStopword(manifest_t* manifest, const char* word);
+
+/**************** manifest_isStopword ****************/
+/* Return true if word is left out of the index, false if not or
+ * manifest is NULL. */
+bool manifest_isStopword(manifest_t* manifest, const char* word);
+
+/**************** manifest_numStopwords ****************/
+/* Return the number of words left out of the index, 0 if manifest is NULL. */
+int manifest_numStopwords(manifest_t* manifest);
+
+/**************** manifest_addSegment ****************/
+/* Add a segment holding numDocs pages, with docIDs between firstDocID
+ * and lastDocID, after the others, and raise the manifest's lastDocID
+ * to lastDocID.
+ *
+ * We return:
+ *   the new segment's number, or -1 if error.
+ */
+int manifest_addSegment(manifest_t* manifest, const int firstDocID,
+                        const int lastDocID, const int numDocs);
+
+/**************** manifest_numSegments ****************/
+/* Return the number of segments, or 0 if manifest is NULL. */
+int manifest_numSegments(manifest_t* manifest);
+
+/**************** manifest_getSegment ****************/
+/* Return the number of the i'th segment (0 is the oldest), or -1 if
+ * there is no such segment. */
+int manifest_getSegment(manifest_t* manifest, const int i);
+
+/**************** manifest_getRange ****************/
+/* Get the docIDs held by the i'th segment into *firstDocID and
+ * *lastDocID.
+ *
+ * We return:
+ *   true if there is such a segment, false otherwise.
+ */
+bool manifest_getRange(manifest_t* manifest, const int i,
+                       int* firstDocID, int* lastDocID);
+
+/**************** manifest_getNumDocs ****************/
+/* Return the number of pages indexed in the i'th segment, or 0 if
+ * there is no such segment. */
+int manifest_getNumDocs(manifest_t* manifest, const int i);
+
+/**************** manifest_replaceSegments ****************/
+/* Replace count segments, starting at the i'th, with one new segment
+ * holding all their docIDs, e.g. once they are merged into one file;
+ * the old segment files are not removed. The new segment has no
+ * tombstones: a merge leaves dead postings out.
+ *
+ * We return:
+ *   the new segment's number, or -1 if there are no such segments.
+ */
+int manifest_replaceSegments(manifest_t* manifest, const int i, const int count);
+
+/**************** manifest_deleteDoc ****************/
+/* Put a tombstone on docID in the base and every segment.
+ *
+ * We return:
+ *   true on success, false if manifest is NULL or out of memory.
+ */
+bool manifest_deleteDoc(manifest_t* manifest, const int docID);
+
+/**************** manifest_getDeleted ****************/
+/* Return the tombstones of segment number seg (0 for the base), or
+ * NULL if it has none; the bitmap belongs to the manifest. */
+bitmap_t* manifest_getDeleted(manifest_t* manifest, const int seg);
+
+/**************** manifest_clearSegments ****************/
+/* Forget every segment and tombstone, e.g. once the segments are folded
+ * into the base, leaving dead postings out; the segment files are not
+ * removed. We ignore NULL manifest. */
+void manifest_clearSegments(manifest_t* manifest);
+
+/**************** manifest_segmentName ****************/
+/* Return the filename of segment number seg of indexFilename,
+ * indexFilename.seg<seg>, in malloc'd memory, or NULL if error.
+ * Caller is responsible for freeing the name. */
+char* manifest_segmentName(const char* indexFilename, const int seg);
+
+/**************** manifest_shardName ****************/
+/* Return the filename of shard number shard (from 1) of indexFilename,
+ * indexFilename.shard<shard>, in malloc'd memory, or NULL if error.
+ * Caller is responsible for freeing the name. */
+char* manifest_shardName(const char* indexFilename, const int shard);
+
+/**************** manifest_dictName ****************/
+/* Return the filename of the term dictionary of indexFilename's base,
+ * indexFilename.dict, in malloc'd memory, or NULL if error.
+ * Caller is responsible for freeing the name. */
+char* manifest_dictName(const char* indexFilename);
+
+/**************** manifest_trigramName ****************/
+/* Return the filename of the trigram index of the term dictionary,
+ * indexFilename.trigram, in malloc'd memory, or NULL if error.
+ * Caller is responsible for freeing the name. */
+char* manifest_trigramName(const char* indexFilename);
+
+/**************** manifest_delete ****************/
+/* Delete the manifest (not the file); we ignore NULL manifest. */
+void manifest_delete(manifest_t* manifest);
+
+#endif // MANIFEST_H
@@ -0,0 +1,150 @@
+/*
+ * metrics.c - CS50 'metrics' module
+ *
+ * see metrics.h for more information.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "mem.h"
+#include "metrics.h"
+
+/**************** local constants ****************/
+//names in the JSON object, in the order of the enums in metrics.h
+static const char* STAGE_NAMES[METRICS_STAGES] = {
+  "fetch", "save", "extract", "normalize", "frontier", "print"
+};
+static const char* COUNTER_NAMES[METRICS_COUNTERS] = {
+  "pages", "bytes", "failures", "links", "external", "duplicates", "added", "dropped"
+};
+
+/**************** local types ****************/
+typedef struct metrics {
+  double start;                       // metrics_now() when created
+  double seconds[METRICS_STAGES];     // time spent in each stage
+  long counts[METRICS_COUNTERS];      // value of each counter
+} metrics_t;
+
+/**************** local functions ****************/
+static double ratio(const double part, const double whole);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** metrics_new ****************/
+/* see metrics.h for more information */
+metrics_t* metrics_new(void) {
+  metrics_t* metrics = mem_malloc(sizeof(metrics_t));
+  if (metrics == NULL) {
+    return NULL;
+  }
+  memset(metrics, 0, sizeof(metrics_t));
+  metrics->start = metrics_now();
+  return metrics;
+}
+
+/**************** metrics_now ****************/
+/* see metrics.h for more information */
+double metrics_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**************** metrics_time ****************/
+/* see metrics.h for more information */
+void metrics_time(metrics_t* metrics, const metricsStage_t stage,
+                  const double start, const double end) {
+  if (metrics != NULL && stage >= 0 && stage < METRICS_STAGES) {
+    metrics->seconds[stage] += end - start;
+  }
+}
+
+/**************** metrics_count ****************/
+/* see metrics.h for more information */
+void metrics_count(metrics_t* metrics, const metricsCounter_t counter, const long n) {
+  if (metrics != NULL && counter >= 0 && counter < METRICS_COUNTERS) {
+    metrics->counts[counter] += n;
+  }
+}
+
+/**************** metrics_get ****************/
+/* see metrics.h for more information */
+long metrics_get(metrics_t* metrics, const metricsCounter_t counter) {
+  if (metrics == NULL || counter < 0 || counter >= METRICS_COUNTERS) {
+    return 0;
+  }
+  return metrics->counts[counter];
+}
+
+/**************** metrics_print ****************/
+/* see metrics.h for more information */
+void metrics_print(metrics_t* metrics, FILE* fp, const bool done) {
+  if (metrics == NULL || fp == NULL) {
+    return;
+  }
+  long* counts = metrics->counts;
+  double elapsed = metrics_now() - metrics->start;
+  long internal = counts[METRICS_LINKS] - counts[METRICS_EXTERNAL];
+
+  fprintf(fp, "{\"elapsed\": %.3f, \"done\": %s", elapsed, done ? "true" : "false");
+  for (int i = 0; i < METRICS_COUNTERS; i++) {
+    fprintf(fp, ", \"%s\": %ld", COUNTER_NAMES[i], counts[i]);
+  }
+  fprintf(fp, ", \"pagesPerSecond\": %.3f", ratio(counts[METRICS_PAGES], elapsed));
+  fprintf(fp, ", \"bytesPerSecond\": %.1f", ratio(counts[METRICS_BYTES], elapsed));
+  fprintf(fp, ", \"externalRatio\": %.4f",
+          ratio(counts[METRICS_EXTERNAL], counts[METRICS_LINKS]));
+  fprintf(fp, ", \"duplicateRatio\": %.4f", ratio(counts[METRICS_DUPLICATES], internal));
+  fprintf(fp, ", \"stages\": {");
+  for (int i = 0; i < METRICS_STAGES; i++) {
+    fprintf(fp, "%s\"%s\": %.6f", (i == 0) ? "" : ", ", STAGE_NAMES[i],
+            metrics->seconds[i]);
+  }
+  fprintf(fp, "}}\n");
+}
+
+/**************** metrics_save ****************/
+/* see metrics.h for more information */
+bool metrics_save(metrics_t* metrics, const char* filename, const bool done) {
+  if (metrics == NULL || filename == NULL) {
+    return false;
+  }
+  char* tmpName = mem_malloc(strlen(filename) + strlen(".tmp") + 1);
+  if (tmpName == NULL) {
+    return false;
+  }
+  sprintf(tmpName, "%s.tmp", filename);
+  FILE* fp = fopen(tmpName, "w");
+  bool ok = (fp != NULL);
+  if (ok) {
+    metrics_print(metrics, fp, done);
+    ok = (fclose(fp) == 0 && rename(tmpName, filename) == 0);
+    if (!ok) {
+      remove(tmpName);
+    }
+  }
+  mem_free(tmpName);
+  return ok;
+}
+
+/**************** metrics_delete ****************/
+/* see metrics.h for more information */
+void metrics_delete(metrics_t* metrics) {
+  mem_free(metrics);
+}
+
+/**************** ratio ****************/
+/* Return part / whole, or 0 if whole isn't positive.
+ * not visible to outsiders, not in metrics.h
+ */
+static double ratio(const double part, const double whole) {
+  return (whole > 0) ? part / whole : 0;
+}
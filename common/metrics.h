@@ -0,0 +1,105 @@
+/*
+ * metrics.h - header file for CS50 'metrics' module
+ *
+ * metrics are what a crawl has done and where its time went: seconds
+ * spent in each stage of handling a page, and counters of pages, bytes
+ * and links. They are kept as plain additions, with the caller reading
+ * the clock (metrics_now) once per stage boundary, so they are cheap
+ * enough to keep on all the time, and written out as one JSON object:
+ *
+ *   {"elapsed": 12.5, "done": true,
+ *    "pages": 120, "bytes": 2048000, "pagesPerSecond": 9.6, ...,
+ *    "stages": {"fetch": 11.9, "extract": 0.2, ...}}
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct metrics metrics_t;  // opaque to users of the module
+
+//stages of handling a page, each timed on its own
+typedef enum metricsStage {
+  METRICS_FETCH,            // webpage_fetch: lookup, connect, transfer
+  METRICS_SAVE,             // pagedir_save
+  METRICS_EXTRACT,          // finding the next link in the html
+  METRICS_NORMALIZE,        // resolving and normalizing a link
+  METRICS_FRONTIER,         // visited set and frontier insert
+  METRICS_PRINT,            // the crawler's line per link, unless quiet
+  METRICS_STAGES            // number of stages, not a stage
+} metricsStage_t;
+
+//things counted during a crawl
+typedef enum metricsCounter {
+  METRICS_PAGES,            // pages fetched
+  METRICS_BYTES,            // bytes of html fetched
+  METRICS_FAILURES,         // fetches that failed
+  METRICS_LINKS,            // links found in pages
+  METRICS_EXTERNAL,         // ... of them external
+  METRICS_DUPLICATES,       // ... internal, already seen
+  METRICS_ADDED,            // ... internal, new, added to the frontier
+  METRICS_DROPPED,          // ... internal, new, frontier full
+  METRICS_COUNTERS          // number of counters, not a counter
+} metricsCounter_t;
+
+/**************** functions ****************/
+
+/**************** metrics_new ****************/
+/* Create new metrics, all zero, with the clock started now.
+ *
+ * We return:
+ *   pointer to new metrics, or NULL if error.
+ * Caller is responsible for:
+ *   later calling metrics_delete.
+ */
+metrics_t* metrics_new(void);
+
+/**************** metrics_now ****************/
+/* Return the time in seconds on a monotonic clock, for timing stages. */
+double metrics_now(void);
+
+/**************** metrics_time ****************/
+/* Add the seconds from start to end to stage; we ignore NULL metrics. */
+void metrics_time(metrics_t* metrics, const metricsStage_t stage,
+                  const double start, const double end);
+
+/**************** metrics_count ****************/
+/* Add n to counter; we ignore NULL metrics. */
+void metrics_count(metrics_t* metrics, const metricsCounter_t counter, const long n);
+
+/**************** metrics_get ****************/
+/* Return the counter's value, or 0 if metrics is NULL. */
+long metrics_get(metrics_t* metrics, const metricsCounter_t counter);
+
+/**************** metrics_print ****************/
+/* Print the metrics to fp as one JSON object, on one line.
+ *
+ * We guarantee:
+ *   besides every counter and stage, the object has the seconds elapsed
+ *   since metrics_new, pages and bytes per second over them, the share
+ *   of links that were external, and the share of internal links that
+ *   were duplicates (0 when there were none); "done" is as given.
+ */
+void metrics_print(metrics_t* metrics, FILE* fp, const bool done);
+
+/**************** metrics_save ****************/
+/* Write the metrics, as metrics_print does, to the named file, replacing
+ * it all at once (through filename.tmp), so that a reader never sees
+ * half a dump.
+ *
+ * We return:
+ *   true on success, false if a parameter is NULL or the file can't be
+ *   written.
+ */
+bool metrics_save(metrics_t* metrics, const char* filename, const bool done);
+
+/**************** metrics_delete ****************/
+/* Delete the metrics; we ignore NULL metrics. */
+void metrics_delete(metrics_t* metrics);
+
+#endif // METRICS_H
@@ -14,6 +14,7 @@
 #include <stdbool.h>
 #include "webpage.h"
 #include "file.h"
+#include "reader.h"
 
 /**************** pagedir_init() ****************/
 /* see pagedir.h for more information */
@@ -166,10 +167,35 @@ webpage_t* pagedir_load(const char* pageDirectory, const int docID) {
         free(pathname);
         return NULL; //exit nonzero if couldn't read file, per requirements spec
     } 
-    char* url = file_readLine(fp);
-    free(file_readLine(fp));
-    char* html = file_readFile(fp);
+    //read the whole file at once, then split off the url and depth lines
+    size_t textLen;
+    char* text = reader_readFile(fp, &textLen);
     fclose(fp);
     free(pathname);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    //url is the first line
+    char* urlEnd = memchr(text, '\n', textLen);
+    size_t urlLen = (urlEnd == NULL) ? textLen : (size_t)(urlEnd - text);
+    char* url = malloc(urlLen + 1);
+    if (url == NULL) {
+        free(text);
+        return NULL;
+    }
+    memcpy(url, text, urlLen);
+    url[urlLen] = '\0';
+
+    //skip the depth line; html is the rest, moved to the front of text
+    char* html = NULL;
+    char* depthEnd = (urlEnd == NULL) ? NULL : memchr(urlEnd + 1, '\n', text + textLen - urlEnd - 1);
+    if (depthEnd != NULL && depthEnd + 1 < text + textLen) {
+        size_t htmlLen = text + textLen - (depthEnd + 1);
+        memmove(text, depthEnd + 1, htmlLen + 1);
+        html = text;
+    } else {
+        free(text);
+    }
     return webpage_new(url, 0, html);
 }
\ No newline at end of file
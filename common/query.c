@@ -0,0 +1,1116 @@
+/*
+ * query.c - CS50 'query' module
+ *
+ * see query.h for more information.
+ *
+ * The parser is recursive descent, one function per rule of the
+ * grammar. An andseq in parentheses inside another andseq is spliced
+ * into it, and an 'or' into an 'or', as min and sum don't care how
+ * they are grouped; so the children of an 'and' are never 'and's.
+ *
+ * A plan is an array of steps, each a leaf (a word's postings as
+ * arrays, or a docset) or an 'and' or 'or' of steps, their children
+ * listed together in one array of step numbers. An 'and' lists its
+ * operands by increasing size, then its 'not' operands. It runs its
+ * first operand into the list of documents it will give, then narrows
+ * it in place by each other operand: walking a docset beside it,
+ * galloping through a word's postings, or running the operand into a
+ * buffer and walking both lists; a 'not' operand the same way, keeping
+ * what it doesn't have. The buffers form a stack, each run taking what
+ * it needs and giving it back before it returns.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "query.h"
+#include "index.h"
+#include "docset.h"
+#include "manifest.h"
+#include "word.h"
+
+/**************** local types ****************/
+typedef enum { NODE_WORD, NODE_AND, NODE_OR, NODE_NOT } nodeType_t;
+
+typedef struct node {
+  nodeType_t type;
+  int token;                // NODE_WORD: its place in the tokens
+  struct node* first;       // first child; a NODE_NOT has one
+  struct node* last;        // last child, to append after
+  struct node* next;        // next child of the same parent
+} node_t;
+
+typedef struct parser {
+  char** tokens;
+  int pos;                  // the next token
+  node_t* nodes;            // room for every node the tokens can make
+  int numNodes;
+  char* error;
+  size_t errorSize;
+} parser_t;
+
+typedef enum { STEP_EMPTY, STEP_LIST, STEP_DOCSET, STEP_AND, STEP_OR } stepType_t;
+
+typedef struct step {
+  stepType_t type;
+  int size;                 // the most documents it can match
+  const int* docIDs;        // STEP_LIST: a word's docIDs, increasing
+  const int* counts;        // STEP_LIST, STEP_DOCSET: the count of each
+  const docset_t* docs;     // STEP_DOCSET: the docIDs
+  int length;               // STEP_LIST: how many docIDs
+  bool owned;               // docIDs, counts and docs are ours to free
+  int first;                // STEP_AND, STEP_OR: its children in kids
+  int numChildren;
+  int numPositive;          // STEP_AND: the first numPositive aren't 'not'
+  int token;                // a word's step: its place in the tokens, else -1
+  int matched;              // last run: documents it gave, -1 if it wasn't run
+  int checked;              // last run: documents an 'and' checked against it, or -1
+  int kept;                 // and of those, how many it kept
+} step_t;
+
+typedef struct postings {
+  int* docIDs;
+  int* scores;
+  int count;
+  int capacity;
+} postings_t;
+
+/**************** global types ****************/
+struct query {
+  char** tokens;
+  node_t* nodes;            // the tree's nodes, one allocation
+  node_t* root;
+};
+
+struct plan {
+  step_t* steps;
+  int numSteps;
+  int stepCapacity;
+  int* kids;                // children of every step, by step number
+  int numKids;
+  int kidCapacity;
+  int root;
+  postings_t** buffers;     // each allocated once, so it stays put
+  int numBuffers;
+  int inUse;                // buffers[0..inUse) are taken
+  bool failed;              // out of memory since compiling or running began
+  planStats_t stats;        // since compiling began
+};
+
+//step number of a node true of every document (stop words)
+static const int DROPPED = -1;
+
+/**************** local functions ****************/
+/* not visible outside this file */
+static bool isToken(const char* token, const char* what);
+static bool isOperator(const char* token);
+static node_t* newNode(parser_t* p, const nodeType_t type);
+static void append(node_t* parent, node_t* child);
+static node_t* combine(parser_t* p, const nodeType_t type, node_t* left, node_t* right);
+static node_t* parseOr(parser_t* p);
+static node_t* parseAnd(parser_t* p);
+static node_t* parseUnary(parser_t* p);
+static node_t* parseOperand(parser_t* p);
+static int newStep(plan_t* plan, const stepType_t type);
+static int compileNode(plan_t* plan, query_t* query, node_t* node, index_t* index,
+                       manifest_t* manifest, const int maxExpansions);
+static int compileWord(plan_t* plan, query_t* query, const int token, index_t* index,
+                       manifest_t* manifest, const int maxExpansions);
+static int compileAnd(plan_t* plan, query_t* query, node_t* node, index_t* index,
+                      manifest_t* manifest, const int maxExpansions);
+static int compileOr(plan_t* plan, query_t* query, node_t* node, index_t* index,
+                     manifest_t* manifest, const int maxExpansions);
+static bool addKids(plan_t* plan, const int* kids, const int numKids);
+static void resetPlan(plan_t* plan);
+static postings_t* takeBuffer(plan_t* plan);
+static bool reserve(plan_t* plan, postings_t* p, const int n);
+static void runStep(plan_t* plan, const int s, postings_t* out);
+static int viewStep(plan_t* plan, const int s, postings_t* tmp,
+                    const int** docIDs, const int** scores);
+static void runAnd(plan_t* plan, step_t* step, postings_t* out);
+static void runOr(plan_t* plan, step_t* step, postings_t* out);
+static void appendDoc(void* arg, const int docID);
+static int gallop(const int* docIDs, int lo, const int n, const int target);
+static void explainStep(plan_t* plan, query_t* query, const int s, const int depth,
+                        const bool isNot, FILE* fp);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** query_tokens ****************/
+/* see query.h for more information */
+char** query_tokens(const char* line) {
+  if (line == NULL) {
+    return NULL;
+  }
+  //twice over the line: count the tokens, then copy them
+  char** tokens = NULL;
+  for (int pass = 0; pass < 2; pass++) {
+    int n = 0;
+    const char* p = line;
+    while (*p != '\0') {
+      if (*p == ' ') {
+        p++;
+        continue;
+      }
+      const char* start = p;
+      if (*p == '(' || *p == ')') {
+        p++;
+      } else {
+        while (*p != '\0' && *p != ' ' && *p != '(' && *p != ')') {
+          p++;
+        }
+      }
+      if (pass == 1) {
+        if ((tokens[n] = malloc(p - start + 1)) == NULL) {
+          freeWords(tokens);
+          return NULL;
+        }
+        memcpy(tokens[n], start, p - start);
+        tokens[n][p - start] = '\0';
+        tokens[n + 1] = NULL;
+      }
+      n++;
+    }
+    if (pass == 0) {
+      if ((tokens = malloc((n + 1) * sizeof(char*))) == NULL) {
+        return NULL;
+      }
+      tokens[0] = NULL;
+    }
+  }
+  return tokens;
+}
+
+/**************** query_new ****************/
+/* see query.h for more information */
+query_t* query_new(char** tokens, char* error, const size_t errorSize) {
+  if (tokens == NULL || error == NULL) {
+    return NULL;
+  }
+  int numTokens = 0;
+  while (tokens[numTokens] != NULL) {
+    numTokens++;
+  }
+  if (numTokens == 0) {
+    snprintf(error, errorSize, "Error: empty query");
+    return NULL;
+  }
+
+  //a node per word and 'not', and at most one 'and' or 'or' per word
+  //or parenthesized group
+  query_t* query = malloc(sizeof(query_t));
+  node_t* nodes = malloc(2 * numTokens * sizeof(node_t));
+  if (query == NULL || nodes == NULL) {
+    snprintf(error, errorSize, "Error: out of memory");
+    free(query);
+    free(nodes);
+    return NULL;
+  }
+  parser_t p = { tokens, 0, nodes, 0, error, errorSize };
+  node_t* root = parseOr(&p);
+  if (root != NULL && tokens[p.pos] != NULL) {
+    //parseOr stops early only at a ')'
+    snprintf(error, errorSize, "Error: unmatched ')'");
+    root = NULL;
+  }
+  if (root == NULL) {
+    free(query);
+    free(nodes);
+    return NULL;
+  }
+  query->tokens = tokens;
+  query->nodes = nodes;
+  query->root = root;
+  return query;
+}
+
+/**************** query_words ****************/
+/* see query.h for more information */
+char** query_words(query_t* query) {
+  return (query == NULL) ? NULL : query->tokens;
+}
+
+/**************** query_isWord ****************/
+/* see query.h for more information */
+bool query_isWord(const char* token) {
+  return !isOperator(token) && !isToken(token, "(") && !isToken(token, ")");
+}
+
+/**************** query_isPrefix ****************/
+/* see query.h for more information */
+bool query_isPrefix(const char* token) {
+  size_t len = strlen(token);
+  return len > 0 && token[len - 1] == '*';
+}
+
+/**************** query_delete ****************/
+/* see query.h for more information */
+void query_delete(query_t* query) {
+  if (query != NULL) {
+    freeWords(query->tokens);
+    free(query->nodes);
+    free(query);
+  }
+}
+
+/**************** plan_new ****************/
+/* see query.h for more information */
+plan_t* plan_new(void) {
+  plan_t* plan = calloc(1, sizeof(plan_t));
+  if (plan != NULL) {
+    plan->root = DROPPED;
+  }
+  return plan;
+}
+
+/**************** plan_compile ****************/
+/* see query.h for more information */
+bool plan_compile(plan_t* plan, query_t* query, index_t* index, manifest_t* manifest,
+                  const int maxExpansions) {
+  if (plan == NULL || query == NULL || index == NULL) {
+    return false;
+  }
+  resetPlan(plan);
+  plan->failed = false;
+  memset(&plan->stats, 0, sizeof(planStats_t));
+  plan->root = compileNode(plan, query, query->root, index, manifest, maxExpansions);
+  if (plan->root == DROPPED && !plan->failed) {
+    //nothing but stop words
+    plan->root = newStep(plan, STEP_EMPTY);
+  }
+  if (plan->failed) {
+    resetPlan(plan);
+    return false;
+  }
+  return true;
+}
+
+/**************** plan_run ****************/
+/* see query.h for more information */
+int plan_run(plan_t* plan, void* arg,
+             void (*itemfunc)(void* arg, const int docID, const int score)) {
+  if (plan == NULL || plan->root == DROPPED) {
+    return (plan == NULL) ? -1 : 0;
+  }
+  plan->failed = false;
+  plan->inUse = 0;
+  for (int i = 0; i < plan->numSteps; i++) {
+    plan->steps[i].matched = -1;
+    plan->steps[i].checked = -1;
+  }
+  postings_t* out = takeBuffer(plan);
+  if (out == NULL) {
+    return -1;
+  }
+  runStep(plan, plan->root, out);
+  plan->inUse--;
+  if (plan->failed) {
+    return -1;
+  }
+  if (itemfunc != NULL) {
+    for (int i = 0; i < out->count; i++) {
+      (*itemfunc)(arg, out->docIDs[i], out->scores[i]);
+    }
+  }
+  return out->count;
+}
+
+/**************** plan_stats ****************/
+/* see query.h for more information */
+void plan_stats(plan_t* plan, planStats_t* stats) {
+  if (plan != NULL && stats != NULL) {
+    *stats = plan->stats;
+  }
+}
+
+/**************** plan_explain ****************/
+/* see query.h for more information */
+void plan_explain(plan_t* plan, query_t* query, FILE* fp) {
+  if (plan == NULL || query == NULL || fp == NULL || plan->root == DROPPED) {
+    return;
+  }
+  explainStep(plan, query, plan->root, 1, false, fp);
+}
+
+/**************** plan_delete ****************/
+/* see query.h for more information */
+void plan_delete(plan_t* plan) {
+  if (plan != NULL) {
+    resetPlan(plan);
+    for (int i = 0; i < plan->numBuffers; i++) {
+      free(plan->buffers[i]->docIDs);
+      free(plan->buffers[i]->scores);
+      free(plan->buffers[i]);
+    }
+    free(plan->buffers);
+    free(plan->steps);
+    free(plan->kids);
+    free(plan);
+  }
+}
+
+/**************** isToken ****************/
+/* true if token is what
+ * not visible to outsiders, not in query.h
+ */
+static bool isToken(const char* token, const char* what) {
+  return token != NULL && strcmp(token, what) == 0;
+}
+
+/**************** isOperator ****************/
+/* true if token is 'and', 'or' or 'not'
+ * not visible to outsiders, not in query.h
+ */
+static bool isOperator(const char* token) {
+  return isToken(token, "and") || isToken(token, "or") || isToken(token, "not");
+}
+
+/**************** newNode ****************/
+/* a new node, with no children, from the parser's room for them
+ * not visible to outsiders, not in query.h
+ */
+static node_t* newNode(parser_t* p, const nodeType_t type) {
+  node_t* node = &p->nodes[p->numNodes++];
+  node->type = type;
+  node->token = -1;
+  node->first = NULL;
+  node->last = NULL;
+  node->next = NULL;
+  return node;
+}
+
+/**************** append ****************/
+/* make child the last child of parent
+ * not visible to outsiders, not in query.h
+ */
+static void append(node_t* parent, node_t* child) {
+  if (parent->last == NULL) {
+    parent->first = child;
+  } else {
+    parent->last->next = child;
+  }
+  parent->last = child;
+}
+
+/**************** combine ****************/
+/* an 'and' or 'or' (type) of left and right; either that already is
+ * one has its children spliced in instead
+ * not visible to outsiders, not in query.h
+ */
+static node_t* combine(parser_t* p, const nodeType_t type, node_t* left, node_t* right) {
+  node_t* parent = left;
+  if (left->type != type) {
+    parent = newNode(p, type);
+    append(parent, left);
+  }
+  if (right->type == type) {
+    parent->last->next = right->first;
+    parent->last = right->last;
+  } else {
+    append(parent, right);
+  }
+  return parent;
+}
+
+/**************** parseOr ****************/
+/* query ::= andseq { 'or' andseq }
+ * not visible to outsiders, not in query.h
+ */
+static node_t* parseOr(parser_t* p) {
+  node_t* node = parseAnd(p);
+  while (node != NULL && isToken(p->tokens[p->pos], "or")) {
+    p->pos++;
+    node_t* right = parseAnd(p);
+    node = (right == NULL) ? NULL : combine(p, NODE_OR, node, right);
+  }
+  return node;
+}
+
+/**************** parseAnd ****************/
+/* andseq ::= unary { [ 'and' ] unary }, with an operand not under 'not'
+ * not visible to outsiders, not in query.h
+ */
+static node_t* parseAnd(parser_t* p) {
+  node_t* node = parseUnary(p);
+  while (node != NULL && p->tokens[p->pos] != NULL
+         && !isToken(p->tokens[p->pos], "or") && !isToken(p->tokens[p->pos], ")")) {
+    if (isToken(p->tokens[p->pos], "and")) {
+      p->pos++;
+    }
+    node_t* right = parseUnary(p);
+    node = (right == NULL) ? NULL : combine(p, NODE_AND, node, right);
+  }
+  if (node == NULL) {
+    return NULL;
+  }
+  bool positive = (node->type != NODE_NOT);
+  if (node->type == NODE_AND) {
+    positive = false;
+    for (node_t* child = node->first; child != NULL; child = child->next) {
+      positive = positive || (child->type != NODE_NOT);
+    }
+  }
+  if (!positive) {
+    snprintf(p->error, p->errorSize, "Error: nothing for 'not' to exclude from");
+    return NULL;
+  }
+  return node;
+}
+
+/**************** parseUnary ****************/
+/* unary ::= [ 'not' ] operand
+ * not visible to outsiders, not in query.h
+ */
+static node_t* parseUnary(parser_t* p) {
+  if (!isToken(p->tokens[p->pos], "not")) {
+    return parseOperand(p);
+  }
+  p->pos++;
+  node_t* operand = parseOperand(p);
+  if (operand == NULL) {
+    return NULL;
+  }
+  node_t* node = newNode(p, NODE_NOT);
+  append(node, operand);
+  return node;
+}
+
+/**************** parseOperand ****************/
+/* operand ::= word | prefix* | '(' query ')'; the errors for 'and' and
+ * 'or' out of place are those the querier always gave
+ * not visible to outsiders, not in query.h
+ */
+static node_t* parseOperand(parser_t* p) {
+  char* token = p->tokens[p->pos];
+  char* prev = (p->pos == 0) ? NULL : p->tokens[p->pos - 1];
+  if (token == NULL) {
+    if (isToken(prev, "(")) {
+      snprintf(p->error, p->errorSize, "Error: unmatched '('");
+    } else {
+      snprintf(p->error, p->errorSize, "Error: '%s' cannot be last", prev);
+    }
+    return NULL;
+  }
+  if (isOperator(token)) {
+    if (prev == NULL) {
+      snprintf(p->error, p->errorSize, "Error: '%s' cannot be first", token);
+    } else if (isToken(prev, "(")) {
+      snprintf(p->error, p->errorSize, "Error: '%s' cannot follow '('", token);
+    } else {
+      snprintf(p->error, p->errorSize, "Error: '%s' and '%s' cannot be adjacent", prev, token);
+    }
+    return NULL;
+  }
+  if (isToken(token, ")")) {
+    if (prev == NULL) {
+      snprintf(p->error, p->errorSize, "Error: unmatched ')'");
+    } else if (isToken(prev, "(")) {
+      snprintf(p->error, p->errorSize, "Error: empty parentheses");
+    } else {
+      snprintf(p->error, p->errorSize, "Error: '%s' cannot come before ')'", prev);
+    }
+    return NULL;
+  }
+  p->pos++;
+  if (isToken(token, "(")) {
+    node_t* node = parseOr(p);
+    if (node != NULL && !isToken(p->tokens[p->pos], ")")) {
+      snprintf(p->error, p->errorSize, "Error: unmatched '('");
+      return NULL;
+    }
+    p->pos++;
+    return node;
+  }
+  node_t* node = newNode(p, NODE_WORD);
+  node->token = p->pos - 1;
+  return node;
+}
+
+/**************** newStep ****************/
+/* number of a new step of type, size 0 and no children; sets failed,
+ * and returns DROPPED, if out of memory
+ * not visible to outsiders, not in query.h
+ */
+static int newStep(plan_t* plan, const stepType_t type) {
+  if (plan->numSteps == plan->stepCapacity) {
+    int capacity = (plan->stepCapacity == 0) ? 16 : plan->stepCapacity * 2;
+    step_t* steps = realloc(plan->steps, capacity * sizeof(step_t));
+    if (steps == NULL) {
+      plan->failed = true;
+      return DROPPED;
+    }
+    plan->steps = steps;
+    plan->stepCapacity = capacity;
+    plan->stats.allocations++;
+  }
+  step_t* step = &plan->steps[plan->numSteps];
+  memset(step, 0, sizeof(step_t));
+  step->type = type;
+  step->token = -1;
+  step->matched = -1;
+  step->checked = -1;
+  return plan->numSteps++;
+}
+
+/**************** compileNode ****************/
+/* the step for node, or DROPPED if it is true of every document
+ * not visible to outsiders, not in query.h
+ */
+static int compileNode(plan_t* plan, query_t* query, node_t* node, index_t* index,
+                       manifest_t* manifest, const int maxExpansions) {
+  switch (node->type) {
+    case NODE_WORD:
+      return compileWord(plan, query, node->token, index, manifest, maxExpansions);
+    case NODE_AND:
+      return compileAnd(plan, query, node, index, manifest, maxExpansions);
+    case NODE_OR:
+      return compileOr(plan, query, node, index, manifest, maxExpansions);
+    default:
+      //a 'not' is compiled by the 'and' it is in
+      return DROPPED;
+  }
+}
+
+/**************** compileWord ****************/
+/* the step for a word or prefix: DROPPED for a stop word, an empty step
+ * if no document has it, a borrowed docset for a common word, and
+ * otherwise the postings as arrays, merged across segments
+ * not visible to outsiders, not in query.h
+ */
+static int compileWord(plan_t* plan, query_t* query, const int token, index_t* index,
+                       manifest_t* manifest, const int maxExpansions) {
+  char* word = query->tokens[token];
+  if (manifest_isStopword(manifest, word)) {
+    return DROPPED;
+  }
+  const docset_t* docs = NULL;
+  const int* counts = NULL;
+  int* docIDs = NULL;
+  int length = 0;
+  bool owned = false;
+  if (query_isPrefix(word)) {
+    size_t len = strlen(word);
+    int numWords = 0;
+    int* sums = NULL;
+    word[len - 1] = '\0';
+    docs = index_prefixDocSet(index, word, maxExpansions, &sums, &numWords);
+    if (numWords > maxExpansions) {
+      fprintf(stderr, "Note: '%s*' matches %d words, searching the first %d\n",
+              word, numWords, maxExpansions);
+    }
+    word[len - 1] = '*';
+    counts = sums;
+    owned = true;
+  } else if ((docs = index_docSet(index, word, &counts)) == NULL) {
+    int* wordCounts = NULL;
+    if ((length = index_postingArray(index, word, &docIDs, &wordCounts)) < 0) {
+      plan->failed = true;
+      return DROPPED;
+    }
+    counts = wordCounts;
+    owned = true;
+  }
+
+  int s = newStep(plan, (docs != NULL) ? STEP_DOCSET : (length > 0) ? STEP_LIST : STEP_EMPTY);
+  if (s == DROPPED) {
+    if (owned) {
+      docset_delete((docset_t*)docs);
+      free(docIDs);
+      free((int*)counts);
+    }
+    return DROPPED;
+  }
+  step_t* step = &plan->steps[s];
+  step->docs = docs;
+  step->docIDs = docIDs;
+  step->counts = counts;
+  step->length = length;
+  step->owned = owned;
+  step->size = (docs != NULL) ? docset_size(docs) : length;
+  step->token = token;
+  plan->stats.postings += step->size;
+  plan->stats.allocations += owned ? 2 : 0;
+  return s;
+}
+
+/**************** compileAnd ****************/
+/* the step for an andseq: its operands, but for stop words, smallest
+ * first, then its 'not' operands, largest first, but for those no
+ * document has. An
+ * empty operand, or a 'not' of a stop word, makes it empty; left with
+ * no operand it is DROPPED, or empty if it had 'not' operands.
+ * not visible to outsiders, not in query.h
+ */
+static int compileAnd(plan_t* plan, query_t* query, node_t* node, index_t* index,
+                      manifest_t* manifest, const int maxExpansions) {
+  int numChildren = 0;
+  for (node_t* child = node->first; child != NULL; child = child->next) {
+    numChildren++;
+  }
+  int* kids = malloc(numChildren * sizeof(int));
+  plan->stats.allocations++;
+  if (kids == NULL) {
+    plan->failed = true;
+    return DROPPED;
+  }
+  //operands fill kids from the front, 'not' operands from the back
+  int numPositive = 0;
+  int numNegative = 0;
+  bool hasNot = false;
+  bool empty = false;
+  for (node_t* child = node->first; child != NULL && !plan->failed; child = child->next) {
+    bool isNot = (child->type == NODE_NOT);
+    int s = compileNode(plan, query, isNot ? child->first : child, index, manifest,
+                        maxExpansions);
+    if (plan->failed) {
+      break;
+    }
+    hasNot = hasNot || isNot;
+    if (s == DROPPED) {
+      empty = empty || isNot;
+    } else if (plan->steps[s].type == STEP_EMPTY) {
+      empty = empty || !isNot;
+    } else if (isNot) {
+      //insertion sort by decreasing size, so the most is taken away first
+      int i = numChildren - ++numNegative;
+      while (i + 1 < numChildren && plan->steps[kids[i + 1]].size > plan->steps[s].size) {
+        kids[i] = kids[i + 1];
+        i++;
+      }
+      kids[i] = s;
+    } else {
+      //insertion sort by size
+      int i = numPositive++;
+      while (i > 0 && plan->steps[kids[i - 1]].size > plan->steps[s].size) {
+        kids[i] = kids[i - 1];
+        i--;
+      }
+      kids[i] = s;
+    }
+  }
+
+  int s = DROPPED;
+  if (plan->failed) {
+    s = DROPPED;
+  } else if (!empty && numPositive == 0 && !hasNot) {
+    s = DROPPED;
+  } else if (empty || numPositive == 0) {
+    s = newStep(plan, STEP_EMPTY);
+  } else if (numPositive == 1 && numNegative == 0) {
+    s = kids[0];
+  } else {
+    memmove(kids + numPositive, kids + numChildren - numNegative, numNegative * sizeof(int));
+    int first = plan->numKids;
+    if (addKids(plan, kids, numPositive + numNegative)
+        && (s = newStep(plan, STEP_AND)) != DROPPED) {
+      step_t* step = &plan->steps[s];
+      step->first = first;
+      step->numChildren = numPositive + numNegative;
+      step->numPositive = numPositive;
+      step->size = plan->steps[kids[0]].size;
+    }
+  }
+  free(kids);
+  return s;
+}
+
+/**************** compileOr ****************/
+/* the step for an 'or': its operands but for empty and DROPPED ones
+ * (andseqs of stop words); empty if none is left
+ * not visible to outsiders, not in query.h
+ */
+static int compileOr(plan_t* plan, query_t* query, node_t* node, index_t* index,
+                     manifest_t* manifest, const int maxExpansions) {
+  int numChildren = 0;
+  for (node_t* child = node->first; child != NULL; child = child->next) {
+    numChildren++;
+  }
+  int* kids = malloc(numChildren * sizeof(int));
+  plan->stats.allocations++;
+  if (kids == NULL) {
+    plan->failed = true;
+    return DROPPED;
+  }
+  int numKids = 0;
+  int size = 0;
+  for (node_t* child = node->first; child != NULL && !plan->failed; child = child->next) {
+    int s = compileNode(plan, query, child, index, manifest, maxExpansions);
+    if (s != DROPPED && plan->steps[s].type != STEP_EMPTY) {
+      kids[numKids++] = s;
+      size += plan->steps[s].size;
+    }
+  }
+
+  int s = DROPPED;
+  if (plan->failed) {
+    s = DROPPED;
+  } else if (numKids == 0) {
+    s = newStep(plan, STEP_EMPTY);
+  } else if (numKids == 1) {
+    s = kids[0];
+  } else {
+    int first = plan->numKids;
+    if (addKids(plan, kids, numKids) && (s = newStep(plan, STEP_OR)) != DROPPED) {
+      step_t* step = &plan->steps[s];
+      step->first = first;
+      step->numChildren = numKids;
+      step->size = size;
+    }
+  }
+  free(kids);
+  return s;
+}
+
+/**************** addKids ****************/
+/* append step numbers to the plan's children; false if out of memory
+ * not visible to outsiders, not in query.h
+ */
+static bool addKids(plan_t* plan, const int* kids, const int numKids) {
+  if (plan->numKids + numKids > plan->kidCapacity) {
+    int capacity = (plan->kidCapacity == 0) ? 32 : plan->kidCapacity * 2;
+    while (capacity < plan->numKids + numKids) {
+      capacity *= 2;
+    }
+    int* grown = realloc(plan->kids, capacity * sizeof(int));
+    if (grown == NULL) {
+      plan->failed = true;
+      return false;
+    }
+    plan->kids = grown;
+    plan->kidCapacity = capacity;
+    plan->stats.allocations++;
+  }
+  memcpy(plan->kids + plan->numKids, kids, numKids * sizeof(int));
+  plan->numKids += numKids;
+  return true;
+}
+
+/**************** resetPlan ****************/
+/* free what the plan's steps own, and empty it; keeps the buffers
+ * not visible to outsiders, not in query.h
+ */
+static void resetPlan(plan_t* plan) {
+  for (int i = 0; i < plan->numSteps; i++) {
+    step_t* step = &plan->steps[i];
+    if (step->owned) {
+      docset_delete((docset_t*)step->docs);
+      free((int*)step->docIDs);
+      free((int*)step->counts);
+    }
+  }
+  plan->numSteps = 0;
+  plan->numKids = 0;
+  plan->root = DROPPED;
+}
+
+/**************** takeBuffer ****************/
+/* the next buffer of the stack, emptied, or NULL (and failed set) if
+ * out of memory; give it back with plan->inUse--
+ * not visible to outsiders, not in query.h
+ */
+static postings_t* takeBuffer(plan_t* plan) {
+  if (plan->inUse == plan->numBuffers) {
+    postings_t** buffers = realloc(plan->buffers, (plan->numBuffers + 1) * sizeof(postings_t*));
+    if (buffers == NULL) {
+      plan->failed = true;
+      return NULL;
+    }
+    plan->buffers = buffers;
+    plan->stats.allocations += 2;
+    if ((buffers[plan->numBuffers] = calloc(1, sizeof(postings_t))) == NULL) {
+      plan->failed = true;
+      return NULL;
+    }
+    plan->numBuffers++;
+  }
+  postings_t* p = plan->buffers[plan->inUse++];
+  p->count = 0;
+  return p;
+}
+
+/**************** reserve ****************/
+/* make room for n documents in p; false (and failed set) if out of memory
+ * not visible to outsiders, not in query.h
+ */
+static bool reserve(plan_t* plan, postings_t* p, const int n) {
+  if (n <= p->capacity) {
+    return true;
+  }
+  int capacity = (p->capacity * 2 > n) ? p->capacity * 2 : n;
+  plan->stats.allocations += 2;
+  int* docIDs = realloc(p->docIDs, capacity * sizeof(int));
+  if (docIDs != NULL) {
+    p->docIDs = docIDs;
+  }
+  int* scores = realloc(p->scores, capacity * sizeof(int));
+  if (scores != NULL) {
+    p->scores = scores;
+  }
+  if (docIDs == NULL || scores == NULL) {
+    plan->failed = true;
+    p->count = 0;
+    return false;
+  }
+  p->capacity = capacity;
+  return true;
+}
+
+/**************** runStep ****************/
+/* put the documents step s matches, and their scores, in out
+ * not visible to outsiders, not in query.h
+ */
+static void runStep(plan_t* plan, const int s, postings_t* out) {
+  step_t* step = &plan->steps[s];
+  out->count = 0;
+  switch (step->type) {
+    case STEP_LIST:
+      if (reserve(plan, out, step->length)) {
+        memcpy(out->docIDs, step->docIDs, step->length * sizeof(int));
+        memcpy(out->scores, step->counts, step->length * sizeof(int));
+        out->count = step->length;
+      }
+      break;
+    case STEP_DOCSET:
+      if (reserve(plan, out, step->size)) {
+        docset_iterate(step->docs, out, appendDoc);
+        memcpy(out->scores, step->counts, out->count * sizeof(int));
+      }
+      break;
+    case STEP_AND:
+      runAnd(plan, step, out);
+      break;
+    case STEP_OR:
+      runOr(plan, step, out);
+      break;
+    default:
+      break;
+  }
+  step->matched = out->count;
+  if (step->type == STEP_LIST || step->type == STEP_DOCSET) {
+    plan->stats.documents += out->count;
+  }
+}
+
+/**************** viewStep ****************/
+/* point *docIDs and *scores at the documents step s matches, and return
+ * how many: a word's own postings, or what running it put in tmp
+ * not visible to outsiders, not in query.h
+ */
+static int viewStep(plan_t* plan, const int s, postings_t* tmp,
+                    const int** docIDs, const int** scores) {
+  step_t* step = &plan->steps[s];
+  if (step->type == STEP_LIST) {
+    *docIDs = step->docIDs;
+    *scores = step->counts;
+    step->matched = step->length;
+    plan->stats.documents += step->length;
+    return step->length;
+  }
+  runStep(plan, s, tmp);
+  *docIDs = tmp->docIDs;
+  *scores = tmp->scores;
+  return tmp->count;
+}
+
+/**************** runAnd ****************/
+/* run the first operand into out, then keep the documents each other
+ * operand has, at the lower score, and those no 'not' operand has
+ * not visible to outsiders, not in query.h
+ */
+static void runAnd(plan_t* plan, step_t* step, postings_t* out) {
+  const int* kids = plan->kids + step->first;
+  runStep(plan, kids[0], out);
+  for (int k = 1; k < step->numChildren && out->count > 0; k++) {
+    step_t* child = &plan->steps[kids[k]];
+    bool isNot = (k >= step->numPositive);
+    int kept = 0;
+    child->checked = out->count;
+    plan->stats.documents += out->count;
+    if (child->type == STEP_DOCSET) {
+      //look every document left up in the docset, in one pass over both
+      postings_t* places = takeBuffer(plan);
+      if (places == NULL || !reserve(plan, places, out->count)) {
+        plan->inUse -= (places != NULL);
+        out->count = 0;
+        return;
+      }
+      docset_indexes(child->docs, out->docIDs, out->count, places->docIDs);
+      for (int i = 0; i < out->count; i++) {
+        int j = places->docIDs[i];
+        if (isNot ? j < 0 : j >= 0) {
+          out->docIDs[kept] = out->docIDs[i];
+          out->scores[kept] = out->scores[i];
+          if (!isNot && child->counts[j] < out->scores[kept]) {
+            out->scores[kept] = child->counts[j];
+          }
+          kept++;
+        }
+      }
+      out->count = kept;
+      child->kept = kept;
+      plan->inUse--;
+      continue;
+    }
+
+    //walk the operand's documents, galloping past those out hasn't
+    postings_t* tmp = takeBuffer(plan);
+    if (tmp == NULL) {
+      out->count = 0;
+      return;
+    }
+    const int* docIDs = NULL;
+    const int* scores = NULL;
+    int n = viewStep(plan, kids[k], tmp, &docIDs, &scores);
+    int j = 0;
+    for (int i = 0; i < out->count; i++) {
+      if (j < n) {
+        j = gallop(docIDs, j, n, out->docIDs[i]);
+      }
+      bool found = (j < n && docIDs[j] == out->docIDs[i]);
+      if (isNot ? !found : found) {
+        out->docIDs[kept] = out->docIDs[i];
+        out->scores[kept] = out->scores[i];
+        if (!isNot && scores[j] < out->scores[kept]) {
+          out->scores[kept] = scores[j];
+        }
+        kept++;
+      } else if (!isNot && j == n) {
+        break;
+      }
+    }
+    out->count = kept;
+    child->kept = kept;
+    plan->inUse--;
+  }
+  if (plan->failed) {
+    out->count = 0;
+  }
+}
+
+/**************** runOr ****************/
+/* unite the operands' documents, a document scoring the sum of its
+ * scores, merging each operand into out through a second buffer
+ * not visible to outsiders, not in query.h
+ */
+static void runOr(plan_t* plan, step_t* step, postings_t* out) {
+  const int* kids = plan->kids + step->first;
+  runStep(plan, kids[0], out);
+  for (int k = 1; k < step->numChildren && !plan->failed; k++) {
+    postings_t* tmp = takeBuffer(plan);
+    if (tmp == NULL) {
+      break;
+    }
+    const int* docIDs = NULL;
+    const int* scores = NULL;
+    int n = viewStep(plan, kids[k], tmp, &docIDs, &scores);
+    postings_t* merged = takeBuffer(plan);
+    if (merged != NULL && reserve(plan, merged, out->count + n)) {
+      int i = 0;
+      int j = 0;
+      while (i < out->count || j < n) {
+        int m = merged->count++;
+        if (j == n || (i < out->count && out->docIDs[i] < docIDs[j])) {
+          merged->docIDs[m] = out->docIDs[i];
+          merged->scores[m] = out->scores[i++];
+        } else if (i == out->count || docIDs[j] < out->docIDs[i]) {
+          merged->docIDs[m] = docIDs[j];
+          merged->scores[m] = scores[j++];
+        } else {
+          merged->docIDs[m] = docIDs[j];
+          merged->scores[m] = out->scores[i++] + scores[j++];
+        }
+      }
+      //out takes merged's arrays, merged keeps out's for next time
+      postings_t swap = *out;
+      *out = *merged;
+      *merged = swap;
+    }
+    plan->inUse -= (merged != NULL) ? 2 : 1;
+  }
+  if (plan->failed) {
+    out->count = 0;
+  }
+}
+
+/**************** appendDoc ****************/
+/* docset_iterate helper: append a docID to the postings in arg, which
+ * have room for it
+ * not visible to outsiders, not in query.h
+ */
+static void appendDoc(void* arg, const int docID) {
+  postings_t* p = arg;
+  p->docIDs[p->count++] = docID;
+}
+
+/**************** gallop ****************/
+/* the first place from lo where docIDs[0..n) has target or more, found
+ * by doubling steps then binary search, so skipping far costs little
+ * not visible to outsiders, not in query.h
+ */
+static int gallop(const int* docIDs, int lo, const int n, const int target) {
+  int hi = lo;
+  int step = 1;
+  while (hi < n && docIDs[hi] < target) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  if (hi > n) {
+    hi = n;
+  }
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (docIDs[mid] < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**************** explainStep ****************/
+/* print step s, indented by depth, then its children one deeper
+ * not visible to outsiders, not in query.h
+ */
+static void explainStep(plan_t* plan, query_t* query, const int s, const int depth,
+                        const bool isNot, FILE* fp) {
+  step_t* step = &plan->steps[s];
+  const char* word = (step->token < 0) ? "" : query->tokens[step->token];
+  fprintf(fp, "%*s%s", 2 * depth, "", isNot ? "not " : "");
+  switch (step->type) {
+    case STEP_LIST:
+      fprintf(fp, "'%s': %d postings", word, step->length);
+      break;
+    case STEP_DOCSET:
+      fprintf(fp, "'%s': docset of %d", word, step->size);
+      break;
+    case STEP_AND:
+      fprintf(fp, "and, at most %d", step->size);
+      break;
+    case STEP_OR:
+      fprintf(fp, "or, at most %d", step->size);
+      break;
+    default:
+      fprintf(fp, (step->token < 0) ? "nothing" : "'%s': nothing", word);
+      break;
+  }
+  if (step->matched >= 0) {
+    fprintf(fp, ", gave %d", step->matched);
+  }
+  if (step->checked >= 0) {
+    fprintf(fp, ", checked %d, kept %d", step->checked, step->kept);
+  }
+  if (step->matched < 0 && step->checked < 0 && step->type != STEP_EMPTY) {
+    fprintf(fp, ", not reached");
+  }
+  fprintf(fp, "\n");
+  for (int k = 0; k < step->numChildren; k++) {
+    bool childNot = (step->type == STEP_AND && k >= step->numPositive);
+    explainStep(plan, query, plan->kids[step->first + k], depth + 1, childNot, fp);
+  }
+}
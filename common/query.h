@@ -0,0 +1,164 @@
+/*
+ * query.h - header file for CS50 'query' module
+ *
+ * a query is a parsed search: its words, and the tree of 'and', 'or'
+ * and 'not' over them that the grammar below gives, where 'and' binds
+ * tighter than 'or', and 'and' between two words may be left out:
+ *
+ *   query    ::= andseq { 'or' andseq }
+ *   andseq   ::= unary { [ 'and' ] unary }
+ *   unary    ::= [ 'not' ] operand
+ *   operand  ::= word | prefix* | '(' query ')'
+ *
+ * A document matches a word if it has it, scoring its count; a prefix
+ * ("crawl*") if it has any word starting with it, scoring the sum of
+ * their counts. It matches an andseq if it matches all of its operands
+ * and none of its 'not' operands, scoring the lowest of the scores,
+ * and an 'or' of andseqs if it matches any, scoring the sum of theirs.
+ * Every andseq needs an operand without 'not', the documents the
+ * others are taken away from.
+ *
+ * A plan is a query compiled against an index: each word's postings
+ * looked up, the operands of each andseq in increasing order of how
+ * many documents they can match, so the smallest decides how many
+ * documents the others are checked for. Running a plan goes through
+ * the tree once, holding each list of documents as arrays in docID
+ * order, in buffers the plan keeps and reuses from query to query.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "index.h"
+#include "manifest.h"
+
+/**************** global types ****************/
+typedef struct query query_t;  // opaque to users of the module
+typedef struct plan plan_t;    // opaque to users of the module
+
+//what compiling and running a plan took, see plan_stats
+typedef struct planStats {
+  int postings;             // postings (and docset members) of its words
+  int documents;            // documents given by words, or checked by 'and's
+  int allocations;          // mallocs and reallocs, by the plan and for its words
+} planStats_t;
+
+/**************** functions ****************/
+
+/**************** query_tokens ****************/
+/* Split a line into the tokens of a query: words separated by spaces,
+ * with '(' and ')' tokens of their own, wherever they are.
+ *
+ * We return:
+ *   a NULL-terminated array of malloc'd strings, as splitWords does
+ *   (see word.h), which may be empty; NULL if line is NULL or error.
+ * Caller is responsible for:
+ *   later calling freeWords, or passing the array to query_new.
+ */
+char** query_tokens(const char* line);
+
+/**************** query_new ****************/
+/* Parse tokens into a query.
+ *
+ * Caller provides:
+ *   a NULL-terminated array of tokens (see query_tokens), at least one,
+ *   lowercase; and a buffer for an error message, and its size.
+ * We return:
+ *   pointer to a new query, which takes over the tokens; or NULL, with
+ *   a message starting "Error: " in error, if the tokens don't follow
+ *   the grammar (or out of memory), the tokens still the caller's.
+ * Notes:
+ *   any token but 'and', 'or', 'not', '(' and ')' is a word here; the
+ *   caller checks the characters of words.
+ * Caller is responsible for:
+ *   later calling query_delete.
+ */
+query_t* query_new(char** tokens, char* error, const size_t errorSize);
+
+/**************** query_words ****************/
+/* Return the query's tokens, a NULL-terminated array. The caller may
+ * replace a word token with another malloc'd word, freeing the old one,
+ * but must not change operators or the order of the tokens. */
+char** query_words(query_t* query);
+
+/**************** query_isWord ****************/
+/* Return true if token is a word or prefix, not 'and', 'or', 'not',
+ * '(' or ')'. */
+bool query_isWord(const char* token);
+
+/**************** query_isPrefix ****************/
+/* Return true if token is a prefix, a word ending in '*'. */
+bool query_isPrefix(const char* token);
+
+/**************** query_delete ****************/
+/* Delete the query and its tokens; we ignore NULL query. */
+void query_delete(query_t* query);
+
+/**************** plan_new ****************/
+/* Create a new (empty) plan, to compile queries into.
+ *
+ * We return:
+ *   pointer to a new plan, or NULL if error.
+ * Caller is responsible for:
+ *   later calling plan_delete.
+ */
+plan_t* plan_new(void);
+
+/**************** plan_compile ****************/
+/* Compile a query against an index, replacing what plan held.
+ *
+ * Caller provides:
+ *   a plan, a query, the index to search, its manifest (for its stop
+ *   words; may be NULL), and the most words a prefix expands to.
+ * We return:
+ *   true on success, false if a parameter is NULL or out of memory.
+ * We guarantee:
+ *   stop words, which the indexer left out, are true of every document:
+ *   they drop out of their andseq, and an andseq, or 'or', left with
+ *   nothing matches nothing, as does a 'not' of a stop word. A prefix
+ *   with more than maxExpansions words is expanded to the first of
+ *   them, saying so on stderr.
+ * Caller is responsible for:
+ *   not changing the index while the plan is used.
+ */
+bool plan_compile(plan_t* plan, query_t* query, index_t* index, manifest_t* manifest,
+                  const int maxExpansions);
+
+/**************** plan_run ****************/
+/* Run a compiled plan.
+ *
+ * Caller provides:
+ *   a compiled plan, and a function to call with each document that
+ *   matches, and its score, in increasing docID order, and its arg.
+ * We return:
+ *   the number of documents that match; -1 if out of memory, having
+ *   called itemfunc for none.
+ */
+int plan_run(plan_t* plan, void* arg,
+             void (*itemfunc)(void* arg, const int docID, const int score));
+
+/**************** plan_stats ****************/
+/* Fill stats with what the plan took since plan_compile last began.
+ * The counts are kept as the plan compiles and runs, a few additions
+ * per step, so they cost nothing worth turning off. */
+void plan_stats(plan_t* plan, planStats_t* stats);
+
+/**************** plan_explain ****************/
+/* Print the plan's steps to fp, one per line, indented under the 'and'
+ * or 'or' they are in, in the order they run: each word with the size
+ * of its postings or docset, each 'and' and 'or' with the most
+ * documents it can match; once the plan has run, also the documents
+ * each step gave, and those each 'and' checked against it and kept.
+ * query is the one the plan was compiled from; we do nothing if a
+ * parameter is NULL or the plan isn't compiled. */
+void plan_explain(plan_t* plan, query_t* query, FILE* fp);
+
+/**************** plan_delete ****************/
+/* Delete the plan, and its buffers; we ignore NULL plan. */
+void plan_delete(plan_t* plan);
+
+#endif // QUERY_H
@@ -0,0 +1,202 @@
+/*
+ * readbench.c - benchmark of the 'reader' module against libcs50's file module
+ *
+ * usage: ./readbench pageDirectory [indexFilename [passes]]
+ *
+ * Reads every page the crawler saved in pageDirectory, then (if given)
+ * every line of indexFilename, both with file_readLine/file_readFile and
+ * with the reader module, checks that both saw the same bytes, and
+ * prints the time each took, summed over passes (default 5).
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "file.h"
+#include "reader.h"
+
+/**************** local functions ****************/
+static double now(void);
+static unsigned long checksum(unsigned long sum, const char* s);
+static FILE* openPage(const char* pageDirectory, const int docID);
+static unsigned long pagesWithFile(const char* pageDirectory, int* pages);
+static unsigned long pagesWithReader(const char* pageDirectory, int* pages);
+static unsigned long linesWithFile(const char* indexFilename, int* lines);
+static unsigned long linesWithReader(const char* indexFilename, int* lines);
+static bool report(const char* what, const int passes, const int items,
+                   const double fileTime, const double readerTime,
+                   const unsigned long fileSum, const unsigned long readerSum);
+
+/**************** main ****************/
+int main(int argc, char* argv[]) {
+  if (argc < 2 || argc > 4) {
+    fprintf(stderr, "usage: %s pageDirectory [indexFilename [passes]]\n", argv[0]);
+    exit(1);
+  }
+  int passes = (argc == 4) ? atoi(argv[3]) : 5;
+  if (passes < 1) {
+    fprintf(stderr, "passes must be at least 1\n");
+    exit(1);
+  }
+  bool same = true;
+
+  //pages: url line, depth line, then the rest of the file
+  double fileTime = 0, readerTime = 0;
+  unsigned long fileSum = 0, readerSum = 0;
+  int pages = 0;
+  for (int i = 0; i < passes; i++) {
+    double start = now();
+    fileSum = pagesWithFile(argv[1], &pages);
+    fileTime += now() - start;
+    start = now();
+    readerSum = pagesWithReader(argv[1], &pages);
+    readerTime += now() - start;
+  }
+  same &= report("pages", passes, pages, fileTime, readerTime, fileSum, readerSum);
+
+  //index: every line
+  if (argc >= 3) {
+    fileTime = readerTime = 0;
+    int lines = 0;
+    for (int i = 0; i < passes; i++) {
+      double start = now();
+      fileSum = linesWithFile(argv[2], &lines);
+      fileTime += now() - start;
+      start = now();
+      readerSum = linesWithReader(argv[2], &lines);
+      readerTime += now() - start;
+    }
+    same &= report("index lines", passes, lines, fileTime, readerTime, fileSum, readerSum);
+  }
+  return same ? 0 : 2;
+}
+
+/**************** now ****************/
+/* seconds on a monotonic clock */
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**************** checksum ****************/
+/* fold a string into a running checksum, so both readers can be compared */
+static unsigned long checksum(unsigned long sum, const char* s) {
+  for (const unsigned char* p = (const unsigned char*)s; *p != '\0'; p++) {
+    sum = sum * 31 + *p;
+  }
+  return sum * 31 + 1;   // count the string itself, even if empty
+}
+
+/**************** openPage ****************/
+/* open pageDirectory/docID for reading, or return NULL */
+static FILE* openPage(const char* pageDirectory, const int docID) {
+  char pathname[strlen(pageDirectory) + 16];
+  sprintf(pathname, "%s/%d", pageDirectory, docID);
+  return fopen(pathname, "r");
+}
+
+/**************** pagesWithFile ****************/
+/* read every page as pagedir_load used to, with the file module */
+static unsigned long pagesWithFile(const char* pageDirectory, int* pages) {
+  unsigned long sum = 0;
+  FILE* fp;
+  int docID;
+  for (docID = 1; (fp = openPage(pageDirectory, docID)) != NULL; docID++) {
+    char* url = file_readLine(fp);
+    char* depth = file_readLine(fp);
+    char* html = file_readFile(fp);
+    sum = checksum(sum, url == NULL ? "" : url);
+    sum = checksum(sum, html == NULL ? "" : html);
+    free(url);
+    free(depth);
+    free(html);
+    fclose(fp);
+  }
+  *pages = docID - 1;
+  return sum;
+}
+
+/**************** pagesWithReader ****************/
+/* read every page as pagedir_load does now, with one read per file */
+static unsigned long pagesWithReader(const char* pageDirectory, int* pages) {
+  unsigned long sum = 0;
+  FILE* fp;
+  int docID;
+  for (docID = 1; (fp = openPage(pageDirectory, docID)) != NULL; docID++) {
+    size_t len;
+    char* text = reader_readFile(fp, &len);
+    fclose(fp);
+    if (text == NULL) {
+      //empty file
+      sum = checksum(checksum(sum, ""), "");
+      continue;
+    }
+    char* urlEnd = memchr(text, '\n', len);
+    char* depthEnd = (urlEnd == NULL) ? NULL : memchr(urlEnd + 1, '\n', text + len - urlEnd - 1);
+    if (urlEnd != NULL) {
+      *urlEnd = '\0';
+    }
+    sum = checksum(sum, text);
+    sum = checksum(sum, depthEnd == NULL ? "" : depthEnd + 1);
+    free(text);
+  }
+  *pages = docID - 1;
+  return sum;
+}
+
+/**************** linesWithFile ****************/
+/* count, then read, every line as index_load used to */
+static unsigned long linesWithFile(const char* indexFilename, int* lines) {
+  FILE* fp = fopen(indexFilename, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "can't open %s\n", indexFilename);
+    exit(1);
+  }
+  *lines = file_numLines(fp);
+  unsigned long sum = 0;
+  char* line;
+  while ((line = file_readLine(fp)) != NULL) {
+    sum = checksum(sum, line);
+    free(line);
+  }
+  fclose(fp);
+  return sum;
+}
+
+/**************** linesWithReader ****************/
+/* read every line with a line reader */
+static unsigned long linesWithReader(const char* indexFilename, int* lines) {
+  FILE* fp = fopen(indexFilename, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "can't open %s\n", indexFilename);
+    exit(1);
+  }
+  reader_t* reader = reader_new(fp);
+  unsigned long sum = 0;
+  char* line;
+  while ((line = reader_nextLine(reader, NULL)) != NULL) {
+    sum = checksum(sum, line);
+  }
+  reader_delete(reader);
+  fclose(fp);
+  return sum;
+}
+
+/**************** report ****************/
+/* print one row of results; return false if the checksums differ */
+static bool report(const char* what, const int passes, const int items,
+                   const double fileTime, const double readerTime,
+                   const unsigned long fileSum, const unsigned long readerSum) {
+  printf("%-12s %6d x %d passes: file %8.3f ms, reader %8.3f ms, %5.1fx%s\n",
+         what, items, passes, fileTime * 1000, readerTime * 1000,
+         (readerTime > 0) ? fileTime / readerTime : 0.0,
+         (fileSum == readerSum) ? "" : "  MISMATCH");
+  return fileSum == readerSum;
+}
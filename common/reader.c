@@ -0,0 +1,227 @@
+/*
+ * reader.c - CS50 'reader' module
+ *
+ * see reader.h for more information.
+ *
+ * The line reader keeps unread bytes in buf[start, end); lines are
+ * NUL-terminated in place. When no newline is left in the buffer, the
+ * unread bytes move to the front and read() fills the rest, so each
+ * byte is copied at most once for lines shorter than the buffer.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "mem.h"
+#include "reader.h"
+
+/**************** local constants ****************/
+static const size_t BUFFER_SIZE = 65536;  // initial line buffer, bytes
+
+/**************** local types ****************/
+typedef struct reader {
+  int fd;                   // descriptor beneath the caller's FILE
+  char* buf;                // unread bytes are buf[start, end)
+  size_t start;
+  size_t end;
+  size_t capacity;          // size of buf, always > end
+  bool eof;                 // read() has returned 0 or failed
+} reader_t;
+
+/**************** local functions ****************/
+static ssize_t readSome(const int fd, char* buf, const size_t count);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** reader_readFile ****************/
+/* see reader.h for more information */
+char* reader_readFile(FILE* fp, size_t* len) {
+  if (fp == NULL) {
+    return NULL;
+  }
+  int fd = fileno(fp);
+
+  //size a regular file's buffer from what is left of it, plus the NUL,
+  //plus one spare byte so the read that finds end of file has room
+  size_t capacity = BUFFER_SIZE;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset >= 0 && st.st_size >= offset) {
+      capacity = (size_t)(st.st_size - offset) + 2;
+    }
+  }
+
+  char* text = malloc(capacity);
+  if (text == NULL) {
+    return NULL;
+  }
+  size_t size = 0;
+  ssize_t got;
+  //one read for a regular file; loops for pipes, or files that grew
+  while ((got = readSome(fd, text + size, capacity - 1 - size)) > 0) {
+    size += got;
+    if (size == capacity - 1) {
+      char* bigger = realloc(text, capacity * 2);
+      if (bigger == NULL) {
+        free(text);
+        return NULL;
+      }
+      text = bigger;
+      capacity *= 2;
+    }
+  }
+
+  if (got < 0 || size == 0) {
+    //error, or nothing left to read
+    free(text);
+    return NULL;
+  }
+  text[size] = '\0';
+  if (len != NULL) {
+    *len = size;
+  }
+  return text;
+}
+
+/**************** reader_new ****************/
+/* see reader.h for more information */
+reader_t* reader_new(FILE* fp) {
+  if (fp == NULL) {
+    return NULL;
+  }
+  reader_t* reader = mem_malloc(sizeof(reader_t));
+  if (reader == NULL) {
+    return NULL;
+  }
+  reader->buf = malloc(BUFFER_SIZE);
+  if (reader->buf == NULL) {
+    mem_free(reader);
+    return NULL;
+  }
+  reader->fd = fileno(fp);
+  reader->start = 0;
+  reader->end = 0;
+  reader->capacity = BUFFER_SIZE;
+  reader->eof = false;
+  return reader;
+}
+
+/**************** reader_nextLine ****************/
+/* see reader.h for more information */
+char* reader_nextLine(reader_t* reader, size_t* len) {
+  if (reader == NULL) {
+    return NULL;
+  }
+
+  //bytes before start have been searched already
+  size_t searched = reader->start;
+  while (true) {
+    char* line = reader->buf + reader->start;
+    char* newline = memchr(reader->buf + searched, '\n', reader->end - searched);
+    if (newline != NULL) {
+      *newline = '\0';
+      if (len != NULL) {
+        *len = newline - line;
+      }
+      reader->start = newline + 1 - reader->buf;
+      return line;
+    }
+
+    if (reader->eof) {
+      if (reader->start == reader->end) {
+        return NULL;
+      }
+      //last line has no newline; capacity > end leaves room for the NUL
+      reader->buf[reader->end] = '\0';
+      if (len != NULL) {
+        *len = reader->end - reader->start;
+      }
+      reader->start = reader->end;
+      return line;
+    }
+
+    //move the partial line to the front, growing the buffer if it is full
+    size_t partial = reader->end - reader->start;
+    memmove(reader->buf, line, partial);
+    reader->start = 0;
+    reader->end = partial;
+    searched = partial;
+    if (reader->end + 1 == reader->capacity) {
+      char* bigger = realloc(reader->buf, reader->capacity * 2);
+      if (bigger == NULL) {
+        return NULL;
+      }
+      reader->buf = bigger;
+      reader->capacity *= 2;
+    }
+
+    ssize_t got = readSome(reader->fd, reader->buf + reader->end,
+                           reader->capacity - 1 - reader->end);
+    if (got <= 0) {
+      reader->eof = true;
+    } else {
+      reader->end += got;
+    }
+  }
+}
+
+/**************** reader_readLine ****************/
+/* see reader.h for more information */
+char* reader_readLine(reader_t* reader) {
+  size_t len;
+  char* line = reader_nextLine(reader, &len);
+  if (line == NULL) {
+    return NULL;
+  }
+  char* copy = malloc(len + 1);
+  if (copy != NULL) {
+    memcpy(copy, line, len + 1);
+  }
+  return copy;
+}
+
+/**************** reader_countLines ****************/
+/* see reader.h for more information */
+int reader_countLines(const char* text, const size_t len) {
+  int lines = 0;
+  const char* end = text + len;
+  const char* p = text;
+  while (p < end && (p = memchr(p, '\n', end - p)) != NULL) {
+    lines++;
+    p++;
+  }
+  return lines;
+}
+
+/**************** reader_delete ****************/
+/* see reader.h for more information */
+void reader_delete(reader_t* reader) {
+  if (reader != NULL) {
+    free(reader->buf);
+    mem_free(reader);
+  }
+}
+
+/**************** readSome ****************/
+/* read up to count bytes, retrying if interrupted by a signal
+ * returns bytes read, 0 at end of file, -1 on error
+ * not visible to outsiders, not in reader.h
+ */
+static ssize_t readSome(const int fd, char* buf, const size_t count) {
+  ssize_t got;
+  do {
+    got = read(fd, buf, count);
+  } while (got < 0 && errno == EINTR);
+  return got;
+}
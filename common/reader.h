@@ -0,0 +1,84 @@
+/*
+ * reader.h - header file for CS50 'reader' module
+ *
+ * a reader is a faster replacement for libcs50's file_readLine and
+ * file_readFile, which read one character at a time with fgetc.
+ * Whole files are read with one read() sized by fstat; lines are found
+ * with memchr in a large buffer that is refilled with read(). Strings
+ * returned follow the file module's rules: malloc'd, without the
+ * newline, and NULL once nothing is left.
+ *
+ * Both work on the file descriptor beneath a FILE*, so the FILE* must
+ * not also be read with stdio (fgetc, fscanf, file_readLine...).
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef READER_H
+#define READER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct reader reader_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** reader_readFile ****************/
+/* Read the rest of a file into one string.
+ *
+ * Caller provides:
+ *   valid FILE pointer, open for reading and not read through stdio
+ *   len - where to store the number of bytes read, or NULL
+ * We return:
+ *   the bytes read, NUL-terminated, in malloc'd memory;
+ *   NULL if nothing is left to read, or on error.
+ * Notes:
+ *   a regular file is read in a single read() of the size fstat reports;
+ *   pipes and terminals are read until end of file.
+ * Caller is responsible for:
+ *   later freeing the string.
+ */
+char* reader_readFile(FILE* fp, size_t* len);
+
+/**************** reader_new ****************/
+/* Create a line reader for fp.
+ *
+ * Caller provides:
+ *   valid FILE pointer, open for reading and not read through stdio;
+ *   works for files, pipes and terminals (stdin) alike.
+ * We return:
+ *   pointer to a new reader, or NULL if error.
+ * Caller is responsible for:
+ *   later calling reader_delete, and closing fp.
+ */
+reader_t* reader_new(FILE* fp);
+
+/**************** reader_nextLine ****************/
+/* Return the next line, without its newline, in the reader's buffer.
+ *
+ * We return:
+ *   the line, NUL-terminated, with its length in *len if len is not NULL;
+ *   NULL at end of file.
+ * We guarantee:
+ *   no memory is allocated except to grow the buffer for a long line.
+ * Notes:
+ *   the line is overwritten by the next call; caller may modify it.
+ */
+char* reader_nextLine(reader_t* reader, size_t* len);
+
+/**************** reader_readLine ****************/
+/* Return the next line, without its newline, as a malloc'd copy, or
+ * NULL at end of file; like file_readLine. Caller must free the line. */
+char* reader_readLine(reader_t* reader);
+
+/**************** reader_countLines ****************/
+/* Return the number of newlines in the first len bytes of text. */
+int reader_countLines(const char* text, const size_t len);
+
+/**************** reader_delete ****************/
+/* Delete the reader (but not close its FILE); we ignore NULL reader. */
+void reader_delete(reader_t* reader);
+
+#endif // READER_H
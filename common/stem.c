@@ -0,0 +1,373 @@
+/*
+ * stem.c - CS50 'stem' module
+ *
+ * see stem.h for more information.
+ *
+ * The Porter stemmer follows the author's reference implementation,
+ * including its two departures from the paper ("bli" -> "ble" in step
+ * 2 where the paper has "abli" -> "able", and "logi" -> "log"), so its
+ * stems match the published test vocabulary. The word is worked on as
+ * b[0..k], and a suffix that ends() matches starts at b[j + 1].
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "stem.h"
+
+/**************** local types ****************/
+typedef struct porter {
+  char* b;                  // the word, stemmed in place
+  int k;                    // index of its last letter
+  int j;                    // index of the last letter before a matched suffix
+} porter_t;
+
+/**************** local functions ****************/
+static void porterStem(porter_t* p);
+static bool cons(porter_t* p, const int i);
+static int measure(porter_t* p);
+static bool vowelInStem(porter_t* p);
+static bool doubleC(porter_t* p, const int i);
+static bool cvc(porter_t* p, const int i);
+static bool ends(porter_t* p, const char* s);
+static void setTo(porter_t* p, const char* s);
+static void replace(porter_t* p, const char* s);
+static void step1ab(porter_t* p);
+static void step1c(porter_t* p);
+static void step2(porter_t* p);
+static void step3(porter_t* p);
+static void step4(porter_t* p);
+static void step5(porter_t* p);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** stem_parse ****************/
+/* see stem.h for more information */
+bool stem_parse(const char* name, stemmer_t* stemmer) {
+  if (name == NULL || stemmer == NULL) {
+    return false;
+  }
+  if (strcmp(name, "none") == 0) {
+    *stemmer = STEM_NONE;
+  } else if (strcmp(name, "porter") == 0) {
+    *stemmer = STEM_PORTER;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**************** stem_name ****************/
+/* see stem.h for more information */
+const char* stem_name(const stemmer_t stemmer) {
+  return (stemmer == STEM_PORTER) ? "porter" : "none";
+}
+
+/**************** stem_word ****************/
+/* see stem.h for more information */
+void stem_word(const stemmer_t stemmer, char* word) {
+  if (stemmer != STEM_PORTER || word == NULL) {
+    return;
+  }
+  porter_t p = { word, (int)strlen(word) - 1, 0 };
+  if (p.k > 1) {
+    porterStem(&p);
+    word[p.k + 1] = '\0';
+  }
+}
+
+/**************** porterStem ****************/
+/* run the five steps on p->b[0..p->k], leaving the stem in b[0..k]
+ * not visible to outsiders, not in stem.h
+ */
+static void porterStem(porter_t* p) {
+  step1ab(p);
+  if (p->k > 0) {
+    step1c(p);
+    step2(p);
+    step3(p);
+    step4(p);
+    step5(p);
+  }
+}
+
+/**************** cons ****************/
+/* true if b[i] is a consonant: not a, e, i, o or u, and not a y
+ * after a consonant
+ * not visible to outsiders, not in stem.h
+ */
+static bool cons(porter_t* p, const int i) {
+  switch (p->b[i]) {
+    case 'a': case 'e': case 'i': case 'o': case 'u':
+      return false;
+    case 'y':
+      return (i == 0) ? true : !cons(p, i - 1);
+    default:
+      return true;
+  }
+}
+
+/**************** measure ****************/
+/* return m, the number of vowel-consonant sequences in b[0..j]: a
+ * word is [C](VC)^m[V], C and V runs of consonants and vowels
+ * not visible to outsiders, not in stem.h
+ */
+static int measure(porter_t* p) {
+  int n = 0;
+  int i = 0;
+  while (true) {
+    if (i > p->j) {
+      return n;
+    }
+    if (!cons(p, i)) {
+      break;
+    }
+    i++;
+  }
+  i++;
+  while (true) {
+    while (true) {
+      if (i > p->j) {
+        return n;
+      }
+      if (cons(p, i)) {
+        break;
+      }
+      i++;
+    }
+    i++;
+    n++;
+    while (true) {
+      if (i > p->j) {
+        return n;
+      }
+      if (!cons(p, i)) {
+        break;
+      }
+      i++;
+    }
+    i++;
+  }
+}
+
+/**************** vowelInStem ****************/
+/* true if b[0..j] has a vowel
+ * not visible to outsiders, not in stem.h
+ */
+static bool vowelInStem(porter_t* p) {
+  for (int i = 0; i <= p->j; i++) {
+    if (!cons(p, i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************** doubleC ****************/
+/* true if b[i - 1..i] is a double consonant
+ * not visible to outsiders, not in stem.h
+ */
+static bool doubleC(porter_t* p, const int i) {
+  return i >= 1 && p->b[i] == p->b[i - 1] && cons(p, i);
+}
+
+/**************** cvc ****************/
+/* true if b[i - 2..i] is consonant-vowel-consonant, the last not w,
+ * x or y; a short syllable, as in "hop", whose stem takes back an e
+ * not visible to outsiders, not in stem.h
+ */
+static bool cvc(porter_t* p, const int i) {
+  if (i < 2 || !cons(p, i) || cons(p, i - 1) || !cons(p, i - 2)) {
+    return false;
+  }
+  char ch = p->b[i];
+  return ch != 'w' && ch != 'x' && ch != 'y';
+}
+
+/**************** ends ****************/
+/* true if b[0..k] ends with s, setting j to just before it
+ * not visible to outsiders, not in stem.h
+ */
+static bool ends(porter_t* p, const char* s) {
+  int length = strlen(s);
+  if (length > p->k + 1 || memcmp(p->b + p->k - length + 1, s, length) != 0) {
+    return false;
+  }
+  p->j = p->k - length;
+  return true;
+}
+
+/**************** setTo ****************/
+/* replace b[j + 1..k] by s, which is no longer than what ends() matched
+ * not visible to outsiders, not in stem.h
+ */
+static void setTo(porter_t* p, const char* s) {
+  int length = strlen(s);
+  memcpy(p->b + p->j + 1, s, length);
+  p->k = p->j + length;
+}
+
+/**************** replace ****************/
+/* setTo(s) if the stem before the suffix has m > 0
+ * not visible to outsiders, not in stem.h
+ */
+static void replace(porter_t* p, const char* s) {
+  if (measure(p) > 0) {
+    setTo(p, s);
+  }
+}
+
+/**************** step1ab ****************/
+/* plurals and -ed or -ing: caresses -> caress, ponies -> poni,
+ * cats -> cat, feed -> feed, agreed -> agree, plastered -> plaster,
+ * motoring -> motor, conflated -> conflate, hopping -> hop,
+ * filing -> file
+ * not visible to outsiders, not in stem.h
+ */
+static void step1ab(porter_t* p) {
+  if (p->b[p->k] == 's') {
+    if (ends(p, "sses")) {
+      p->k -= 2;
+    } else if (ends(p, "ies")) {
+      setTo(p, "i");
+    } else if (p->b[p->k - 1] != 's') {
+      p->k--;
+    }
+  }
+  if (ends(p, "eed")) {
+    if (measure(p) > 0) {
+      p->k--;
+    }
+  } else if ((ends(p, "ed") || ends(p, "ing")) && vowelInStem(p)) {
+    p->k = p->j;
+    if (ends(p, "at")) {
+      setTo(p, "ate");
+    } else if (ends(p, "bl")) {
+      setTo(p, "ble");
+    } else if (ends(p, "iz")) {
+      setTo(p, "ize");
+    } else if (doubleC(p, p->k)) {
+      //hopp -> hop, but fall, hiss and fizz keep both
+      char ch = p->b[p->k];
+      if (ch != 'l' && ch != 's' && ch != 'z') {
+        p->k--;
+      }
+    } else {
+      p->j = p->k;
+      if (measure(p) == 1 && cvc(p, p->k)) {
+        //fil -> file; there is room, as -ed or -ing was removed
+        p->b[++p->k] = 'e';
+      }
+    }
+  }
+}
+
+/**************** step1c ****************/
+/* a final y after a vowel in the stem becomes i: happy -> happi
+ * not visible to outsiders, not in stem.h
+ */
+static void step1c(porter_t* p) {
+  if (ends(p, "y") && vowelInStem(p)) {
+    p->b[p->k] = 'i';
+  }
+}
+
+/**************** step2 ****************/
+/* double suffixes become single ones: -ization -> -ize,
+ * -ational -> -ate, ..., when the stem has m > 0
+ * not visible to outsiders, not in stem.h
+ */
+static void step2(porter_t* p) {
+  //the rules, grouped by the suffix's last letter but one
+  static const char* const rules[][2] = {
+    { "ational", "ate" }, { "tional", "tion" },
+    { "enci", "ence" }, { "anci", "ance" },
+    { "izer", "ize" },
+    { "bli", "ble" }, { "alli", "al" }, { "entli", "ent" }, { "eli", "e" }, { "ousli", "ous" },
+    { "ization", "ize" }, { "ation", "ate" }, { "ator", "ate" },
+    { "alism", "al" }, { "iveness", "ive" }, { "fulness", "ful" }, { "ousness", "ous" },
+    { "aliti", "al" }, { "iviti", "ive" }, { "biliti", "ble" },
+    { "logi", "log" }
+  };
+  if (p->k < 1) {
+    return;
+  }
+  for (size_t r = 0; r < sizeof(rules) / sizeof(rules[0]); r++) {
+    const char* suffix = rules[r][0];
+    if (suffix[strlen(suffix) - 2] == p->b[p->k - 1] && ends(p, suffix)) {
+      //the first suffix that matches decides, whether or not m > 0
+      replace(p, rules[r][1]);
+      return;
+    }
+  }
+}
+
+/**************** step3 ****************/
+/* -ic-, -full, -ness and the like: -icate -> -ic, -ful -> nothing, ...
+ * not visible to outsiders, not in stem.h
+ */
+static void step3(porter_t* p) {
+  static const char* const rules[][2] = {
+    { "icate", "ic" }, { "ative", "" }, { "alize", "al" },
+    { "iciti", "ic" },
+    { "ical", "ic" }, { "ful", "" },
+    { "ness", "" }
+  };
+  for (size_t r = 0; r < sizeof(rules) / sizeof(rules[0]); r++) {
+    const char* suffix = rules[r][0];
+    if (suffix[strlen(suffix) - 1] == p->b[p->k] && ends(p, suffix)) {
+      replace(p, rules[r][1]);
+      return;
+    }
+  }
+}
+
+/**************** step4 ****************/
+/* drop -ant, -ence, ... when the stem has m > 1
+ * not visible to outsiders, not in stem.h
+ */
+static void step4(porter_t* p) {
+  static const char* const suffixes[] = {
+    "al", "ance", "ence", "er", "ic", "able", "ible", "ant", "ement",
+    "ment", "ent", "ion", "ou", "ism", "ate", "iti", "ous", "ive", "ize"
+  };
+  if (p->k < 1) {
+    return;
+  }
+  for (size_t r = 0; r < sizeof(suffixes) / sizeof(suffixes[0]); r++) {
+    const char* suffix = suffixes[r];
+    if (suffix[strlen(suffix) - 2] != p->b[p->k - 1] || !ends(p, suffix)) {
+      continue;
+    }
+    //-ion only after s or t: adoption -> adopt, but not onion
+    if (strcmp(suffix, "ion") == 0 && (p->j < 0 || (p->b[p->j] != 's' && p->b[p->j] != 't'))) {
+      continue;
+    }
+    if (measure(p) > 1) {
+      p->k = p->j;
+    }
+    return;
+  }
+}
+
+/**************** step5 ****************/
+/* drop a final -e when the stem has m > 1 (or m = 1 and no short
+ * syllable), and -ll to -l when m > 1
+ * not visible to outsiders, not in stem.h
+ */
+static void step5(porter_t* p) {
+  p->j = p->k;
+  if (p->b[p->k] == 'e') {
+    int m = measure(p);
+    if (m > 1 || (m == 1 && !cvc(p, p->k - 1))) {
+      p->k--;
+    }
+  }
+  if (p->b[p->k] == 'l' && doubleC(p, p->k) && measure(p) > 1) {
+    p->k--;
+  }
+}
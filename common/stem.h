@@ -0,0 +1,57 @@
+/*
+ * stem.h - header file for CS50 'stem' module
+ *
+ * a stemmer strips the endings of a word to its stem, so that forms of
+ * one word, like "crawl", "crawled" and "crawling", are indexed and
+ * searched as one ("crawl"). The Porter stemmer (M.F. Porter, "An
+ * algorithm for suffix stripping", 1980) removes English suffixes in
+ * five steps of rules; it isn't a dictionary, and some stems aren't
+ * words ("search" and "searching" both give "search", but "query"
+ * gives "queri"). What matters is that the indexer and the querier
+ * stem every word the same way.
+ *
+ * Words are stemmed in place: a stem is never longer than its word,
+ * so no memory is allocated.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef STEM_H
+#define STEM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef enum stemmer {
+  STEM_NONE,                // words are kept as they are
+  STEM_PORTER
+} stemmer_t;
+
+/**************** functions ****************/
+
+/**************** stem_parse ****************/
+/* Find the stemmer with the given name: "none" or "porter".
+ *
+ * We return:
+ *   true and *stemmer set if name is one of those, false otherwise.
+ */
+bool stem_parse(const char* name, stemmer_t* stemmer);
+
+/**************** stem_name ****************/
+/* Return the name of stemmer, as stem_parse takes it. */
+const char* stem_name(const stemmer_t stemmer);
+
+/**************** stem_word ****************/
+/* Stem a word in place.
+ *
+ * Caller provides:
+ *   a stemmer, and a word of lowercase letters (see normalizeWord).
+ * We guarantee:
+ *   the word is replaced by its stem, which is no longer; words of
+ *   one or two letters, and any word with STEM_NONE, are unchanged.
+ *   We ignore NULL word.
+ */
+void stem_word(const stemmer_t stemmer, char* word);
+
+#endif // STEM_H
@@ -0,0 +1,542 @@
+/*
+ * trigram.c - CS50 'trigram' module
+ *
+ * see trigram.h for more information.
+ *
+ * The index is kept in memory as it is saved, so loading it is reading
+ * the bytes and finding where each trigram's list starts. A trigram is
+ * known by its three letters packed into an integer, and found by
+ * binary search. trigram_match counts the trigrams each word shares
+ * with the word looked for in one byte per term ID, clearing only the
+ * counts it set, so a lookup costs the length of the lists it reads,
+ * not the size of the dict; only the shortest lists can bring in new
+ * words, the rest just add to their counts.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "reader.h"
+#include "codec.h"
+#include "dict.h"
+#include "trigram.h"
+
+/**************** local constants ****************/
+static const char PAD = '$';            // pads words at both ends
+static const int MAX_LENGTH = 255;      // longest length a byte holds
+
+/**************** local types ****************/
+typedef struct trigram {
+  unsigned char* bytes;     // word lengths, then the trigrams' lists, as saved
+  size_t numBytes;
+  int numWords;
+  int numGrams;
+  uint32_t* keys;           // the trigrams, packed, in increasing order
+  size_t* lists;            // where each trigram's number of words is in bytes
+  unsigned char* shared;    // for trigram_match: trigrams shared, by term ID
+} trigram_t;
+
+//a trigram of a word, while trigram_new gathers them
+typedef struct gramPair {
+  uint32_t key;
+  int id;
+} gramPair_t;
+
+//what addWord fills for trigram_new
+typedef struct builder {
+  gramPair_t* pairs;
+  size_t count;
+  size_t capacity;
+  unsigned char* lengths;   // by term ID
+  bool ok;                  // false once out of memory
+} builder_t;
+
+//the list of one trigram of the word trigram_match looks for
+typedef struct gramList {
+  size_t pos;               // where its term ID gaps start in bytes
+  uint32_t n;               // how many there are
+} gramList_t;
+
+//what checkWord needs for trigram_match: the word, and the closest found
+typedef struct match {
+  const char* word;
+  int length;
+  int* rows;                // two rows of length + 1 distances
+  int best;                 // term ID of the closest word so far, or -1
+  int bestDist;             // its distance; maxDist + 1 until one is found
+} match_t;
+
+/**************** local functions ****************/
+static trigram_t* newTrigram(unsigned char* bytes, const size_t numBytes,
+                             const int numWords, const int numGrams);
+static uint32_t gramAt(const char* word, const int length, const int i);
+static void addWord(void* arg, const int id, const char* word);
+static int comparePairs(const void* a, const void* b);
+static int compareKeys(const void* a, const void* b);
+static int compareLists(const void* a, const void* b);
+static int findGram(trigram_t* grams, const uint32_t key);
+static void checkWord(void* arg, const int id, const char* word);
+static int editDistance(match_t* match, const char* word, const int limit);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** trigram_new ****************/
+/* see trigram.h for more information */
+trigram_t* trigram_new(dict_t* dict) {
+  if (dict == NULL) {
+    return NULL;
+  }
+  int numWords = dict_size(dict);
+  builder_t builder = { NULL, 0, 0, malloc(numWords + 1), true };
+  if (builder.lengths == NULL) {
+    return NULL;
+  }
+  dict_iterate(dict, 0, numWords, &builder, addWord);
+  if (!builder.ok) {
+    free(builder.pairs);
+    free(builder.lengths);
+    return NULL;
+  }
+  qsort(builder.pairs, builder.count, sizeof(gramPair_t), comparePairs);
+  //a word with a trigram twice, like "ana" in "banana", is listed once
+  size_t numPairs = 0;
+  for (size_t i = 0; i < builder.count; i++) {
+    if (numPairs == 0 || comparePairs(&builder.pairs[i], &builder.pairs[numPairs - 1]) != 0) {
+      builder.pairs[numPairs++] = builder.pairs[i];
+    }
+  }
+  builder.count = numPairs;
+
+  //size, then write: the lengths, then each trigram and its term IDs
+  unsigned char vbyte[5];
+  size_t numBytes = numWords;
+  int numGrams = 0;
+  for (size_t i = 0; i < builder.count; ) {
+    size_t end = i;
+    int n = 0;
+    for (int prev = 0; end < builder.count && builder.pairs[end].key == builder.pairs[i].key; end++) {
+      numBytes += codec_putVByte(builder.pairs[end].id - prev, vbyte);
+      prev = builder.pairs[end].id;
+      n++;
+    }
+    numBytes += 3 + codec_putVByte(n, vbyte);
+    numGrams++;
+    i = end;
+  }
+  unsigned char* bytes = malloc(numBytes + 1);
+  if (bytes == NULL) {
+    free(builder.pairs);
+    free(builder.lengths);
+    return NULL;
+  }
+  memcpy(bytes, builder.lengths, numWords);
+  unsigned char* p = bytes + numWords;
+  for (size_t i = 0; i < builder.count; ) {
+    uint32_t key = builder.pairs[i].key;
+    size_t end = i;
+    while (end < builder.count && builder.pairs[end].key == key) {
+      end++;
+    }
+    *p++ = (unsigned char)(key >> 16);
+    *p++ = (unsigned char)(key >> 8);
+    *p++ = (unsigned char)key;
+    p += codec_putVByte(end - i, p);
+    for (int prev = 0; i < end; i++) {
+      p += codec_putVByte(builder.pairs[i].id - prev, p);
+      prev = builder.pairs[i].id;
+    }
+  }
+  free(builder.pairs);
+  free(builder.lengths);
+  return newTrigram(bytes, numBytes, numWords, numGrams);
+}
+
+/**************** trigram_match ****************/
+/* see trigram.h for more information */
+int trigram_match(trigram_t* grams, dict_t* dict, const char* word, const int maxDist,
+                  int* distance) {
+  if (grams == NULL || dict == NULL || word == NULL || distance == NULL || maxDist < 0
+      || dict_size(dict) != grams->numWords) {
+    return -1;
+  }
+  if (grams->shared == NULL && (grams->shared = calloc(grams->numWords + 1, 1)) == NULL) {
+    return -1;
+  }
+
+  //the word's trigrams, each once
+  int length = strlen(word);
+  int numKeys = length + 2;
+  uint32_t* keys = malloc(numKeys * sizeof(uint32_t));
+  int* rows = malloc(2 * (length + 1) * sizeof(int));
+  gramList_t* lists = malloc(numKeys * sizeof(gramList_t));
+  int* touched = NULL;
+  size_t numTouched = 0;
+  size_t maxTouched = 0;
+  bool ok = (keys != NULL && rows != NULL && lists != NULL);
+  if (ok) {
+    for (int i = 0; i < numKeys; i++) {
+      keys[i] = gramAt(word, length, i);
+    }
+    qsort(keys, numKeys, sizeof(uint32_t), compareKeys);
+    int n = 0;
+    for (int i = 0; i < numKeys; i++) {
+      if (n == 0 || keys[i] != keys[n - 1]) {
+        keys[n++] = keys[i];
+      }
+    }
+    numKeys = n;
+  }
+
+  //the lists of the word's trigrams, shortest first; a missing trigram
+  //has an empty list
+  for (int k = 0; ok && k < numKeys; k++) {
+    int g = findGram(grams, keys[k]);
+    lists[k].pos = 0;
+    lists[k].n = 0;
+    if (g >= 0) {
+      lists[k].pos = grams->lists[g]
+        + codec_getVByte(grams->bytes + grams->lists[g],
+                         grams->numBytes - grams->lists[g], &lists[k].n);
+    }
+  }
+  if (ok) {
+    qsort(lists, numKeys, sizeof(gramList_t), compareLists);
+  }
+
+  //a word within maxDist edits shares all but 3 * maxDist of the trigrams,
+  //so it is in one of the numKeys - needed + 1 shortest lists; the
+  //longer lists only add to the counts of words already found
+  int needed = numKeys - 3 * maxDist;
+  needed = (needed < 1) ? 1 : needed;
+  for (int k = 0; ok && k < numKeys; k++) {
+    bool adding = (k < numKeys - needed + 1);
+    const unsigned char* p = grams->bytes + lists[k].pos;
+    const unsigned char* end = grams->bytes + grams->numBytes;
+    int id = 0;
+    for (uint32_t i = 0; ok && i < lists[k].n; i++) {
+      uint32_t gap = 0;
+      p += codec_getVByte(p, end - p, &gap);
+      id += gap;
+      int other = grams->bytes[id];
+      if (other < MAX_LENGTH && length < MAX_LENGTH && abs(other - length) > maxDist) {
+        //too short or too long to be within maxDist edits
+        continue;
+      }
+      if (grams->shared[id] == 0) {
+        if (!adding) {
+          continue;
+        }
+        if (numTouched == maxTouched) {
+          maxTouched = (maxTouched == 0) ? 256 : maxTouched * 2;
+          int* more = realloc(touched, maxTouched * sizeof(int));
+          if (more == NULL) {
+            ok = false;
+            break;
+          }
+          touched = more;
+        }
+        touched[numTouched++] = id;
+      }
+      if (grams->shared[id] < MAX_LENGTH) {
+        grams->shared[id]++;
+      }
+    }
+  }
+
+  //only the words that share enough trigrams are compared with word
+  match_t match = { word, length, rows, -1, maxDist + 1 };
+  for (size_t i = 0; i < numTouched; i++) {
+    if (ok && grams->shared[touched[i]] >= needed) {
+      dict_iterate(dict, touched[i], 1, &match, checkWord);
+    }
+    grams->shared[touched[i]] = 0;
+  }
+  free(keys);
+  free(rows);
+  free(lists);
+  free(touched);
+  if (!ok || match.best < 0) {
+    return -1;
+  }
+  *distance = match.bestDist;
+  return match.best;
+}
+
+/**************** trigram_memory ****************/
+/* see trigram.h for more information */
+size_t trigram_memory(trigram_t* grams) {
+  if (grams == NULL) {
+    return 0;
+  }
+  return sizeof(trigram_t) + grams->numBytes + 1
+    + grams->numGrams * (sizeof(uint32_t) + sizeof(size_t))
+    + ((grams->shared != NULL) ? grams->numWords + 1 : 0);
+}
+
+/**************** trigram_save ****************/
+/* see trigram.h for more information */
+bool trigram_save(trigram_t* grams, const char* filename) {
+  if (grams == NULL || filename == NULL) {
+    return false;
+  }
+  FILE* fp = fopen(filename, "w");
+  if (fp == NULL) {
+    return false;
+  }
+  fprintf(fp, "trigram %d %d %lu\n", grams->numWords, grams->numGrams,
+          (unsigned long)grams->numBytes);
+  bool ok = (fwrite(grams->bytes, 1, grams->numBytes, fp) == grams->numBytes);
+  return (fclose(fp) == 0) && ok;
+}
+
+/**************** trigram_load ****************/
+/* see trigram.h for more information */
+trigram_t* trigram_load(const char* filename) {
+  FILE* fp = (filename == NULL) ? NULL : fopen(filename, "r");
+  if (fp == NULL) {
+    return NULL;
+  }
+  size_t len = 0;
+  char* text = reader_readFile(fp, &len);
+  fclose(fp);
+  if (text == NULL) {
+    return NULL;
+  }
+
+  //header line, then exactly numBytes of lengths and lists
+  int numWords = 0;
+  int numGrams = 0;
+  unsigned long numBytes = 0;
+  int header = 0;
+  if (sscanf(text, "trigram %d %d %lu%n", &numWords, &numGrams, &numBytes, &header) != 3
+      || text[header] != '\n' || numWords < 0 || numGrams < 0
+      || len - header - 1 != numBytes) {
+    free(text);
+    return NULL;
+  }
+  memmove(text, text + header + 1, numBytes);
+  return newTrigram((unsigned char*)text, numBytes, numWords, numGrams);
+}
+
+/**************** trigram_delete ****************/
+/* see trigram.h for more information */
+void trigram_delete(trigram_t* grams) {
+  if (grams != NULL) {
+    free(grams->bytes);
+    free(grams->keys);
+    free(grams->lists);
+    free(grams->shared);
+    mem_free(grams);
+  }
+}
+
+/**************** newTrigram ****************/
+/* make a trigram index of the bytes, which it takes over (bytes has
+ * room for one more byte): find each trigram's list, checking that the
+ * trigrams are in order, their term IDs increasing and below numWords,
+ * and that the lists end at numBytes; returns NULL, freeing bytes, if
+ * not or if out of memory
+ * not visible to outsiders, not in trigram.h
+ */
+static trigram_t* newTrigram(unsigned char* bytes, const size_t numBytes,
+                             const int numWords, const int numGrams) {
+  trigram_t* grams = mem_malloc(sizeof(trigram_t));
+  if (grams == NULL) {
+    free(bytes);
+    return NULL;
+  }
+  grams->bytes = bytes;
+  grams->numBytes = numBytes;
+  grams->numWords = numWords;
+  grams->numGrams = numGrams;
+  grams->keys = malloc((numGrams + 1) * sizeof(uint32_t));
+  grams->lists = malloc((numGrams + 1) * sizeof(size_t));
+  grams->shared = NULL;
+  if (grams->keys == NULL || grams->lists == NULL || numBytes < (size_t)numWords) {
+    trigram_delete(grams);
+    return NULL;
+  }
+
+  size_t pos = numWords;
+  int g;
+  for (g = 0; g < numGrams; g++) {
+    if (numBytes - pos < 3) {
+      break;
+    }
+    uint32_t key = ((uint32_t)bytes[pos] << 16) | ((uint32_t)bytes[pos + 1] << 8) | bytes[pos + 2];
+    if (g > 0 && key <= grams->keys[g - 1]) {
+      break;
+    }
+    grams->keys[g] = key;
+    pos += 3;
+    grams->lists[g] = pos;
+    uint32_t n = 0;
+    size_t read = codec_getVByte(bytes + pos, numBytes - pos, &n);
+    pos += read;
+    uint32_t id = 0;
+    uint32_t i;
+    for (i = 0; read > 0 && i < n; i++) {
+      uint32_t gap = 0;
+      if ((read = codec_getVByte(bytes + pos, numBytes - pos, &gap)) == 0
+          || (i > 0 && gap == 0) || gap >= (uint32_t)numWords - id) {
+        break;
+      }
+      pos += read;
+      id += gap;
+    }
+    if (read == 0 || i < n) {
+      break;
+    }
+  }
+  if (g < numGrams || pos != numBytes) {
+    //malformed
+    trigram_delete(grams);
+    return NULL;
+  }
+  return grams;
+}
+
+/**************** gramAt ****************/
+/* return the packed trigram at position i (from 0 to length + 1) of
+ * word padded with two PADs on each side
+ * not visible to outsiders, not in trigram.h
+ */
+static uint32_t gramAt(const char* word, const int length, const int i) {
+  uint32_t key = 0;
+  for (int j = i - 2; j < i + 1; j++) {
+    unsigned char c = (j < 0 || j >= length) ? PAD : (unsigned char)word[j];
+    key = (key << 8) | c;
+  }
+  return key;
+}
+
+/**************** addWord ****************/
+/* helper function that adds a word's length and trigrams to a builder
+ * not visible to outsiders, not in trigram.h
+ */
+static void addWord(void* arg, const int id, const char* word) {
+  builder_t* builder = arg;
+  int length = strlen(word);
+  builder->lengths[id] = (length < MAX_LENGTH) ? length : MAX_LENGTH;
+  for (int i = 0; builder->ok && i < length + 2; i++) {
+    if (builder->count == builder->capacity) {
+      builder->capacity = (builder->capacity == 0) ? 4096 : builder->capacity * 2;
+      gramPair_t* pairs = realloc(builder->pairs, builder->capacity * sizeof(gramPair_t));
+      if (pairs == NULL) {
+        builder->ok = false;
+        return;
+      }
+      builder->pairs = pairs;
+    }
+    builder->pairs[builder->count].key = gramAt(word, length, i);
+    builder->pairs[builder->count].id = id;
+    builder->count++;
+  }
+}
+
+/**************** comparePairs ****************/
+/* qsort comparator, orders trigram pairs by trigram, then term ID
+ * not visible to outsiders, not in trigram.h
+ */
+static int comparePairs(const void* a, const void* b) {
+  const gramPair_t* x = a;
+  const gramPair_t* y = b;
+  if (x->key != y->key) {
+    return (x->key > y->key) - (x->key < y->key);
+  }
+  return (x->id > y->id) - (x->id < y->id);
+}
+
+/**************** compareKeys ****************/
+/* qsort comparator, orders packed trigrams
+ * not visible to outsiders, not in trigram.h
+ */
+static int compareKeys(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a;
+  uint32_t y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+/**************** compareLists ****************/
+/* qsort comparator, orders trigram lists shortest first
+ * not visible to outsiders, not in trigram.h
+ */
+static int compareLists(const void* a, const void* b) {
+  uint32_t x = ((const gramList_t*)a)->n;
+  uint32_t y = ((const gramList_t*)b)->n;
+  return (x > y) - (x < y);
+}
+
+/**************** findGram ****************/
+/* return the index of a packed trigram in grams->keys, or -1
+ * not visible to outsiders, not in trigram.h
+ */
+static int findGram(trigram_t* grams, const uint32_t key) {
+  int lo = 0;
+  int hi = grams->numGrams - 1;
+  while (lo <= hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (grams->keys[mid] == key) {
+      return mid;
+    } else if (grams->keys[mid] < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return -1;
+}
+
+/**************** checkWord ****************/
+/* helper function for trigram_match, keeps a candidate word if it is
+ * closer than the best so far, or as close and first in the dict
+ * not visible to outsiders, not in trigram.h
+ */
+static void checkWord(void* arg, const int id, const char* word) {
+  match_t* match = arg;
+  int dist = editDistance(match, word, match->bestDist);
+  if (dist < match->bestDist || (dist == match->bestDist && match->best >= 0 && id < match->best)) {
+    match->best = id;
+    match->bestDist = dist;
+  }
+}
+
+/**************** editDistance ****************/
+/* return the Levenshtein distance between word and match->word, a row
+ * of the table at a time, or limit + 1 once every entry of a row is
+ * past limit, as the distance then is too
+ * not visible to outsiders, not in trigram.h
+ */
+static int editDistance(match_t* match, const char* word, const int limit) {
+  int n = match->length;
+  int* prev = match->rows;
+  int* cur = match->rows + n + 1;
+  for (int j = 0; j <= n; j++) {
+    prev[j] = j;
+  }
+  for (int i = 1; word[i - 1] != '\0'; i++) {
+    cur[0] = i;
+    int rowMin = i;
+    for (int j = 1; j <= n; j++) {
+      int cost = (word[i - 1] != match->word[j - 1]);
+      int d = prev[j - 1] + cost;
+      d = (prev[j] + 1 < d) ? prev[j] + 1 : d;
+      d = (cur[j - 1] + 1 < d) ? cur[j - 1] + 1 : d;
+      cur[j] = d;
+      rowMin = (d < rowMin) ? d : rowMin;
+    }
+    if (rowMin > limit) {
+      return limit + 1;
+    }
+    int* swap = prev;
+    prev = cur;
+    cur = swap;
+  }
+  return prev[n];
+}
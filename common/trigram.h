@@ -0,0 +1,93 @@
+/*
+ * trigram.h - header file for CS50 'trigram' module
+ *
+ * a trigram index lists, for each three-letter piece (trigram) of the
+ * words of a dict, the term IDs of the words that have it; words are
+ * padded with two '$' on each side first, so "crawl" has the trigrams
+ * "$$c", "$cr", "cra", "raw", "awl", "wl$" and "l$$". It finds the
+ * words of a dict within a small edit distance of a word that isn't
+ * there, a likely typo: one edit (a letter inserted, deleted or
+ * changed) spoils at most three of a word's trigrams, so a word within
+ * d edits shares all but 3d of them. Only the words that share enough
+ * trigrams, and whose length is close enough, have their distance
+ * computed, instead of every word of the dict.
+ *
+ * A trigram index is saved as a text header line, "trigram numWords
+ * numGrams numBytes", followed by the length of each word (one byte,
+ * 255 for longer words), then for each trigram in order its three
+ * letters, the number of its words and the gaps between their term
+ * IDs, as vbyte (see codec.h).
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef TRIGRAM_H
+#define TRIGRAM_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "dict.h"
+
+/**************** global types ****************/
+typedef struct trigram trigram_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** trigram_new ****************/
+/* Create the trigram index of a dict's words.
+ *
+ * We return:
+ *   pointer to a new trigram index, whose term IDs are the dict's;
+ *   NULL if dict is NULL or error.
+ * Caller is responsible for:
+ *   later calling trigram_delete.
+ */
+trigram_t* trigram_new(dict_t* dict);
+
+/**************** trigram_match ****************/
+/* Find the word of the dict closest to word, within maxDist edits.
+ *
+ * Caller provides:
+ *   a trigram index and the dict it was made from, a word, the most
+ *   edits to allow, and where to put the distance found.
+ * We return:
+ *   the term ID of the word fewest edits (Levenshtein distance) from
+ *   word, the first in the dict among equally close ones, with the
+ *   distance in *distance; -1 if there is no word within maxDist
+ *   edits that shares a trigram with word (or error).
+ * Notes:
+ *   word itself, if it is in the dict, is found with distance 0.
+ */
+int trigram_match(trigram_t* grams, dict_t* dict, const char* word, const int maxDist,
+                  int* distance);
+
+/**************** trigram_memory ****************/
+/* Return the number of bytes allocated for the index, 0 if NULL. */
+size_t trigram_memory(trigram_t* grams);
+
+/**************** trigram_save ****************/
+/* Save the trigram index to a file.
+ *
+ * Caller provides:
+ *   valid trigram pointer, filename - the file to (over)write.
+ * We return:
+ *   true on success, false if the file can't be written.
+ */
+bool trigram_save(trigram_t* grams, const char* filename);
+
+/**************** trigram_load ****************/
+/* Load a trigram index saved by trigram_save.
+ *
+ * We return:
+ *   pointer to a new trigram index, or NULL if the file can't be read
+ *   or isn't a trigram index.
+ * Caller is responsible for:
+ *   later calling trigram_delete.
+ */
+trigram_t* trigram_load(const char* filename);
+
+/**************** trigram_delete ****************/
+/* Delete the trigram index; we ignore NULL grams. */
+void trigram_delete(trigram_t* grams);
+
+#endif // TRIGRAM_H
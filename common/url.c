@@ -0,0 +1,468 @@
+/*
+ * url.c - CS50 'url' module
+ *
+ * see url.h for more information.
+ *
+ * The parsing rules follow parseURL, removeDotSegments, fixRelativeURL
+ * and webpage_getNextURL in libcs50/webpage.c, but every piece of a url
+ * is kept as a view into the original string instead of a malloc'd copy.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdbool.h>
+#include "url.h"
+
+/**************** local types ****************/
+//pieces of a parsed url, each one a view into the original string
+typedef struct urlparts {
+  const char* scheme;   // http://
+  size_t schemeLen;
+  const char* user;     // username:password@
+  size_t userLen;
+  const char* host;     // www.example.com
+  size_t hostLen;
+  const char* path;     // /path/to/file.html
+  size_t pathLen;
+  const char* tail;     // ?query#fragment, copied as-is
+  size_t tailLen;
+} urlparts_t;
+
+/**************** global variables ****************/
+static const char* EXTS[] = {  // valid extensions, same as libcs50
+  "html",
+  "htm",
+  NULL
+};
+
+/**************** local functions ****************/
+static const char* findAny(const char* s, const char* end, const char* set);
+static const char* findCase(const char* s, const char* pattern);
+static bool hasPrefix(const char* s, size_t len, const char* prefix);
+static bool isExactly(const char* s, size_t len, const char* word);
+static bool parseParts(const char* url, size_t len, urlparts_t* parts);
+static bool isHtmlPath(const char* path, size_t len);
+static size_t removeDotSegments(const char* in, size_t len, char* out);
+static void removeWhitespace(char* str);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** url_nextLink ****************/
+/* find the next link in html */
+/* see url.h for more information */
+bool url_nextLink(char* html, int* pos, const char** link, size_t* len,
+                  bool* relative)
+{
+  if (html == NULL || pos == NULL || link == NULL || len == NULL
+      || relative == NULL) {
+    return false;
+  }
+
+  //condense html on the first call, like webpage_getNextURL
+  if (*pos == 0) {
+    removeWhitespace(html);
+  }
+
+  while (true) {
+    //find the next "<a" tag and the href after it
+    const char* lnk = findCase(&html[*pos], "<a");
+    if (lnk == NULL) {
+      return false;
+    }
+    const char* href = findCase(lnk, "href=");
+    if (href == NULL) {
+      return false;
+    }
+    //skip this tag if its href belongs to a later tag
+    const char* end = strchr(lnk, '>');
+    if (end != NULL && end < href) {
+      *pos = lnk - html + 1;
+      continue;
+    }
+    href += 5;
+
+    //quoted urls end at the matching quote, unquoted ones at the tag end
+    if (*href == '\'' || *href == '"') {
+      char delim = *href++;
+      end = strchr(href, delim);
+    } else {
+      end = strchr(href, '>');
+    }
+    if (end == NULL || *href == '#') {
+      //can't tell where the url ends, or an internal reference
+      *pos = lnk - html + 1;
+      continue;
+    }
+    //exclude any #fragment
+    const char* hash = memchr(href, '#', end - href);
+    if (hash != NULL) {
+      end = hash;
+    }
+
+    //absolute if ':' comes before any '/', '?', or '#'
+    const char* ptr = strpbrk(href, ":/?#");
+    bool isRelative = (ptr == NULL || *ptr != ':');
+    if (!isRelative && !hasPrefix(href, 4, "http")) {
+      //absolute, but not http(s)
+      *pos = lnk - html + 1;
+      continue;
+    }
+
+    *pos = end - html;
+    *link = href;
+    *len = end - href;
+    *relative = isRelative;
+    return true;
+  }
+}
+
+/**************** url_resolve ****************/
+/* resolve a relative link against base */
+/* see url.h for more information */
+int url_resolve(const char* base, const char* rel, size_t len,
+                char* buf, size_t bufsize)
+{
+  if (base == NULL || rel == NULL || buf == NULL) {
+    return -1;
+  }
+
+  urlparts_t parts;
+  if (!parseParts(base, strlen(base), &parts)) {
+    return -1;
+  }
+
+  //relative to domain root, or to the base path up to its last '/'
+  bool fromRoot = (len > 0 && rel[0] == '/');
+  size_t dirLen = 0;
+  if (!fromRoot && parts.pathLen > 0) {
+    for (size_t i = parts.pathLen - 1; i > 0; i--) {
+      if (parts.path[i] == '/') {
+        dirLen = i;
+        break;
+      }
+    }
+  }
+  size_t total = parts.schemeLen + parts.userLen + parts.hostLen
+                 + dirLen + (fromRoot ? 0 : 1) + len;
+  if (total + 1 > bufsize) {
+    return -1;
+  }
+
+  //put the absolute url together, lowercasing scheme and host
+  char* out = buf;
+  for (size_t i = 0; i < parts.schemeLen; i++) {
+    *out++ = (char)tolower((unsigned char)parts.scheme[i]);
+  }
+  memcpy(out, parts.user, parts.userLen);
+  out += parts.userLen;
+  for (size_t i = 0; i < parts.hostLen; i++) {
+    *out++ = (char)tolower((unsigned char)parts.host[i]);
+  }
+  if (!fromRoot) {
+    memcpy(out, parts.path, dirLen);
+    out += dirLen;
+    *out++ = '/';
+  }
+  memcpy(out, rel, len);
+  out += len;
+  *out = '\0';
+  return out - buf;
+}
+
+/**************** url_isCanonical ****************/
+/* check whether url_normalize would return url unchanged */
+/* see url.h for more information */
+bool url_isCanonical(const char* url, size_t len)
+{
+  if (url == NULL) {
+    return false;
+  }
+
+  //lowercase http or https scheme
+  size_t i;
+  if (len >= 7 && memcmp(url, "http://", 7) == 0) {
+    i = 7;
+  } else if (len >= 8 && memcmp(url, "https://", 8) == 0) {
+    i = 8;
+  } else {
+    return false;
+  }
+
+  //lowercase host with no user info, ending at the first '/'
+  for ( ; i < len && url[i] != '/'; i++) {
+    char c = url[i];
+    if (isupper((unsigned char)c) || c == '@' || c == '?' || c == '#') {
+      return false;
+    }
+  }
+  if (i == len) {
+    //no path at all, normalizing fails
+    return false;
+  }
+
+  //path with no dot segments; each one starts with "/."
+  size_t pathStart = i;
+  for ( ; i < len && url[i] != '?' && url[i] != '#'; i++) {
+    if (url[i] == '/' && i + 1 < len && url[i + 1] == '.') {
+      return false;
+    }
+  }
+
+  return isHtmlPath(url + pathStart, i - pathStart);
+}
+
+/**************** url_normalize ****************/
+/* normalize url into buf */
+/* see url.h for more information */
+int url_normalize(const char* url, size_t len, char* buf, size_t bufsize)
+{
+  if (url == NULL || buf == NULL || bufsize < len + 1) {
+    return -1;
+  }
+
+  //fast path: already canonical, copy it over
+  if (url_isCanonical(url, len)) {
+    memcpy(buf, url, len);
+    buf[len] = '\0';
+    return len;
+  }
+
+  urlparts_t parts;
+  if (!parseParts(url, len, &parts)) {
+    return -1;
+  }
+  //urls without a path, or with an unknown file extension, are rejected
+  if (parts.pathLen == 0 || !isHtmlPath(parts.path, parts.pathLen)) {
+    return -1;
+  }
+
+  //put normalized url back together, lowercasing scheme and host
+  char* out = buf;
+  for (size_t i = 0; i < parts.schemeLen; i++) {
+    *out++ = (char)tolower((unsigned char)parts.scheme[i]);
+  }
+  memcpy(out, parts.user, parts.userLen);
+  out += parts.userLen;
+  for (size_t i = 0; i < parts.hostLen; i++) {
+    *out++ = (char)tolower((unsigned char)parts.host[i]);
+  }
+  out += removeDotSegments(parts.path, parts.pathLen, out);
+  memcpy(out, parts.tail, parts.tailLen);
+  out += parts.tailLen;
+  *out = '\0';
+
+  return out - buf;
+}
+
+/**************** local functions ****************/
+
+/**************** findAny ****************/
+/* like strpbrk, but stops at end instead of at a NUL */
+static const char* findAny(const char* s, const char* end, const char* set)
+{
+  for ( ; s < end; s++) {
+    if (strchr(set, *s) != NULL) {
+      return s;
+    }
+  }
+  return NULL;
+}
+
+/**************** findCase ****************/
+/* case-insensitive strstr; pattern must be lowercase */
+static const char* findCase(const char* s, const char* pattern)
+{
+  size_t patLen = strlen(pattern);
+  for ( ; *s != '\0'; s++) {
+    if (hasPrefix(s, patLen, pattern)) {
+      return s;
+    }
+  }
+  return NULL;
+}
+
+/**************** hasPrefix ****************/
+/* check whether s (len bytes) starts with prefix, ignoring case */
+static bool hasPrefix(const char* s, size_t len, const char* prefix)
+{
+  size_t i;
+  for (i = 0; prefix[i] != '\0'; i++) {
+    if (i >= len || tolower((unsigned char)s[i]) != prefix[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**************** isExactly ****************/
+/* check whether s (len bytes) is exactly word */
+static bool isExactly(const char* s, size_t len, const char* word)
+{
+  return (strlen(word) == len && memcmp(s, word, len) == 0);
+}
+
+/**************** parseParts ****************/
+/* split an absolute url into its pieces, following parseURL in libcs50
+ * returns false if the url is not absolute or can't be parsed
+ */
+static bool parseParts(const char* url, size_t len, urlparts_t* parts)
+{
+  const char* end = url + len;
+  memset(parts, 0, sizeof(urlparts_t));
+
+  //absolute url: ':' must precede any '/', '?', or '#'
+  const char* schemeEnd = findAny(url, end, ":/?#");
+  if (schemeEnd == NULL || *schemeEnd != ':') {
+    return false;
+  }
+  schemeEnd++;
+  if (end - schemeEnd >= 2 && schemeEnd[0] == '/' && schemeEnd[1] == '/') {
+    schemeEnd += 2;
+  }
+  parts->scheme = url;
+  parts->schemeLen = schemeEnd - url;
+
+  //user information is anything before an '@' that precedes every '/'
+  const char* userEnd = findAny(schemeEnd, end, "@/");
+  if (userEnd != NULL && *userEnd == '/') {
+    userEnd = NULL;
+  }
+  const char* hostBeg = schemeEnd;
+  //without it, user is empty but not NULL, so it can always be copied
+  parts->user = schemeEnd;
+  if (userEnd != NULL) {
+    userEnd++;
+    parts->userLen = userEnd - schemeEnd;
+    hostBeg = userEnd;
+  }
+
+  //host runs up to the first '/'
+  const char* hostEnd = memchr(schemeEnd, '/', end - schemeEnd);
+  if (hostEnd == NULL) {
+    hostEnd = end;
+  }
+  parts->host = hostBeg;
+  parts->hostLen = hostEnd - hostBeg;
+
+  //path runs up to the first '?' or '#'; the rest is query and fragment
+  const char* pathEnd = findAny(schemeEnd, end, "?#");
+  if (pathEnd == NULL) {
+    pathEnd = end;
+  } else if (pathEnd < hostEnd) {
+    //'?' or '#' inside the host, libcs50 can't parse this either
+    return false;
+  }
+  parts->path = hostEnd;
+  parts->pathLen = pathEnd - hostEnd;
+  parts->tail = pathEnd;
+  parts->tailLen = end - pathEnd;
+  return true;
+}
+
+/**************** isHtmlPath ****************/
+/* check the file extension of path against the known html extensions
+ * paths without an extension are accepted
+ */
+static bool isHtmlPath(const char* path, size_t len)
+{
+  //find last '.' and last '/'
+  const char* dot = NULL;
+  const char* slash = NULL;
+  for (const char* p = path; p < path + len; p++) {
+    if (*p == '.') {
+      dot = p;
+    } else if (*p == '/') {
+      slash = p;
+    }
+  }
+  if (dot == NULL || slash == NULL || dot < slash) {
+    return true;
+  }
+
+  //extension begins after '.'
+  const char* ext = dot + 1;
+  size_t extLen = path + len - ext;
+  if (extLen == 0) {
+    return true;
+  }
+  for (int i = 0; EXTS[i] != NULL; i++) {
+    if (hasPrefix(ext, extLen, EXTS[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**************** removeDotSegments ****************/
+/* remove "." and ".." segments from a path, per RFC 3986 section 5.2.4,
+ * writing the result to out; returns the length written
+ * out is never longer than the input
+ */
+static size_t removeDotSegments(const char* in, size_t len, char* out)
+{
+  const char* end = in + len;
+  char* outp = out;
+
+  do {
+    size_t left = end - in;
+    bool popSegment = false;
+
+    if (hasPrefix(in, left, "./")) {
+      in += 2;
+    } else if (hasPrefix(in, left, "../")) {
+      in += 3;
+    } else if (hasPrefix(in, left, "/./")) {
+      in += 2;
+    } else if (isExactly(in, left, "/.")) {
+      //replace "/." with "/"
+      in = "/";
+      end = in + 1;
+    } else if (hasPrefix(in, left, "/../")) {
+      in += 3;
+      popSegment = true;
+    } else if (isExactly(in, left, "/..")) {
+      //replace "/.." with "/"
+      in = "/";
+      end = in + 1;
+      popSegment = true;
+    } else if (isExactly(in, left, ".") || isExactly(in, left, "..")) {
+      in = end;
+    } else {
+      //move the first segment, with its leading '/', to the output
+      do {
+        *outp++ = *in++;
+      } while (in < end && *in != '/');
+    }
+
+    if (popSegment) {
+      //remove the last segment and its preceding '/' from the output
+      while (outp > out) {
+        outp--;
+        if (*outp == '/') {
+          break;
+        }
+      }
+    }
+  } while (in < end);
+
+  return outp - out;
+}
+
+/**************** removeWhitespace ****************/
+/* condense all non-whitespace toward the beginning of str */
+static void removeWhitespace(char* str)
+{
+  char* prev = str;
+  char* cur = str;
+
+  do {
+    while (isspace((unsigned char)*cur)) {
+      cur++;
+    }
+  } while ((*prev++ = *cur++));
+}
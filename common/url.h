@@ -0,0 +1,90 @@
+/*
+ * url.h - header file for CS50 'url' module
+ *
+ * url is a module that extracts, resolves, and normalizes the links
+ * found on a webpage without allocating memory. Inputs are string views
+ * (a pointer and a length, not necessarily NUL-terminated) and results
+ * are written into a buffer provided by the caller, so one buffer can be
+ * reused for every link on every page.
+ *
+ * The results are identical to those of webpage_getNextURL and
+ * normalizeURL in libcs50, which malloc several intermediate strings
+ * per link.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef URL_H
+#define URL_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**************** functions ****************/
+
+/**************** url_nextLink ****************/
+/* Find the next link in an html document, starting at html[*pos].
+ *
+ * Caller provides:
+ *   html - the page's html, which we may modify (see below)
+ *   pos - position to start searching, 0 on the first call for a page
+ *   link - where to store a pointer to the first character of the link
+ *   len - where to store the length of the link
+ *   relative - where to store whether the link is relative
+ * We return:
+ *   true if a link was found, false if there are no more links.
+ * We guarantee:
+ *   *link points into html and is not NUL-terminated;
+ *   *pos is advanced past the link, for use in the next call;
+ *   on the first call (*pos == 0) whitespace is removed from html,
+ *   exactly like webpage_getNextURL does.
+ */
+bool url_nextLink(char* html, int* pos, const char** link, size_t* len,
+                  bool* relative);
+
+/**************** url_resolve ****************/
+/* Resolve a relative link against the (normalized) URL of its page.
+ *
+ * Caller provides:
+ *   base - NUL-terminated url of the page the link was found on
+ *   rel, len - the relative link, as found by url_nextLink
+ *   buf, bufsize - buffer for the result
+ * We return:
+ *   length of the absolute url written to buf (NUL-terminated),
+ *   or -1 if base can't be parsed or buf is too small.
+ * Notes:
+ *   a buffer of strlen(base) + len + 2 bytes is always large enough.
+ */
+int url_resolve(const char* base, const char* rel, size_t len,
+                char* buf, size_t bufsize);
+
+/**************** url_isCanonical ****************/
+/* Check whether a url is already in normalized form.
+ *
+ * We return:
+ *   true if url_normalize would return the url unchanged, false if
+ *   it needs the full parse (or can't be normalized at all).
+ * We guarantee:
+ *   the check is a single scan over the url, with no copying.
+ */
+bool url_isCanonical(const char* url, size_t len);
+
+/**************** url_normalize ****************/
+/* Normalize an absolute url, as normalizeURL does in libcs50.
+ *
+ * Caller provides:
+ *   url, len - the url to normalize
+ *   buf, bufsize - buffer for the result, at least len + 1 bytes;
+ *   it must not overlap url
+ * We return:
+ *   length of the normalized url written to buf (NUL-terminated), or
+ *   -1 if the url can't be parsed or normalized, if it refers to a file
+ *   unlikely to contain html, or if buf is too small.
+ * Notes:
+ *   the result is never longer than the input. Urls that are already
+ *   canonical take a fast path that skips parsing entirely.
+ */
+int url_normalize(const char* url, size_t len, char* buf, size_t bufsize);
+
+#endif // URL_H
@@ -0,0 +1,296 @@
+/*
+ * urlset.c - CS50 'urlset' module
+ *
+ * see urlset.h for more information.
+ *
+ * The table is an array of fingerprints probed linearly; a fingerprint
+ * of 0 marks an empty slot. In exact mode a second array holds, for
+ * each slot, the offset of its URL in one contiguous pool of strings.
+ * The optional bloom filter is keyed by the same fingerprints.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "bloom.h"
+#include "urlset.h"
+
+/**************** local types ****************/
+typedef struct urlset {
+  uint64_t* slots;          // fingerprints, 0 if the slot is empty
+  size_t* offsets;          // exact mode: offset of each slot's url in pool
+  char* pool;               // exact mode: every url, NUL-terminated
+  size_t poolSize;          // bytes of pool in use
+  size_t poolCapacity;      // bytes allocated for pool
+  size_t capacity;          // number of slots, a power of 2
+  int count;                // number of urls in the set
+  bool exact;               // verify fingerprint matches against pool
+  bloom_t* filter;          // optional pre-check, NULL if none
+  long definiteMisses;      // filter said new, table not searched
+  long possibleHits;        // filter said maybe, table searched
+  long falsePositives;      // ... and the url was new after all
+} urlset_t;
+
+/**************** local functions ****************/
+static size_t findSlot(urlset_t* set, const uint64_t fp, const char* url);
+static bool grow(urlset_t* set);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** urlset_new ****************/
+/* see urlset.h for more information */
+urlset_t* urlset_new(const int expected, const bool exact) {
+  urlset_t* set = mem_malloc(sizeof(urlset_t));
+  if (set == NULL) {
+    return NULL;
+  }
+
+  //smallest power of 2 that holds expected urls below 3/4 full
+  size_t capacity = 64;
+  while (expected > 0 && capacity * 3 < (size_t)expected * 4) {
+    capacity *= 2;
+  }
+
+  set->capacity = capacity;
+  set->count = 0;
+  set->exact = exact;
+  set->slots = calloc(capacity, sizeof(uint64_t));
+  set->offsets = NULL;
+  set->pool = NULL;
+  set->poolSize = 0;
+  set->poolCapacity = 0;
+  set->filter = NULL;
+  set->definiteMisses = 0;
+  set->possibleHits = 0;
+  set->falsePositives = 0;
+  if (exact) {
+    set->offsets = malloc(capacity * sizeof(size_t));
+  }
+  if (set->slots == NULL || (exact && set->offsets == NULL)) {
+    urlset_delete(set);
+    return NULL;
+  }
+  return set;
+}
+
+/**************** urlset_addFilter ****************/
+/* see urlset.h for more information */
+bool urlset_addFilter(urlset_t* set, const int expected, const double fpRate) {
+  if (set == NULL || set->count != 0 || set->filter != NULL) {
+    return false;
+  }
+  set->filter = bloom_new(expected, fpRate);
+  return (set->filter != NULL);
+}
+
+/**************** urlset_fingerprint ****************/
+/* 64-bit FNV-1a, with a final mix so the low bits used to pick a slot
+ * depend on every character */
+/* see urlset.h for more information */
+uint64_t urlset_fingerprint(const char* url) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const unsigned char* p = (const unsigned char*)url; *p != '\0'; p++) {
+    hash ^= *p;
+    hash *= 0x100000001b3ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+
+  //0 marks empty slots
+  return (hash == 0) ? 1 : hash;
+}
+
+/**************** urlset_insert ****************/
+/* see urlset.h for more information */
+bool urlset_insert(urlset_t* set, const char* url) {
+  if (set == NULL || url == NULL) {
+    return false;
+  }
+
+  uint64_t fp = urlset_fingerprint(url);
+
+  //without a filter every url may have been seen
+  bool maybeSeen = true;
+  if (set->filter != NULL) {
+    maybeSeen = bloom_check(set->filter, fp);
+    if (maybeSeen) {
+      set->possibleHits++;
+    } else {
+      set->definiteMisses++;
+    }
+  }
+  //the empty slot the url goes in, once a probe has found it
+  size_t slot = 0;
+  bool haveSlot = false;
+  if (maybeSeen) {
+    slot = findSlot(set, fp, url);
+    if (set->slots[slot] != 0) {
+      //already seen
+      return false;
+    }
+    haveSlot = true;
+    if (set->filter != NULL) {
+      set->falsePositives++;
+    }
+  }
+
+  //keep the table under 3/4 full; growing moves every slot
+  if ((size_t)(set->count + 1) * 4 > set->capacity * 3) {
+    if (!grow(set)) {
+      return false;
+    }
+    haveSlot = false;
+  }
+  //no slot holds this fingerprint, so this only looks for an empty one
+  if (!haveSlot) {
+    slot = findSlot(set, fp, url);
+  }
+
+  if (set->exact) {
+    //append a copy of the url to the pool
+    size_t len = strlen(url) + 1;
+    if (set->poolSize + len > set->poolCapacity) {
+      size_t newCapacity = (set->poolCapacity == 0) ? 4096 : set->poolCapacity;
+      while (set->poolSize + len > newCapacity) {
+        newCapacity *= 2;
+      }
+      char* newPool = realloc(set->pool, newCapacity);
+      if (newPool == NULL) {
+        return false;
+      }
+      set->pool = newPool;
+      set->poolCapacity = newCapacity;
+    }
+    memcpy(set->pool + set->poolSize, url, len);
+    set->offsets[slot] = set->poolSize;
+    set->poolSize += len;
+  }
+
+  set->slots[slot] = fp;
+  set->count++;
+  bloom_add(set->filter, fp);
+  return true;
+}
+
+/**************** urlset_contains ****************/
+/* see urlset.h for more information */
+bool urlset_contains(urlset_t* set, const char* url) {
+  if (set == NULL || url == NULL) {
+    return false;
+  }
+  uint64_t fp = urlset_fingerprint(url);
+  return (set->slots[findSlot(set, fp, url)] != 0);
+}
+
+/**************** urlset_size ****************/
+/* see urlset.h for more information */
+int urlset_size(urlset_t* set) {
+  return (set == NULL) ? 0 : set->count;
+}
+
+/**************** urlset_memory ****************/
+/* see urlset.h for more information */
+size_t urlset_memory(urlset_t* set) {
+  if (set == NULL) {
+    return 0;
+  }
+  size_t bytes = sizeof(urlset_t) + set->capacity * sizeof(uint64_t);
+  if (set->exact) {
+    bytes += set->capacity * sizeof(size_t) + set->poolCapacity;
+  }
+  return bytes + bloom_memory(set->filter);
+}
+
+/**************** urlset_printStats ****************/
+/* see urlset.h for more information */
+void urlset_printStats(urlset_t* set, FILE* fp) {
+  if (set == NULL || set->filter == NULL || fp == NULL) {
+    return;
+  }
+  long checks = set->definiteMisses + set->possibleHits;
+  long newURLs = set->definiteMisses + set->falsePositives;
+  double rate = (newURLs == 0) ? 0 : 100.0 * set->falsePositives / newURLs;
+  fprintf(fp, "Filter: %ld checked, %ld definite misses, %ld possible hits, "
+          "%ld false positives (%.2f%% false-positive rate)\n",
+          checks, set->definiteMisses, set->possibleHits,
+          set->falsePositives, rate);
+}
+
+/**************** urlset_delete ****************/
+/* see urlset.h for more information */
+void urlset_delete(urlset_t* set) {
+  if (set != NULL) {
+    free(set->slots);
+    free(set->offsets);
+    free(set->pool);
+    bloom_delete(set->filter);
+    mem_free(set);
+  }
+}
+
+/**************** findSlot ****************/
+/* find the slot holding url, or the empty slot where it would go
+ * not visible to outsiders, not in urlset.h
+ */
+static size_t findSlot(urlset_t* set, const uint64_t fp, const char* url) {
+  size_t mask = set->capacity - 1;
+  size_t slot = fp & mask;
+  while (set->slots[slot] != 0) {
+    if (set->slots[slot] == fp
+        && (!set->exact || strcmp(set->pool + set->offsets[slot], url) == 0)) {
+      return slot;
+    }
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+/**************** grow ****************/
+/* double the number of slots and re-insert every fingerprint
+ * returns false, leaving the set unchanged, if out of memory
+ * not visible to outsiders, not in urlset.h
+ */
+static bool grow(urlset_t* set) {
+  size_t newCapacity = set->capacity * 2;
+  size_t mask = newCapacity - 1;
+  uint64_t* newSlots = calloc(newCapacity, sizeof(uint64_t));
+  size_t* newOffsets = NULL;
+  if (set->exact) {
+    newOffsets = malloc(newCapacity * sizeof(size_t));
+  }
+  if (newSlots == NULL || (set->exact && newOffsets == NULL)) {
+    free(newSlots);
+    free(newOffsets);
+    return false;
+  }
+
+  for (size_t i = 0; i < set->capacity; i++) {
+    uint64_t fp = set->slots[i];
+    if (fp != 0) {
+      size_t slot = fp & mask;
+      while (newSlots[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      newSlots[slot] = fp;
+      if (set->exact) {
+        newOffsets[slot] = set->offsets[i];
+      }
+    }
+  }
+
+  free(set->slots);
+  free(set->offsets);
+  set->slots = newSlots;
+  set->offsets = newOffsets;
+  set->capacity = newCapacity;
+  return true;
+}
@@ -0,0 +1,113 @@
+/*
+ * urlset.h - header file for CS50 'urlset' module
+ *
+ * a urlset remembers which URLs the crawler has already seen.
+ * Instead of a copy of each URL it stores a 64-bit fingerprint (hash)
+ * of it, in an open-addressed table that doubles in size as it fills,
+ * so memory stays at a few bytes per URL however long the URLs are.
+ *
+ * Two different URLs with the same fingerprint would be taken for the
+ * same URL; with 64 bits that is vanishingly unlikely even for millions
+ * of URLs. For crawls that must be exact, the set can also keep a copy
+ * of every URL and compare it whenever fingerprints match.
+ *
+ * Optionally, a bloom filter sits in front of the table: URLs it has
+ * definitely never seen are added without searching the table, and
+ * only possible repeats are verified. The set counts how often the
+ * filter was right, so its false-positive rate can be reported.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef URLSET_H
+#define URLSET_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**************** global types ****************/
+typedef struct urlset urlset_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** urlset_new ****************/
+/* Create a new (empty) urlset.
+ *
+ * Caller provides:
+ *   expected - number of URLs expected, used to size the table
+ *     (the set grows past it as needed; 0 picks a small default)
+ *   exact - true to keep a copy of every URL and verify fingerprint
+ *     matches against it
+ * We return:
+ *   pointer to a new urlset, or NULL if error.
+ * Caller is responsible for:
+ *   later calling urlset_delete.
+ */
+urlset_t* urlset_new(const int expected, const bool exact);
+
+/**************** urlset_addFilter ****************/
+/* Put a bloom filter in front of an empty set.
+ *
+ * Caller provides:
+ *   valid set pointer, for a set with nothing inserted yet
+ *   expected - number of URLs expected, > 0
+ *   fpRate - target false-positive rate of the filter, e.g. 0.01
+ * We return:
+ *   true if the filter was added, false if error, invalid parameters,
+ *   or if the set is not empty (the filter must see every URL).
+ */
+bool urlset_addFilter(urlset_t* set, const int expected, const double fpRate);
+
+/**************** urlset_fingerprint ****************/
+/* Compute the 64-bit fingerprint urlset uses for a URL.
+ *
+ * We return:
+ *   the fingerprint of url, never 0.
+ */
+uint64_t urlset_fingerprint(const char* url);
+
+/**************** urlset_insert ****************/
+/* Add a URL to the set.
+ *
+ * Caller provides:
+ *   valid set pointer, valid URL string.
+ * We return:
+ *   true if the URL is new and was added,
+ *   false if it was already in the set, or on any error.
+ * We guarantee:
+ *   the URL string is not kept (in exact mode a copy is).
+ */
+bool urlset_insert(urlset_t* set, const char* url);
+
+/**************** urlset_contains ****************/
+/* Check whether a URL is in the set.
+ *
+ * We return:
+ *   true if the URL was inserted earlier, false if not.
+ * We guarantee:
+ *   the set is unchanged.
+ */
+bool urlset_contains(urlset_t* set, const char* url);
+
+/**************** urlset_size ****************/
+/* Return the number of URLs in the set, or 0 if set is NULL. */
+int urlset_size(urlset_t* set);
+
+/**************** urlset_memory ****************/
+/* Return the number of bytes allocated for the set, or 0 if NULL. */
+size_t urlset_memory(urlset_t* set);
+
+/**************** urlset_printStats ****************/
+/* Print the bloom filter's counters to fp, on one line: URLs checked,
+ * definite misses, possible hits, false positives, and the observed
+ * false-positive rate (false positives over all URLs that were new).
+ * Prints nothing if the set has no filter.
+ */
+void urlset_printStats(urlset_t* set, FILE* fp);
+
+/**************** urlset_delete ****************/
+/* Delete the set and everything it holds; we ignore NULL set. */
+void urlset_delete(urlset_t* set);
+
+#endif // URLSET_H
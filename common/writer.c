@@ -0,0 +1,153 @@
+/*
+ * writer.c - CS50 'writer' module
+ *
+ * see writer.h for more information.
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "mem.h"
+#include "writer.h"
+
+/**************** local constants ****************/
+#define INT_DIGITS 12                     // enough for "-2147483648"
+static const size_t BUFFER_SIZE = 65536;  // bytes buffered between writes
+
+/**************** local types ****************/
+typedef struct writer {
+  FILE* fp;
+  char* buf;
+  size_t used;              // bytes of buf waiting to be written
+  bool failed;              // some fwrite fell short
+} writer_t;
+
+/**************** local functions ****************/
+static void makeRoom(writer_t* writer, const size_t len);
+
+/**************** global functions ****************/
+/* that is, visible outside this file */
+
+/**************** writer_new ****************/
+/* see writer.h for more information */
+writer_t* writer_new(FILE* fp) {
+  if (fp == NULL) {
+    return NULL;
+  }
+  writer_t* writer = mem_malloc(sizeof(writer_t));
+  if (writer == NULL) {
+    return NULL;
+  }
+  writer->buf = malloc(BUFFER_SIZE);
+  if (writer->buf == NULL) {
+    mem_free(writer);
+    return NULL;
+  }
+  writer->fp = fp;
+  writer->used = 0;
+  writer->failed = false;
+  return writer;
+}
+
+/**************** writer_putString ****************/
+/* see writer.h for more information */
+void writer_putString(writer_t* writer, const char* s) {
+  if (s != NULL) {
+    writer_putBytes(writer, s, strlen(s));
+  }
+}
+
+/**************** writer_putBytes ****************/
+/* see writer.h for more information */
+void writer_putBytes(writer_t* writer, const void* bytes, const size_t len) {
+  if (writer == NULL || bytes == NULL) {
+    return;
+  }
+  if (len > BUFFER_SIZE) {
+    //too big to buffer, write it straight through
+    writer_flush(writer);
+    if (fwrite(bytes, 1, len, writer->fp) != len) {
+      writer->failed = true;
+    }
+    return;
+  }
+  makeRoom(writer, len);
+  memcpy(writer->buf + writer->used, bytes, len);
+  writer->used += len;
+}
+
+/**************** writer_putChar ****************/
+/* see writer.h for more information */
+void writer_putChar(writer_t* writer, const char c) {
+  if (writer == NULL) {
+    return;
+  }
+  makeRoom(writer, 1);
+  writer->buf[writer->used++] = c;
+}
+
+/**************** writer_putInt ****************/
+/* see writer.h for more information */
+void writer_putInt(writer_t* writer, const int n) {
+  if (writer == NULL) {
+    return;
+  }
+  makeRoom(writer, INT_DIGITS);
+
+  //digits come out last first, so fill a scratch array from its end;
+  //unsigned so that the most negative int can be negated
+  char digits[INT_DIGITS];
+  char* p = digits + INT_DIGITS;
+  unsigned int value = (n < 0) ? 0u - (unsigned int)n : (unsigned int)n;
+  do {
+    *--p = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  if (n < 0) {
+    *--p = '-';
+  }
+
+  size_t len = digits + INT_DIGITS - p;
+  memcpy(writer->buf + writer->used, p, len);
+  writer->used += len;
+}
+
+/**************** writer_flush ****************/
+/* see writer.h for more information */
+bool writer_flush(writer_t* writer) {
+  if (writer == NULL) {
+    return false;
+  }
+  if (writer->used > 0) {
+    if (fwrite(writer->buf, 1, writer->used, writer->fp) != writer->used) {
+      writer->failed = true;
+    }
+    writer->used = 0;
+  }
+  return !writer->failed;
+}
+
+/**************** writer_delete ****************/
+/* see writer.h for more information */
+bool writer_delete(writer_t* writer) {
+  if (writer == NULL) {
+    return false;
+  }
+  bool ok = writer_flush(writer);
+  free(writer->buf);
+  mem_free(writer);
+  return ok;
+}
+
+/**************** makeRoom ****************/
+/* flush the buffer if fewer than len bytes of it are free
+ * not visible to outsiders, not in writer.h
+ */
+static void makeRoom(writer_t* writer, const size_t len) {
+  if (writer->used + len > BUFFER_SIZE) {
+    writer_flush(writer);
+  }
+}
@@ -0,0 +1,67 @@
+/*
+ * writer.h - header file for CS50 'writer' module
+ *
+ * a writer collects output in a large buffer and hands it to the file
+ * in big fwrite calls, formatting integers by hand instead of through
+ * fprintf. It is meant for files written a small piece at a time, like
+ * the index: a word, then a docID, a count, a docID, a count...
+ *
+ * Bora Bozdogan, April 2025
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**************** global types ****************/
+typedef struct writer writer_t;  // opaque to users of the module
+
+/**************** functions ****************/
+
+/**************** writer_new ****************/
+/* Create a writer that writes to fp.
+ *
+ * Caller provides:
+ *   valid FILE pointer, open for writing.
+ * We return:
+ *   pointer to a new writer, or NULL if error.
+ * Caller is responsible for:
+ *   later calling writer_delete, then closing fp.
+ */
+writer_t* writer_new(FILE* fp);
+
+/**************** writer_putString ****************/
+/* Append a string, without its NUL. */
+void writer_putString(writer_t* writer, const char* s);
+
+/**************** writer_putBytes ****************/
+/* Append len bytes, which may include NULs. */
+void writer_putBytes(writer_t* writer, const void* bytes, const size_t len);
+
+/**************** writer_putChar ****************/
+/* Append one character. */
+void writer_putChar(writer_t* writer, const char c);
+
+/**************** writer_putInt ****************/
+/* Append n in decimal, as printf's "%d" would. */
+void writer_putInt(writer_t* writer, const int n);
+
+/**************** writer_flush ****************/
+/* Write out everything buffered so far.
+ *
+ * We return:
+ *   false if this or any earlier write to the file failed, true otherwise.
+ */
+bool writer_flush(writer_t* writer);
+
+/**************** writer_delete ****************/
+/* Flush and delete the writer (but not close its FILE).
+ *
+ * We return:
+ *   false if any write to the file failed, true otherwise.
+ */
+bool writer_delete(writer_t* writer);
+
+#endif // WRITER_H
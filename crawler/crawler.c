@@ -11,18 +11,38 @@
 #include <string.h>
 #include "mem.h"
 #include "webpage.h"
-#include "hashtable.h"
-#include "bag.h"
+#include "frontier.h"
 #include "pagedir.h"
 #include "file.h"
+#include "url.h"
+#include "urlset.h"
+#include "metrics.h"
 
+//optional settings, given as flags after the three required arguments
+typedef struct crawlOptions {
+    bool exactVisited;      // --exact: verify visited fingerprints against urls
+    int expectedURLs;       // --expected N: size visited set, add bloom filter
+    frontierPolicy_t policy;  // --frontier bfs|host|depth: crawl order
+    int maxPending;         // --max-pending N: bound the frontier, 0 if none
+    char* spillDir;         // --spill-dir DIR: spill the frontier to disk
+    int memLimit;           // --mem-limit N: pages in memory before spilling
+    bool quiet;             // --quiet: no line per page and link
+    char* metricsFile;      // --metrics FILE: dump metrics as JSON, - for stdout
+    int metricsEvery;       // --metrics-every N: pages between dumps
+} crawlOptions_t;
 
 static void parseArgs(const int argc, char* argv[],
-                      char** seedURL, char** pageDirectory, int* maxDepth);
+                      char** seedURL, char** pageDirectory, int* maxDepth,
+                      crawlOptions_t* options);
 
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth);
+static void crawl(char* seedURL, char* pageDirectory, const int maxDepth,
+                  const crawlOptions_t* options);
 
-static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen);
+static void pageScan(webpage_t* page, frontier_t* pagesToCrawl, urlset_t* pagesSeen,
+                     char* linkBuf, const size_t linkBufSize,
+                     metrics_t* metrics, const bool quiet);
+
+static void dumpMetrics(metrics_t* metrics, const crawlOptions_t* options, const bool done);
 
 /* ***************************
  *  main - start of crawler.c
@@ -38,20 +58,27 @@ static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSee
  *    checks if argument number valid, else returns nonzero
  *    assigns arguments to variables, calls parseArgs
  *    if parseArgs successful, runs crawl with the args
+ *
+ *  Usage:
+ *    crawler seedURL pageDirectory maxDepth [--exact] [--expected N]
+ *      [--frontier bfs|host|depth] [--max-pending N]
+ *      [--spill-dir DIR [--mem-limit N]] [--quiet]
+ *      [--metrics FILE [--metrics-every N]]
  *   
  */
 int
 main (int argc, char* argv[])
 {
-    if (argc == 4) {
+    if (argc >= 4) {
         //parse command line
         char* seedURL = argv[1];
         char* pageDirectory = argv[2];
         int maxDepth = atoi(argv[3]);
-        parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth);
+        crawlOptions_t options;
+        parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth, &options);
 
         //run crawl
-        crawl(seedURL, pageDirectory, maxDepth);
+        crawl(seedURL, pageDirectory, maxDepth, &options);
     } else {
         fprintf(stderr, "\ninvalid argument number, please input 3\n");
         return 1;
@@ -67,6 +94,7 @@ main (int argc, char* argv[])
  *    seedURL - char** pointer to initial url string
  *    pageDirectory - char** pointer to page directory to save pages
  *    maxDepth - int* pointer to max depth to search                                                                             
+ *    options - crawlOptions_t* pointer to optional settings to fill in
  *                                                                                                                
  *  Returns:                                                                                                    
  *    void
@@ -75,10 +103,66 @@ main (int argc, char* argv[])
  *    checks if seedURL can be normalized, and normalizedURL is internal
  *    checks if pageDirectory can be initialized    
  *    checks if maxDepth in the specified range
+ *    checks that every argument after maxDepth is a known flag
  *    completes successfuly if all checks valid, else, exits nonzero                                          
  */
 static void parseArgs(const int argc, char* argv[],
-                      char** seedURL, char** pageDirectory, int* maxDepth) {
+                      char** seedURL, char** pageDirectory, int* maxDepth,
+                      crawlOptions_t* options) {
+
+    //defaults, overridden by flags below
+    options->exactVisited = false;
+    options->expectedURLs = 0;
+    options->policy = FRONTIER_BFS;
+    options->maxPending = 0;
+    options->spillDir = NULL;
+    options->memLimit = 100000;
+    options->quiet = false;
+    options->metricsFile = NULL;
+    options->metricsEvery = 100;
+    for (int i = 4; i < argc; i++) {
+        if (strcmp(argv[i], "--exact") == 0) {
+            options->exactVisited = true;
+        } else if (strcmp(argv[i], "--expected") == 0 && i + 1 < argc) {
+            options->expectedURLs = atoi(argv[++i]);
+            if (options->expectedURLs <= 0) {
+                fprintf(stderr, "\nInvalid expected URL count '%s'\n", argv[i]);
+                exit(1);
+            }
+        } else if (strcmp(argv[i], "--frontier") == 0 && i + 1 < argc) {
+            if (!frontier_parsePolicy(argv[++i], &options->policy)) {
+                fprintf(stderr, "\nInvalid frontier '%s', please choose bfs, host or depth\n", argv[i]);
+                exit(1);
+            }
+        } else if (strcmp(argv[i], "--max-pending") == 0 && i + 1 < argc) {
+            options->maxPending = atoi(argv[++i]);
+            if (options->maxPending <= 0) {
+                fprintf(stderr, "\nInvalid max pending count '%s'\n", argv[i]);
+                exit(1);
+            }
+        } else if (strcmp(argv[i], "--spill-dir") == 0 && i + 1 < argc) {
+            options->spillDir = argv[++i];
+        } else if (strcmp(argv[i], "--mem-limit") == 0 && i + 1 < argc) {
+            options->memLimit = atoi(argv[++i]);
+            if (options->memLimit <= 0) {
+                fprintf(stderr, "\nInvalid memory limit '%s'\n", argv[i]);
+                exit(1);
+            }
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            options->quiet = true;
+        } else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+            options->metricsFile = argv[++i];
+        } else if (strcmp(argv[i], "--metrics-every") == 0 && i + 1 < argc) {
+            options->metricsEvery = atoi(argv[++i]);
+            if (options->metricsEvery <= 0) {
+                fprintf(stderr, "\nInvalid metrics interval '%s'\n", argv[i]);
+                exit(1);
+            }
+        } else {
+            fprintf(stderr, "\nInvalid option '%s'\n", argv[i]);
+            exit(1);
+        }
+    }
     
     char* normalizedUrl = normalizeURL(*seedURL);
     //if internal, and can be normalized
@@ -115,124 +199,284 @@ static void parseArgs(const int argc, char* argv[],
  *    seedURL - char* url of initial website to start crawl                                                                             
  *    pageDirectory - char* address to store valid pages
  *    maxDepth - const int max depth value to search pages                                                                            
+ *    options - const crawlOptions_t* optional settings
  *                                                                                                                
  *  Returns:                                                                                                    
  *    void
  *
  *  Behavior:
  *    goes through every page, checks all the links, save as webpages if link
- *    is internal and valid.                                                   
+ *    is internal and valid.
+ *    times each stage of handling a page and counts pages, bytes and links;
+ *    with --metrics, dumps them every metricsEvery pages and at the end.
  */
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth) {
+static void crawl(char* seedURL, char* pageDirectory, const int maxDepth,
+                  const crawlOptions_t* options) {
     //crawl from seedURL to maxDepth and save pages in pageDirectory
     //initialize docId counter
     int docId = 1;
 
-    //initialize hashtable urls, add seedUrl 
-    hashtable_t* visited = hashtable_new(200); //200 slots is stated to be used
-    hashtable_insert(visited, seedURL, "");
+    //initialize set of visited urls, add seedUrl
+    //the set grows as needed, 200 is only its starting size
+    int expected = (options->expectedURLs > 0) ? options->expectedURLs : 200;
+    urlset_t* visited = urlset_new(expected, options->exactVisited);
+    if (visited == NULL) {
+        fprintf(stderr, "\nCouldn't create visited set\n");
+        exit(1);
+    }
+    //with an expected count, screen new urls with a bloom filter first
+    if (options->expectedURLs > 0
+        && !urlset_addFilter(visited, options->expectedURLs, 0.01)) {
+        fprintf(stderr, "\nCouldn't create visited filter\n");
+        exit(1);
+    }
+    urlset_insert(visited, seedURL);
     
-    //initialize bag and add webpage at depth 0
-    bag_t* toVisit = bag_new();
+    //initialize frontier and add webpage at depth 0
+    frontier_t* toVisit = frontier_new(options->policy, options->maxPending);
+    if (toVisit == NULL) {
+        fprintf(stderr, "\nCouldn't create frontier\n");
+        exit(1);
+    }
+    //past memLimit pending pages, spill the newest to disk
+    if (options->spillDir != NULL
+        && !frontier_setSpill(toVisit, options->spillDir, options->memLimit)) {
+        fprintf(stderr, "\nCouldn't set up frontier spill directory\n");
+        exit(1);
+    }
     webpage_t* init = webpage_new(seedURL, 0, NULL);
     if (init == NULL) {
         fprintf(stderr, "\nCouldn't create webpage\n");
         exit(1);
     } 
-    bag_insert(toVisit, init);
+    frontier_insert(toVisit, init);
+
+    //where the time goes, and how many pages, bytes and links
+    metrics_t* metrics = metrics_new();
+    if (metrics == NULL) {
+        fprintf(stderr, "\nCouldn't create metrics\n");
+        exit(1);
+    }
+
+    //buffer reused by pageScan to resolve and normalize links
+    char* linkBuf = NULL;
+    size_t linkBufSize = 0;
+
     webpage_t *webpage;
-    //while bag not empty, pull a webpage
-    while ((webpage = bag_extract(toVisit)) != NULL) {
+    //while frontier not empty, pull the next webpage
+    while ((webpage = frontier_extract(toVisit)) != NULL) {
         //fetch the HTML for it
-        if (webpage_fetch(webpage) == false) {
+        double start = metrics_now();
+        bool fetched = webpage_fetch(webpage);
+        double end = metrics_now();
+        metrics_time(metrics, METRICS_FETCH, start, end);
+        if (fetched == false) {
+            metrics_count(metrics, METRICS_FAILURES, 1);
+            dumpMetrics(metrics, options, false);
             fprintf(stderr, "\nCouldn't get html for webpage\n");
             exit(1);
         }
-        printf("Fetched: %s\n", webpage_getURL(webpage));
+        size_t htmlLen = strlen(webpage_getHTML(webpage));
+        metrics_count(metrics, METRICS_PAGES, 1);
+        metrics_count(metrics, METRICS_BYTES, htmlLen);
+        if (!options->quiet) {
+            printf("Fetched: %s\n", webpage_getURL(webpage));
+        }
         //if fetch was succesfull
         //save webpage to pageDirectory
+        start = metrics_now();
         pagedir_save(webpage, pageDirectory, docId);
+        metrics_time(metrics, METRICS_SAVE, start, metrics_now());
         docId++; 
 
         //if webpage is not at maxDepth
         if (webpage_getDepth(webpage) < maxDepth) {
+            //grow the link buffer if a link on this page might not fit;
+            //no link is longer than the page url plus the whole html
+            size_t need = 2 * (strlen(webpage_getURL(webpage)) + htmlLen + 2);
+            if (need > linkBufSize) {
+                free(linkBuf);
+                linkBuf = mem_malloc_assert(need, "Couldn't allocate link buffer");
+                linkBufSize = need;
+            }
             //pageScan the HTML
-            printf("Scanning: %s\n", webpage_getURL(webpage));
-            pageScan(webpage, toVisit, visited);
+            if (!options->quiet) {
+                printf("Scanning: %s\n", webpage_getURL(webpage));
+            }
+            pageScan(webpage, toVisit, visited, linkBuf, linkBufSize,
+                     metrics, options->quiet);
         }            
         //delete webpage
         webpage_delete(webpage);
+        if (metrics_get(metrics, METRICS_PAGES) % options->metricsEvery == 0) {
+            dumpMetrics(metrics, options, false);
+        }
+    }
+    free(linkBuf);
+    dumpMetrics(metrics, options, true);
+    metrics_delete(metrics);
+    //report how well the filter did, if there was one
+    urlset_printStats(visited, stdout);
+    //a bounded frontier drops pages, and so does a spill that can't be written
+    if (options->maxPending > 0 || options->spillDir != NULL) {
+        printf("Frontier: %ld pages dropped\n", frontier_dropped(toVisit));
+    }
+    if (options->spillDir != NULL) {
+        printf("Frontier: %ld pages spilled to disk\n", frontier_spilled(toVisit));
     }
-    //delete hashtable
-    hashtable_delete(visited, NULL); //null itemdelete because items aren't malloc'd
-    //delete bag
-    bag_delete(toVisit, NULL); //null itemdelete because used webpage_delete 
+    //delete visited set
+    urlset_delete(visited);
+    //delete frontier
+    frontier_delete(toVisit);
     //exit 0 if successful, per requirements spec
     exit(0);
 }
 
 /**************** pageScan() ****************                                                                                
  *  pageScan - scan a page, go through every URL in the file, 
- *  add to bag of pages visited if new
+ *  add to frontier of pages to visit if new
  *                                                                                                                
  *  Parameters:                                                                                                   
  *    page - webpage_t* webpage struct pointer                                                                             
- *    pagesToCrawl - bag_t* bag pointer to hold webpages to crawl
- *    pagesSeen - hashtable_t* hashtable pointer to hold seen webpages                                                                            
+ *    pagesToCrawl - frontier_t* frontier pointer to hold webpages to crawl
+ *    pagesSeen - urlset_t* set of urls seen so far                                                                            
+ *    linkBuf - char* scratch buffer, large enough for two copies of any
+ *      link on the page (see crawl)
+ *    linkBufSize - const size_t size of linkBuf
+ *    metrics - metrics_t* metrics to time stages and count links in
+ *    quiet - const bool true to print no line per link
  *                                                                                                                
  *  Returns:                                                                                                    
  *    void
  *
  *  Behavior:
- *    scan a page, go through every URL in the page, check if it's in hashtable, if not 
- *    add it to bag of pages to crawl, repeat for each page in bag                                               
+ *    scan a page, go through every URL in the page, check if it's in pagesSeen, if not 
+ *    add it to frontier of pages to crawl, repeat for each page in frontier
+ *    links are resolved and normalized inside linkBuf, so the only memory
+ *    allocated per link is the copy handed to a new webpage                                               
  */
-static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen) {
+static void pageScan(webpage_t* page, frontier_t* pagesToCrawl, urlset_t* pagesSeen,
+                     char* linkBuf, const size_t linkBufSize,
+                     metrics_t* metrics, const bool quiet) {
+
+    const char* pageURL = webpage_getURL(page);
+    char* html = webpage_getHTML(page);
+
+    //first half of linkBuf holds resolved links, second half normalized ones
+    size_t half = linkBufSize / 2;
+    char* resolved = linkBuf;
+    char* normalized = linkBuf + half;
 
     int pos = 0;
-    char* nextURL = webpage_getNextURL(page, &pos);
+    const char* link;
+    size_t len;
+    bool relative;
+
+    //each stage is timed from where the last one ended, one clock read each
+    double mark = metrics_now();
+    double now;
 
     //while there is another URL in the page
-    while (nextURL != NULL) {
+    while (url_nextLink(html, &pos, &link, &len, &relative)) {
+        now = metrics_now();
+        metrics_time(metrics, METRICS_EXTRACT, mark, now);
+        mark = now;
+
+        //make relative links absolute
+        const char* absolute = link;
+        size_t absoluteLen = len;
+        if (relative) {
+            int resolvedLen = url_resolve(pageURL, link, len, resolved, half);
+            if (resolvedLen < 0) {
+                //page url can't be parsed, no more links can be resolved
+                break;
+            }
+            absolute = resolved;
+            absoluteLen = resolvedLen;
+        }
+
         //normalize the URL
-        char* normalizedUrl = normalizeURL(nextURL);
-        printf("Found: %s\n", normalizedUrl);
-        //if internal, and can be normalized
-        if (normalizedUrl != NULL) {
-            //normalize seedUrl
-            free(nextURL);
-            nextURL = normalizedUrl;
-        } else {
+        int normalizedLen = url_normalize(absolute, absoluteLen, normalized, half);
+        if (normalizedLen < 0) {
             //invalid url, print to stderr and exit nonzero
             fprintf(stderr, "\nInvalid URL\n");
-            free(nextURL);
             exit(1);
-        } 
+        }
+        now = metrics_now();
+        metrics_time(metrics, METRICS_NORMALIZE, mark, now);
+        mark = now;
+        metrics_count(metrics, METRICS_LINKS, 1);
 
+        //what became of the URL, printed after it's timed
+        const char* outcome;
         //if that URL is Internal
-        if (isInternalURL(nextURL)) {
-            //insert the webpage into the hashtable
+        if (isInternalURL(normalized)) {
+            //insert the url into the set of seen urls
             //if that succeeded
-            if (hashtable_insert(pagesSeen, nextURL, "")) {
-                //create a webpage_t for it
+            if (urlset_insert(pagesSeen, normalized)) {
+                //create a webpage_t for it, with its own copy of the url
+                char* nextURL = mem_malloc_assert(normalizedLen + 1, "Couldn't copy URL");
+                memcpy(nextURL, normalized, normalizedLen + 1);
                 webpage_t* webpage = webpage_new(nextURL, webpage_getDepth(page) + 1, NULL);
                 if (webpage == NULL) {
                     fprintf(stderr, "Couldn't create webpage");
                     exit(1);
                 } 
-                //insert the webpage into the bag
-                printf("Added: %s\n", nextURL);
-                bag_insert(pagesToCrawl, webpage);
+                //insert the webpage into the frontier, unless it is full
+                if (frontier_insert(pagesToCrawl, webpage)) {
+                    metrics_count(metrics, METRICS_ADDED, 1);
+                    outcome = "Added";
+                } else {
+                    metrics_count(metrics, METRICS_DROPPED, 1);
+                    outcome = "Dropped";
+                }
             } else {
-                //free this URL and get next URL
-                printf("IgnDupl: %s\n", nextURL);
-                free(normalizedUrl);
+                //already seen, get next URL
+                metrics_count(metrics, METRICS_DUPLICATES, 1);
+                outcome = "IgnDupl";
             }
         } else {
-            //free this URL and get next URL
-            printf("IgnExtrn: %s\n", nextURL);
-            free(normalizedUrl);
+            //external, get next URL
+            metrics_count(metrics, METRICS_EXTERNAL, 1);
+            outcome = "IgnExtrn";
         }
-        nextURL = webpage_getNextURL(page, &pos);
+        now = metrics_now();
+        metrics_time(metrics, METRICS_FRONTIER, mark, now);
+        mark = now;
+
+        if (!quiet) {
+            printf("Found: %s\n", normalized);
+            printf("%s: %s\n", outcome, normalized);
+            now = metrics_now();
+            metrics_time(metrics, METRICS_PRINT, mark, now);
+            mark = now;
+        }
+    }
+}
+
+/**************** dumpMetrics() ****************
+ *  dumpMetrics - write the crawl's metrics as JSON, if asked to
+ *
+ *  Parameters:
+ *    metrics - metrics_t* metrics of the crawl so far
+ *    options - const crawlOptions_t* optional settings
+ *    done - const bool true if the crawl has finished
+ *
+ *  Returns:
+ *    void
+ *
+ *  Behavior:
+ *    does nothing without --metrics; with --metrics -, prints the metrics
+ *    as a line of stdout, else replaces the file with them, warning on
+ *    stderr (and crawling on) if it can't be written
+ */
+static void dumpMetrics(metrics_t* metrics, const crawlOptions_t* options, const bool done) {
+    if (options->metricsFile == NULL) {
+        return;
+    }
+    if (strcmp(options->metricsFile, "-") == 0) {
+        metrics_print(metrics, stdout, done);
+    } else if (!metrics_save(metrics, options->metricsFile, done)) {
+        fprintf(stderr, "Couldn't write metrics to '%s'\n", options->metricsFile);
     }
 }
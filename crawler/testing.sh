@@ -1,4 +1,4 @@
-!/bin/bash
+#!/bin/bash
 
 #tests are based on github page for crawler recommendations
 
@@ -60,6 +60,66 @@ mkdir ../data/wikipedia/memorycheck2
 ./crawler http://cs50tse.cs.dartmouth.edu/tse/wikipedia/index.html ../data/wikipedia/0/ 0
 ./crawler http://cs50tse.cs.dartmouth.edu/tse/wikipedia/index.html ../data/wikipedia/1/ 1
 
+#toscrape at depth 1, quiet, with metrics every 10 pages and at the end
+echo
+echo toscrape at depth 1 with metrics
+mkdir ../data/toscrape/metrics
+./crawler http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html ../data/toscrape/metrics 1 --quiet --metrics - --metrics-every 10
+
+#letters at depth 10 keeping every visited url, same pages as with fingerprints only
+echo
+echo letters at depth 10 with --exact
+mkdir ../data/letters/exact
+./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters/exact 10 --exact --quiet
+diff -r ../data/letters/10 ../data/letters/exact && echo "same pages as without --exact"
+
+#letters at depth 10 behind a bloom filter, which prints its counters at the end
+echo
+echo letters at depth 10 with --expected
+mkdir ../data/letters/expected
+./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters/expected 10 --expected 20 --quiet
+diff -r ../data/letters/10 ../data/letters/expected && echo "same pages as without --expected"
+
+#letters at depth 10 in each crawl order; every url is on one host, so host
+#serves pages in the order bfs does, while depth fetches shallowest first
+echo
+echo letters at depth 10 with --frontier host and --frontier depth
+mkdir ../data/letters/host
+mkdir ../data/letters/depth
+./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters/host 10 --frontier host --quiet
+diff -r ../data/letters/10 ../data/letters/host && echo "host saves the pages bfs does"
+./crawler http://cs50tse.cs.dartmouth.edu/tse/letters/index.html ../data/letters/depth 10 --frontier depth | grep "^Fetched"
+
+#toscrape at depth 1 with at most 10 pages waiting; the rest are dropped
+echo
+echo toscrape at depth 1 with --max-pending 10
+mkdir ../data/toscrape/bounded
+./crawler http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html ../data/toscrape/bounded 1 --max-pending 10 > ../data/bounded.out
+grep -c "^Dropped:" ../data/bounded.out
+grep "^Frontier:" ../data/bounded.out
+ls ../data/toscrape/bounded | wc -l
+
+#toscrape at depth 1 spilling past 5 pages in memory: the same pages as in
+#memory, and no segment files left behind
+echo
+echo toscrape at depth 1 with --spill-dir and --mem-limit 5
+mkdir ../data/toscrape/spilled
+mkdir ../data/spill
+./crawler http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html ../data/toscrape/spilled 1 --spill-dir ../data/spill --mem-limit 5 --quiet
+diff -r ../data/toscrape/1 ../data/toscrape/spilled && echo "same pages as in memory"
+ls ../data/spill | wc -l
+
+#toscrape at depth 2 under depth with a bound: a bounded frontier that
+#spills drops the pages one in memory does, so the same pages are saved
+echo
+echo toscrape at depth 2 with --frontier depth, --max-pending 20, with and without --spill-dir
+mkdir ../data/toscrape/depth
+mkdir ../data/toscrape/depthspilled
+./crawler http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html ../data/toscrape/depth 2 --frontier depth --max-pending 20 --quiet
+./crawler http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html ../data/toscrape/depthspilled 2 --frontier depth --max-pending 20 --spill-dir ../data/spill --mem-limit 3 --quiet
+diff -r ../data/toscrape/depth ../data/toscrape/depthspilled && echo "same pages as in memory"
+ls ../data/spill | wc -l
+
 #letters at depths 10 with valgrind and wikipedia 0 with valgrind
 echo
 echo letters at depths 10 with valgrind and wikipedia 0 with valgrind
@@ -9,20 +9,50 @@
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <limits.h>
 #include "mem.h"
 #include "webpage.h"
 #include "hashtable.h"
 #include "bag.h"
 #include "pagedir.h"
 #include "file.h"
+#include "reader.h"
 #include "index.h"
 #include "word.h"
+#include "manifest.h"
+#include "bitmap.h"
+#include "codec.h"
+#include "stem.h"
+#include "trigram.h"
 
+//segments of the same tier merged at a time; a segment's tier is the
+//number of times its page count divides by MERGE_FACTOR
+#define MERGE_FACTOR 4
 
 //function headers
 static bool validateParams(char* pageDirectory, char* indexFilename);
-static void indexBuild(char* pageDirectory, char* indexFilename);
-static void indexPage(webpage_t* webpage, int docID, index_t* index);
+static void indexBuild(char* pageDirectory, char* indexFilename, const int numShards,
+                       manifest_t* manifest, const double maxDF);
+static int indexShards(char* pageDirectory, char* indexFilename, const int numShards,
+                       manifest_t* manifest);
+static bool loadStopwords(manifest_t* manifest, const char* stopFilename);
+static void addStopword(void* arg, const char* word);
+static int countPages(char* pageDirectory);
+static void checkUnsharded(manifest_t* manifest, char* indexFilename);
+static void checkStemmer(manifest_t* manifest, char* indexFilename);
+static void indexIncremental(char* pageDirectory, char* indexFilename);
+static void indexCompact(char* indexFilename);
+static void indexUpdate(char* pageDirectory, char* indexFilename, char** docIDs, const int numDocIDs);
+static void indexDelete(char* indexFilename, char** docIDs, const int numDocIDs);
+static int parseDocID(const char* arg, manifest_t* manifest);
+static void indexMerge(manifest_t* manifest, char* indexFilename);
+static int segmentTier(manifest_t* manifest, const int i);
+static void mergeSegments(manifest_t* manifest, char* indexFilename, const int i);
+static int indexDocs(char* pageDirectory, const int firstDocID, const int lastDocID,
+                     index_t* index, manifest_t* manifest);
+static void removeSegments(manifest_t* manifest, char* indexFilename);
+static void saveDict(index_t* index, char* indexFilename);
+static void indexPage(webpage_t* webpage, int docID, index_t* index, manifest_t* manifest);
 
 /* ***************************
  *  main - start of indexer.c
@@ -38,6 +68,31 @@ static void indexPage(webpage_t* webpage, int docID, index_t* index);
  *    validates parameters, calls indexBuild to build index
  *    creates an index (refer to index.h for details) based on
  *    pageDirectory, writes it to indexFilename.
+ *    with --shards N, splits the pages into N shards by docID range,
+ *    each written to an index file of its own for a querier process.
+ *    with --incremental, indexes only pages added since the last run,
+ *    into a new segment, then merges small segments into larger ones;
+ *    with --update, reindexes the given pages, which were refreshed in
+ *    pageDirectory, into a new segment; with --delete, deletes pages
+ *    from the index. Both leave tombstones on the old postings.
+ *    with --merge, only merges; with --compact, folds segments into
+ *    the base, dropping dead postings and tombstones.
+ *    with --codec, a full build writes its index files compressed
+ *    (see codec.h), as do later runs on the index.
+ *    with --stopwords, a full build leaves out the words listed in a
+ *    file; with --max-df, it also leaves out words found in more than
+ *    that fraction of the pages. Later runs leave out the same words.
+ *    with --stem, a full build stems every word (see stem.h), as do
+ *    later runs on the index.
+ *
+ *  Usage:
+ *    indexer pageDirectory indexFilename [--incremental]
+ *    indexer pageDirectory indexFilename [--shards N] [--codec NAME]
+ *                  [--stem NAME] [--stopwords FILE] [--max-df FRACTION]
+ *    indexer pageDirectory indexFilename --update docID...
+ *    indexer --delete indexFilename docID...
+ *    indexer --merge indexFilename
+ *    indexer --compact indexFilename
  *   
  */
 int
@@ -47,8 +102,92 @@ main (int argc, char* argv[])
     parse the command line, validate parameters, initialize other modules
     call indexBuild, with pageDirectory
     */
+    //--codec NAME, --stem NAME, --stopwords FILE and --max-df FRACTION
+    //come last, in any order, and only for a full build
+    manifest_t* newManifest = mem_assert(manifest_new(), "Couldn't allocate memory");
+    char* stopFilename = NULL;
+    double maxDF = 1.0;
+    bool buildOptions = false;
+    while (argc >= 5 && strncmp(argv[argc - 2], "--", 2) == 0
+           && strcmp(argv[argc - 2], "--shards") != 0 && strcmp(argv[argc - 2], "--update") != 0) {
+        char* option = argv[argc - 2];
+        char* value = argv[argc - 1];
+        if (strcmp(option, "--codec") == 0) {
+            codec_t codec;
+            if (!codec_parse(value, &codec)) {
+                fprintf(stderr, "codec must be text, vbyte, simple8b or pfor\n");
+                exit(1);
+            }
+            manifest_setCodec(newManifest, codec);
+        } else if (strcmp(option, "--stem") == 0) {
+            stemmer_t stemmer;
+            if (!stem_parse(value, &stemmer)) {
+                fprintf(stderr, "stemmer must be none or porter\n");
+                exit(1);
+            }
+            manifest_setStemmer(newManifest, stemmer);
+        } else if (strcmp(option, "--stopwords") == 0) {
+            stopFilename = value;
+        } else if (strcmp(option, "--max-df") == 0) {
+            char* end;
+            maxDF = strtod(value, &end);
+            if (*value == '\0' || *end != '\0' || !(maxDF > 0 && maxDF <= 1)) {
+                fprintf(stderr, "--max-df must be a fraction of the pages, above 0 and at most 1\n");
+                exit(1);
+            }
+        } else {
+            break;
+        }
+        argc -= 2;
+        buildOptions = true;
+    }
+    if (buildOptions && !((argc == 3 && argv[1][0] != '-')
+                          || (argc == 5 && strcmp(argv[3], "--shards") == 0))) {
+        fprintf(stderr, "%s is for a full build; later runs keep its setting\n", argv[argc]);
+        exit(1);
+    }
+    if (maxDF < 1 && argc == 5) {
+        //a word's pages are spread over the shards, which are indexed one by one
+        fprintf(stderr, "--max-df is for an unsharded build\n");
+        exit(1);
+    }
+    //stop words are stemmed like the words of the pages, so once --stem is known
+    if (stopFilename != NULL && !loadStopwords(newManifest, stopFilename)) {
+        fprintf(stderr, "Couldn't read stop words from %s\n", stopFilename);
+        exit(1);
+    }
+
     //check argument count
-    if (argc == 3) {
+    if (argc == 3 && strcmp(argv[1], "--compact") == 0) {
+        //fold the segments of an existing index into it
+        indexCompact(argv[2]);
+    } else if (argc == 3 && strcmp(argv[1], "--merge") == 0) {
+        //merge segments as the tiered policy calls for, e.g. from cron
+        manifest_t* manifest = manifest_load(argv[2]);
+        indexMerge(manifest, argv[2]);
+        manifest_delete(manifest);
+    } else if (argc >= 4 && strcmp(argv[1], "--delete") == 0) {
+        //tombstone pages that are gone
+        indexDelete(argv[2], argv + 3, argc - 3);
+    } else if (argc >= 5 && strcmp(argv[3], "--update") == 0) {
+        //reindex pages that were refreshed
+        indexUpdate(argv[1], argv[2], argv + 4, argc - 4);
+    } else if (argc == 5 && strcmp(argv[3], "--shards") == 0) {
+        //split a full build over numShards index files
+        char* end;
+        long numShards = strtol(argv[4], &end, 10);
+        if (*end != '\0' || numShards < 1 || numShards > 1000) {
+            fprintf(stderr, "shard count must be a number from 1 to 1000\n");
+            exit(1);
+        }
+        if (!validateParams(argv[1], argv[2])) {
+            exit(1);
+        }
+        indexBuild(argv[1], argv[2], numShards, newManifest, maxDF);
+    } else if (argc == 4 && strcmp(argv[3], "--incremental") == 0) {
+        //index only the pages added since the last run
+        indexIncremental(argv[1], argv[2]);
+    } else if (argc == 3) {
          //initialize variables
         char* pageDirectory = argv[1];
         char* indexFilename = argv[2];
@@ -58,11 +197,13 @@ main (int argc, char* argv[])
             exit(1);
         }
         //if successful, call indexBuild function 
-        indexBuild(pageDirectory, indexFilename); 
+        indexBuild(pageDirectory, indexFilename, 1, newManifest, maxDF);
     } else {
         fprintf(stderr, "\ninvalid argument number, please input 2\n");
+        manifest_delete(newManifest);
         return 1;
     }
+    manifest_delete(newManifest);
     return 0;
 }
 
@@ -107,63 +248,749 @@ static bool validateParams(char* pageDirectory, char* indexFilename) {
  *  Parameters:
  *    pageDirectory - char* that contains page directory
  *    indexFilename - char* that contains file name of index file
+ *    numShards - const int number of shards, 1 for an unsharded index
+ *    manifest - manifest_t* new manifest for the index, holding the codec
+ *               to write the index files with and the stop words to leave out
+ *    maxDF - const double fraction of the pages a word may be in, 1 for any
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     indexes every page, leaving out the stop words, then (unsharded)
+ *     the words in more than maxDF of the pages, which become stop words
+ *     too; saves the index files, then the manifest, replacing any
+ *     earlier index
+ */
+static void indexBuild(char* pageDirectory, char* indexFilename, const int numShards,
+                       manifest_t* manifest, const double maxDF) {
+    int lastDocID;
+    codec_t codec = manifest_getCodec(manifest);
+    if (numShards == 1) {
+        //create new index object
+        index_t* index = index_new(800); //choose arbitrary size, per indexer specs
+        lastDocID = indexDocs(pageDirectory, 1, INT_MAX, index, manifest);
+        if (maxDF < 1) {
+            //the longest postings, which do least for ranking
+            int maxDocs = (int)(maxDF * lastDocID);
+            int cut = index_cutoff(index, maxDocs, manifest, addStopword);
+            printf("Left out %d words found in more than %d pages\n", cut, maxDocs);
+        }
+        //save the index to a file, and its words as a dictionary
+        index_saveWith(index, indexFilename, codec);
+        saveDict(index, indexFilename);
+
+        //delete index
+        index_delete(index);
+    } else {
+        lastDocID = indexShards(pageDirectory, indexFilename, numShards, manifest);
+        saveDict(NULL, indexFilename);
+    }
+
+    //start a fresh manifest, dropping segments and extra shards of any earlier index
+    manifest_t* old = manifest_load(indexFilename);
+    removeSegments(old, indexFilename);
+    for (int shard = (numShards > 1) ? numShards + 1 : 1; shard <= manifest_getShards(old); shard++) {
+        char* shardName = manifest_shardName(indexFilename, shard);
+        if (shardName != NULL) {
+            remove(shardName);
+            free(shardName);
+        }
+    }
+    manifest_delete(old);
+    manifest_setLastDocID(manifest, lastDocID);
+    manifest_setShards(manifest, numShards);
+    if (!manifest_save(manifest, indexFilename)) {
+        fprintf(stderr, "Couldn't write index manifest\n");
+        exit(1);
+    }
+}
+
+/**************** indexIncremental() ****************                                                                                
+ *  indexIncremental - index the pages added since the last run
+ *
+ *  Parameters:
+ *    pageDirectory - char* that contains page directory
+ *    indexFilename - char* that contains file name of an existing index
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     reads the manifest of indexFilename for the last docID indexed,
+ *     indexes pageDirectory from the next docID on into a new segment,
+ *     then adds the segment to the manifest. Pages already indexed are
+ *     not read again. Without a manifest, builds the whole index.
+ */
+static void indexIncremental(char* pageDirectory, char* indexFilename) {
+    manifest_t* manifest = manifest_load(indexFilename);
+    if (manifest == NULL) {
+        //no record of an earlier run, so index everything
+        printf("No manifest for %s, building the whole index\n", indexFilename);
+        if (!validateParams(pageDirectory, indexFilename)) {
+            exit(1);
+        }
+        manifest = mem_assert(manifest_new(), "Couldn't allocate memory");
+        indexBuild(pageDirectory, indexFilename, 1, manifest, 1.0);
+        manifest_delete(manifest);
+        return;
+    }
+    checkUnsharded(manifest, indexFilename);
+    checkStemmer(manifest, indexFilename);
+    if (!pagedir_validate(pageDirectory)) {
+        fprintf(stderr, "Invalid page directory\n");
+        exit(1);
+    }
+
+    //index the new pages only
+    int firstDocID = manifest_getLastDocID(manifest) + 1;
+    index_t* index = index_new(800);
+    int lastDocID = indexDocs(pageDirectory, firstDocID, INT_MAX, index, manifest);
+    if (lastDocID < firstDocID) {
+        printf("No new pages to index\n");
+    } else {
+        //write the segment before the manifest that points to it
+        int segment = manifest_addSegment(manifest, firstDocID, lastDocID,
+                                          lastDocID - firstDocID + 1);
+        char* segmentName = manifest_segmentName(indexFilename, segment);
+        if (segment < 0 || segmentName == NULL) {
+            fprintf(stderr, "Couldn't allocate memory\n");
+            exit(1);
+        }
+        index_saveWith(index, segmentName, manifest_getCodec(manifest));
+        if (!manifest_save(manifest, indexFilename)) {
+            fprintf(stderr, "Couldn't write index manifest\n");
+            exit(1);
+        }
+        printf("Indexed docIDs %d to %d into %s\n", firstDocID, lastDocID, segmentName);
+        free(segmentName);
+    }
+    index_delete(index);
+
+    //keep the number of segments the querier reads logarithmic
+    indexMerge(manifest, indexFilename);
+    manifest_delete(manifest);
+}
+
+/**************** indexMerge() ****************                                                                                
+ *  indexMerge - merge segments by the tiered policy
+ *
+ *  Parameters:
+ *    manifest - manifest_t* manifest of the index, may be NULL
+ *    indexFilename - char* that contains file name of the index
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     whenever MERGE_FACTOR adjacent segments are of the same tier,
+ *     merges them into one segment of the next tier, until no tier has
+ *     that many. Each segment is rewritten about once per tier, so
+ *     indexing n pages costs O(n log n) merge work overall, and an index
+ *     has at most MERGE_FACTOR - 1 segments per tier. Only adjacent
+ *     segments are merged, so each segment still holds one range of
+ *     docIDs, newer than the segments before it.
+ */
+static void indexMerge(manifest_t* manifest, char* indexFilename) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        //find a run of MERGE_FACTOR segments of one tier, oldest first
+        int runStart = 0;
+        for (int i = 0; i < manifest_numSegments(manifest); i++) {
+            if (segmentTier(manifest, i) != segmentTier(manifest, runStart)) {
+                runStart = i;
+            }
+            if (i - runStart + 1 == MERGE_FACTOR) {
+                mergeSegments(manifest, indexFilename, runStart);
+                merged = true;
+                break;
+            }
+        }
+    }
+}
+
+/**************** segmentTier() ****************                                                                                
+ *  segmentTier - tier of the i'th segment of manifest
+ *
+ *  Returns:
+ *     int - how many times the segment's page count divides
+ *           by MERGE_FACTOR, or -1 if there is no such segment
+ */
+static int segmentTier(manifest_t* manifest, const int i) {
+    if (i < 0 || i >= manifest_numSegments(manifest)) {
+        return -1;
+    }
+    int tier = 0;
+    for (int docs = manifest_getNumDocs(manifest, i); docs >= MERGE_FACTOR; docs /= MERGE_FACTOR) {
+        tier++;
+    }
+    return tier;
+}
+
+/**************** mergeSegments() ****************                                                                                
+ *  mergeSegments - merge MERGE_FACTOR segments into one
+ *
+ *  Parameters:
+ *    manifest - manifest_t* manifest of the index
+ *    indexFilename - char* that contains file name of the index
+ *    i - const int position of the first segment to merge
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     loads the segments as one index, saves it as a new segment
+ *     without their dead postings, then saves the manifest before removing the old segment files,
+ *     so the index on disk stays whole if we are stopped part way.
+ */
+static void mergeSegments(manifest_t* manifest, char* indexFilename, const int i) {
+    //load each old segment as a segment of one index, with its tombstones
+    index_t* index = NULL;
+    char* oldNames[MERGE_FACTOR];
+    for (int j = 0; j < MERGE_FACTOR; j++) {
+        int number = manifest_getSegment(manifest, i + j);
+        oldNames[j] = manifest_segmentName(indexFilename, number);
+        if (oldNames[j] == NULL) {
+            fprintf(stderr, "Couldn't allocate memory\n");
+            exit(1);
+        }
+        bool loaded = (j == 0) ? (index = index_load(oldNames[j])) != NULL
+                               : index_loadSegment(index, oldNames[j]);
+        if (!loaded) {
+            fprintf(stderr, "Couldn't read segment %s\n", oldNames[j]);
+            exit(1);
+        }
+        index_setDeleted(index, j, bitmap_copy(manifest_getDeleted(manifest, number)));
+    }
+
+    //save them as one new segment, then point the manifest at it
+    int segment = manifest_replaceSegments(manifest, i, MERGE_FACTOR);
+    char* segmentName = manifest_segmentName(indexFilename, segment);
+    if (segmentName == NULL) {
+        fprintf(stderr, "Couldn't allocate memory\n");
+        exit(1);
+    }
+    index_saveWith(index, segmentName, manifest_getCodec(manifest));
+    index_delete(index);
+    if (!manifest_save(manifest, indexFilename)) {
+        fprintf(stderr, "Couldn't write index manifest\n");
+        exit(1);
+    }
+    int first, last;
+    manifest_getRange(manifest, i, &first, &last);
+    printf("Merged %d segments into %s, docIDs %d to %d\n", MERGE_FACTOR, segmentName, first, last);
+    free(segmentName);
+
+    for (int j = 0; j < MERGE_FACTOR; j++) {
+        remove(oldNames[j]);
+        free(oldNames[j]);
+    }
+}
+
+/**************** indexCompact() ****************                                                                                
+ *  indexCompact - fold an index's segments back into its base file
+ *
+ *  Parameters:
+ *    indexFilename - char* that contains file name of an existing index
  *
  *  Returns:
  *     void
  *
  *  Behavior:
+ *     loads the base and its segments as one index, writes it to a
+ *     temporary file renamed over the base, without dead postings,
+ *     then empties the manifest of segments and tombstones and removes
+ *     the segment files. Reloading a segment into a base
+ *     that already holds it changes nothing, so a compaction cut short
+ *     at any point leaves a usable index.
+ */
+static void indexCompact(char* indexFilename) {
+    manifest_t* manifest = manifest_load(indexFilename);
+    if (manifest == NULL || (manifest_numSegments(manifest) == 0
+                             && manifest_getDeleted(manifest, 0) == NULL)) {
+        printf("Nothing to compact\n");
+        manifest_delete(manifest);
+        return;
+    }
+    FILE* fp = fopen(indexFilename, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "Couldn't open file for reading\n");
+        exit(1);
+    }
+    fclose(fp);
+
+    //write the merged index beside the base, then swap it in
+    index_t* index = index_loadAll(indexFilename);
+    if (index == NULL) {
+        fprintf(stderr, "Couldn't load %s\n", indexFilename);
+        exit(1);
+    }
+    char* tmpName = mem_malloc_assert(strlen(indexFilename) + 5, "Couldn't allocate memory");
+    sprintf(tmpName, "%s.tmp", indexFilename);
+    index_saveWith(index, tmpName, manifest_getCodec(manifest));
+    if (rename(tmpName, indexFilename) != 0) {
+        fprintf(stderr, "Couldn't replace %s\n", indexFilename);
+        remove(tmpName);
+        exit(1);
+    }
+    free(tmpName);
+    saveDict(index, indexFilename);
+    index_delete(index);
+
+    //the base now holds every segment
+    int folded = manifest_numSegments(manifest);
+    manifest_t* emptied = manifest_load(indexFilename);
+    manifest_clearSegments(emptied);
+    if (!manifest_save(emptied, indexFilename)) {
+        fprintf(stderr, "Couldn't write index manifest\n");
+        exit(1);
+    }
+    manifest_delete(emptied);
+    removeSegments(manifest, indexFilename);
+    manifest_delete(manifest);
+    printf("Folded %d segments into %s\n", folded, indexFilename);
+}
+
+/**************** indexUpdate() ****************                                                                                
+ *  indexUpdate - reindex pages refreshed in the page directory
  *
+ *  Parameters:
+ *    pageDirectory - char* that contains page directory
+ *    indexFilename - char* that contains file name of an existing index
+ *    docIDs - char** docIDs of the pages, as given on the command line
+ *    numDocIDs - const int number of docIDs
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     puts a tombstone on each docID in the base and every segment,
+ *     then indexes the pages' current content into a new segment, so
+ *     the querier sees only the new postings. A page no longer in
+ *     pageDirectory is just deleted. Queriers already running keep the
+ *     index they loaded; the manifest is replaced in one rename.
  */
-static void indexBuild(char* pageDirectory, char* indexFilename) {
+static void indexUpdate(char* pageDirectory, char* indexFilename, char** docIDs, const int numDocIDs) {
+    manifest_t* manifest = manifest_load(indexFilename);
+    if (manifest == NULL) {
+        fprintf(stderr, "No manifest for %s, build the index first\n", indexFilename);
+        exit(1);
+    }
+    checkUnsharded(manifest, indexFilename);
+    checkStemmer(manifest, indexFilename);
+    if (!pagedir_validate(pageDirectory)) {
+        fprintf(stderr, "Invalid page directory\n");
+        exit(1);
+    }
 
-    //create new index object
-    index_t* index = index_new(800); //choose arbitrary size, per indexer specs
-    int docID = 1;
+    //tombstones go on the segments there are now, not on the new one
+    index_t* index = index_new(800);
+    bitmap_t* seen = bitmap_new();
+    int firstDocID = 0, lastDocID = 0, numDocs = 0;
+    for (int i = 0; i < numDocIDs; i++) {
+        int docID = parseDocID(docIDs[i], manifest);
+        if (docID == 0 || bitmap_test(seen, docID)) {
+            continue;
+        }
+        bitmap_set(seen, docID);
+        if (!manifest_deleteDoc(manifest, docID)) {
+            fprintf(stderr, "Couldn't allocate memory\n");
+            exit(1);
+        }
+        webpage_t* webpage = pagedir_load(pageDirectory, docID);
+        if (webpage == NULL) {
+            printf("Page %d is gone, deleted it\n", docID);
+            continue;
+        }
+        indexPage(webpage, docID, index, manifest);
+        webpage_delete(webpage);
+        if (numDocs == 0 || docID < firstDocID) {
+            firstDocID = docID;
+        }
+        if (docID > lastDocID) {
+            lastDocID = docID;
+        }
+        numDocs++;
+    }
+    bitmap_delete(seen);
+
+    if (numDocs > 0) {
+        //write the segment before the manifest that points to it
+        int segment = manifest_addSegment(manifest, firstDocID, lastDocID, numDocs);
+        char* segmentName = manifest_segmentName(indexFilename, segment);
+        if (segment < 0 || segmentName == NULL) {
+            fprintf(stderr, "Couldn't allocate memory\n");
+            exit(1);
+        }
+        index_saveWith(index, segmentName, manifest_getCodec(manifest));
+        printf("Updated %d pages into %s\n", numDocs, segmentName);
+        free(segmentName);
+    }
+    index_delete(index);
+    if (!manifest_save(manifest, indexFilename)) {
+        fprintf(stderr, "Couldn't write index manifest\n");
+        exit(1);
+    }
+    indexMerge(manifest, indexFilename);
+    manifest_delete(manifest);
+}
+
+/**************** indexDelete() ****************                                                                                
+ *  indexDelete - delete pages from an index
+ *
+ *  Parameters:
+ *    indexFilename - char* that contains file name of an existing index
+ *    docIDs - char** docIDs of the pages, as given on the command line
+ *    numDocIDs - const int number of docIDs
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     puts a tombstone on each docID in the base and every segment;
+ *     the postings stay on disk until merged or compacted away.
+ */
+static void indexDelete(char* indexFilename, char** docIDs, const int numDocIDs) {
+    manifest_t* manifest = manifest_load(indexFilename);
+    if (manifest == NULL) {
+        fprintf(stderr, "No manifest for %s, build the index first\n", indexFilename);
+        exit(1);
+    }
+    checkUnsharded(manifest, indexFilename);
+    int deleted = 0;
+    for (int i = 0; i < numDocIDs; i++) {
+        int docID = parseDocID(docIDs[i], manifest);
+        if (docID == 0) {
+            continue;
+        }
+        if (!manifest_deleteDoc(manifest, docID)) {
+            fprintf(stderr, "Couldn't allocate memory\n");
+            exit(1);
+        }
+        deleted++;
+    }
+    if (!manifest_save(manifest, indexFilename)) {
+        fprintf(stderr, "Couldn't write index manifest\n");
+        exit(1);
+    }
+    printf("Deleted %d pages from %s\n", deleted, indexFilename);
+    manifest_delete(manifest);
+}
+
+/**************** parseDocID() ****************                                                                                
+ *  parseDocID - read a docID given on the command line
+ *
+ *  Parameters:
+ *    arg - const char* the argument
+ *    manifest - manifest_t* manifest of the index
+ *
+ *  Returns:
+ *     int - the docID, or 0 (with a message) if arg isn't the docID of
+ *           an indexed page; later pages are for --incremental
+ */
+static int parseDocID(const char* arg, manifest_t* manifest) {
+    char* end;
+    long docID = strtol(arg, &end, 10);
+    if (*arg == '\0' || *end != '\0' || docID < 1 || docID > manifest_getLastDocID(manifest)) {
+        fprintf(stderr, "'%s' isn't the docID of an indexed page, skipping it\n", arg);
+        return 0;
+    }
+    return docID;
+}
+
+/**************** indexShards() ****************                                                                                
+ *  indexShards - index the pages as numShards shards
+ *
+ *  Parameters:
+ *    pageDirectory - char* that contains page directory
+ *    indexFilename - char* that contains file name of index file
+ *    numShards - const int number of shards
+ *    manifest - manifest_t* of the new index, with the codec to write
+ *               the shard files with and the stop words to leave out
+ *
+ *  Returns:
+ *     int - the last docID indexed
+ *
+ *  Behavior:
+ *     splits docIDs 1 to the number of pages into numShards ranges of
+ *     (nearly) equal size, and indexes each range into its shard file
+ *     (see manifest_shardName), one at a time, so that only one shard
+ *     is ever in memory. The base index file is left empty.
+ */
+static int indexShards(char* pageDirectory, char* indexFilename, const int numShards,
+                       manifest_t* manifest) {
+    codec_t codec = manifest_getCodec(manifest);
+    int numPages = countPages(pageDirectory);
+    for (int shard = 1; shard <= numShards; shard++) {
+        int first = (long)(shard - 1) * numPages / numShards + 1;
+        int last = (long)shard * numPages / numShards;
+        char* shardName = manifest_shardName(indexFilename, shard);
+        if (shardName == NULL) {
+            fprintf(stderr, "Couldn't allocate memory\n");
+            exit(1);
+        }
+        index_t* index = index_new(800);
+        indexDocs(pageDirectory, first, last, index, manifest);
+        index_saveWith(index, shardName, codec);
+        index_delete(index);
+        free(shardName);
+    }
+
+    //queriers search the shards; the base holds no words
+    index_t* empty = index_new(1);
+    index_saveWith(empty, indexFilename, codec);
+    index_delete(empty);
+    return numPages;
+}
+
+/**************** countPages() ****************                                                                                
+ *  countPages - count the pages in a page directory
+ *
+ *  Returns:
+ *     int - the number of page files 1, 2, ... before the first missing one
+ */
+static int countPages(char* pageDirectory) {
+    char* pathname = mem_malloc_assert(strlen(pageDirectory) + 16, "Couldn't allocate memory");
+    int numPages = 0;
+    FILE* fp;
+    do {
+        sprintf(pathname, "%s/%d", pageDirectory, numPages + 1);
+        if ((fp = fopen(pathname, "r")) != NULL) {
+            fclose(fp);
+            numPages++;
+        }
+    } while (fp != NULL);
+    free(pathname);
+    return numPages;
+}
+
+/**************** checkUnsharded() ****************                                                                                
+ *  checkUnsharded - exit unless the index is unsharded
+ *
+ *  Behavior:
+ *     segments and tombstones are kept for unsharded indexes only,
+ *     so a sharded index takes changes by being built again
+ */
+static void checkUnsharded(manifest_t* manifest, char* indexFilename) {
+    if (manifest_getShards(manifest) > 1) {
+        fprintf(stderr, "%s has %d shards; build it again with --shards to change it\n",
+                indexFilename, manifest_getShards(manifest));
+        exit(1);
+    }
+}
+
+/**************** checkStemmer() ****************                                                                                
+ *  checkStemmer - exit unless we know the index's stemmer
+ *
+ *  Behavior:
+ *     pages added to an index must be stemmed as its words were; an
+ *     index whose manifest names a stemmer we don't know is left alone
+ */
+static void checkStemmer(manifest_t* manifest, char* indexFilename) {
+    stemmer_t stemmer;
+    if (!manifest_getStemmer(manifest, &stemmer)) {
+        fprintf(stderr, "%s was stemmed with a stemmer this indexer doesn't know\n",
+                indexFilename);
+        exit(1);
+    }
+}
+
+/**************** indexDocs() ****************                                                                                
+ *  indexDocs - index every page from firstDocID to lastDocID
+ *
+ *  Parameters:
+ *    pageDirectory - char* that contains page directory
+ *    firstDocID - const int first docID to index
+ *    lastDocID - const int last docID to index, INT_MAX for all
+ *    index - index_t* index to add the pages to
+ *    manifest - manifest_t* whose stop words are left out, may be NULL
+ *
+ *  Returns:
+ *     int - the last docID indexed, firstDocID - 1 if none
+ *
+ *  Behavior:
+ *     loads pages firstDocID, firstDocID + 1, ... until one is missing
+ *     or lastDocID is indexed
+ */
+static int indexDocs(char* pageDirectory, const int firstDocID, const int lastDocID,
+                     index_t* index, manifest_t* manifest) {
+    int docID = firstDocID;
     webpage_t* webpage;
     //loop over document ID numbers
-    while ((webpage = pagedir_load(pageDirectory, docID)) != NULL) {
+    while (docID <= lastDocID && (webpage = pagedir_load(pageDirectory, docID)) != NULL) {
         //webpage exists, load the webpage from the document file 'pageDirectory/id'c
-        indexPage(webpage, docID, index);
+        indexPage(webpage, docID, index, manifest);
         //free pathname and webpage
         docID++;
         webpage_delete(webpage);
     }
-    //save the index to a file
-    index_save(index, indexFilename);
+    return docID - 1;
+}
 
-    //delete index
-    index_delete(index);
+/**************** removeSegments() ****************                                                                                
+ *  removeSegments - remove the files of every segment in manifest
+ *
+ *  Parameters:
+ *    manifest - manifest_t* manifest listing the segments, may be NULL
+ *    indexFilename - char* that contains file name of the index
+ *
+ *  Returns:
+ *     void
+ */
+static void removeSegments(manifest_t* manifest, char* indexFilename) {
+    for (int i = 0; i < manifest_numSegments(manifest); i++) {
+        char* segmentName = manifest_segmentName(indexFilename, manifest_getSegment(manifest, i));
+        if (segmentName != NULL) {
+            remove(segmentName);
+            free(segmentName);
+        }
+    }
+}
+
+/**************** saveDict() ****************                                                                                
+ *  saveDict - write the term dictionary of a new base, and its trigrams
+ *
+ *  Parameters:
+ *    index - index_t* the base was saved from, or NULL for none
+ *    indexFilename - char* that contains file name of the base
+ *
+ *  Returns:
+ *     void
+ *
+ *  Behavior:
+ *     saves the words of index to indexFilename.dict (see dict.h), and
+ *     their trigram index, for the querier's typo correction, to
+ *     indexFilename.trigram (see trigram.h); with no index, or if either
+ *     can't be made, removes any old one so that neither is left stale
+ *     beside the base.
+ */
+static void saveDict(index_t* index, char* indexFilename) {
+    char* dictName = manifest_dictName(indexFilename);
+    char* trigramName = manifest_trigramName(indexFilename);
+    if (dictName == NULL || trigramName == NULL) {
+        free(dictName);
+        free(trigramName);
+        return;
+    }
+    dict_t* dict = index_dict(index);
+    trigram_t* grams = trigram_new(dict);
+    if (dict == NULL || !dict_save(dict, dictName)) {
+        remove(dictName);
+    }
+    if (grams == NULL || !trigram_save(grams, trigramName)) {
+        remove(trigramName);
+    }
+    trigram_delete(grams);
+    dict_delete(dict);
+    free(dictName);
+    free(trigramName);
+}
+
+/**************** loadStopwords() ****************                                                                                
+ *  loadStopwords - read a stop list into a manifest
+ *
+ *  Parameters:
+ *    manifest - manifest_t* to add the stop words to
+ *    stopFilename - const char* file of words, separated by spaces or
+ *                   newlines; a line starting with '#' is a comment
+ *
+ *  Returns:
+ *     bool - false if the file can't be read, true else
+ *
+ *  Behavior:
+ *     normalizes and stems each word as indexPage does; words shorter than 3
+ *     characters are skipped, as they are never indexed anyway
+ */
+static bool loadStopwords(manifest_t* manifest, const char* stopFilename) {
+    FILE* fp = fopen(stopFilename, "r");
+    reader_t* reader = reader_new(fp);
+    if (reader == NULL) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        return false;
+    }
+    stemmer_t stemmer;
+    manifest_getStemmer(manifest, &stemmer);
+    char* line;
+    while ((line = reader_nextLine(reader, NULL)) != NULL) {
+        if (line[0] == '#') {
+            continue;
+        }
+        for (char* word = strtok(line, " \t\r"); word != NULL; word = strtok(NULL, " \t\r")) {
+            if (strlen(word) >= 3) {
+                normalizeWord(word);
+                stem_word(stemmer, word);
+                if (!manifest_addStopword(manifest, word)) {
+                    fprintf(stderr, "Couldn't allocate memory\n");
+                    exit(1);
+                }
+            }
+        }
+    }
+    reader_delete(reader);
+    fclose(fp);
+    return true;
+}
+
+/**************** addStopword() ****************                                                                                
+ *  addStopword - index_cutoff helper function, records a word left
+ *      out of the index as a stop word
+ *
+ *  Parameters:
+ *    arg - void* the manifest_t* to add it to
+ *    word - const char* the word
+ *
+ *  Returns:
+ *     void
+ */
+static void addStopword(void* arg, const char* word) {
+    if (!manifest_addStopword(arg, word)) {
+        fprintf(stderr, "Couldn't allocate memory\n");
+        exit(1);
+    }
 }
 
 /**************** indexPage() ****************                                                                                
  *  indexPage - validate given parameters
  *
  *  Parameters:
- *    pageDirectory - char* that contains page directory
- *    indexFilename - char* that contains file name of index file
+ *    webpage - webpage_t* page to index
+ *    docID - int its docID
+ *    index - index_t* index to add its words to
+ *    manifest - manifest_t* with the stemmer, and the stop words to
+ *               leave out; may be NULL for neither
  *
  *  Returns:
  *     void
  *
  *  Behavior:
- *
+ *     words are stemmed in place, after normalizing
  */
-static void indexPage(webpage_t* webpage, int docID, index_t* index) {
+static void indexPage(webpage_t* webpage, int docID, index_t* index, manifest_t* manifest) {
     int pos = 1;
     char* word;
+    stemmer_t stemmer;
+    manifest_getStemmer(manifest, &stemmer);
     while((word = webpage_getNextWord(webpage, &pos)) != NULL) {
         //skip trivial words (less than length 3)
         if (strlen(word) >= 3) {
             //normalize the word (convert to lower case)
             normalizeWord(word);
-            //look up the word in the index
-            if (!index_check(index, word)) {
-                //add the word to the index if needed
-                index_add(index, word, docID);
+            //reduce it to its stem, if the index is stemmed
+            stem_word(stemmer, word);
+            //stop words are left out of the index
+            if (!manifest_isStopword(manifest, word)) {
+                //look up the word in the index
+                if (!index_check(index, word)) {
+                    //add the word to the index if needed
+                    index_add(index, word, docID);
+                }
+                //increment the count of occurences of this word in this docID
+                //same function for adding and incrementing, check index.h
+                index_add(index, word, docID); 
             }
-            //increment the count of occurences of this word in this docID
-            //same function for adding and incrementing, check index.h
-            index_add(index, word, docID); 
         }
         free(word);
     }
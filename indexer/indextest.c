@@ -44,6 +44,10 @@ main (int argc, char* argv[])
 
         //create an index, fill based on file
         index_t* index = index_load(indexFilename);
+        if (index == NULL) {
+            fprintf(stderr, "Couldn't load %s\n", indexFilename);
+            exit(1);
+        }
 
         //write the index to another file
         index_save(index, newIndexFilename);
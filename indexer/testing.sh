@@ -98,6 +98,113 @@ echo "wikipedia depth 1 with output files put through indextest and compared thr
 ./indextest ../data/wiki-1.txt ../data/wiki-1-copy.txt
 ~/cs50-dev/shared/tse/indexcmp ../data/wiki-1.txt ../data/wiki-1-copy.txt
 
+# incremental builds: a base of 10 pages, then 16 batches of 4 pages, whose
+# segments merge four at a time (seg1-seg4 into seg5, ..., then seg5, seg10,
+# seg15 and seg20 into seg21); a query should find what a full build finds
+echo
+echo "toscrape depth 1 indexed incrementally, merged in tiers, then compacted"
+rm -rf ../data/growing ../data/growing.index*
+mkdir ../data/growing
+cp ../data/toscrape/1/.crawler ../data/growing/
+for id in $(seq 1 10); do cp ../data/toscrape/1/$id ../data/growing/; done
+./indexer ../data/growing ../data/growing.index
+for batch in $(seq 0 15); do
+    for id in $(seq $((11 + 4 * batch)) $((14 + 4 * batch))); do cp ../data/toscrape/1/$id ../data/growing/; done
+    ./indexer ../data/growing ../data/growing.index --incremental
+done
+./indexer ../data/growing ../data/growing.index --incremental
+./indexer --merge ../data/growing.index
+printf "bread\nbread or ice\ncapable wise or drawing and applicants\nstreet affairs\nwinter summer or night\n" > ../data/queries.txt
+../querier/querier ../data/toscrape/1 ../data/toscrape-1.txt < ../data/queries.txt > ../data/full.out
+../querier/querier ../data/growing ../data/growing.index < ../data/queries.txt > ../data/incremental.out
+diff ../data/full.out ../data/incremental.out && echo "incremental results match a full build"
+./indexer --compact ../data/growing.index
+../querier/querier ../data/growing ../data/growing.index < ../data/queries.txt > ../data/compacted.out
+diff ../data/full.out ../data/compacted.out && echo "compacted results match a full build"
+cmp ../data/toscrape-1.txt ../data/growing.index && echo "compacted index matches a full build"
+./indexer --compact ../data/growing.index
+
+# incremental run with no manifest builds the whole index
+echo
+echo "incremental run with no manifest"
+rm -f ../data/fresh.index*
+./indexer ../data/toscrape/1 ../data/fresh.index --incremental
+cmp ../data/toscrape-1.txt ../data/fresh.index && echo "same index as a full build"
+
+# deleting and updating pages: docIDs 6 and 8 are deleted, page 5 changes
+# (quokka becomes wombat) and page 9 disappears from the page directory;
+# neither the deleted pages nor page 5's old word are found, before or after
+# compacting
+echo
+echo "toscrape depth 1 with pages deleted and updated, then compacted"
+rm -rf ../data/changing ../data/changing.index*
+cp -r ../data/toscrape/1 ../data/changing
+echo "<p>quokka</p>" >> ../data/changing/5
+./indexer ../data/changing ../data/changing.index
+echo "quokka" | ../querier/querier ../data/changing ../data/changing.index
+./indexer --delete ../data/changing.index 6 8
+sed -i 's/quokka/wombat/' ../data/changing/5
+rm ../data/changing/9
+./indexer ../data/changing ../data/changing.index --update 5 9
+printf "quokka\nwombat\n" | ../querier/querier ../data/changing ../data/changing.index
+echo "bread or ice" | ../querier/querier ../data/changing ../data/changing.index | grep -E "^[0-9]+ (6|8|9) " || echo "deleted pages not returned"
+./indexer --compact ../data/changing.index
+printf "quokka\nwombat\n" | ../querier/querier ../data/changing ../data/changing.index
+echo "bread or ice" | ../querier/querier ../data/changing ../data/changing.index | grep -E "^[0-9]+ (6|8|9) " || echo "deleted pages not returned after compacting"
+
+# compressed builds: indextest reads each codec's index back and saves it as
+# text, which should be the text index; the querier reads either kind
+echo
+echo "toscrape depth 1 built with each codec, put through indextest"
+for codec in vbyte simple8b pfor; do
+    ./indexer ../data/toscrape/1 ../data/toscrape-1-$codec.index --codec $codec
+    ./indextest ../data/toscrape-1-$codec.index ../data/toscrape-1-$codec-copy.txt
+    cmp ../data/toscrape-1.txt ../data/toscrape-1-$codec-copy.txt && echo "$codec round-trips to the text index"
+    ../querier/querier ../data/toscrape/1 ../data/toscrape-1-$codec.index < ../data/queries.txt > ../data/$codec.out
+    diff ../data/full.out ../data/$codec.out && echo "$codec results match the text index"
+done
+
+# an unknown codec, and a build option on a run that isn't a full build
+echo
+echo "invalid codec, and --codec on an incremental run"
+./indexer ../data/toscrape/1 ../data/toscrape-1-zip.index --codec zip
+./indexer ../data/growing ../data/growing.index --incremental --codec vbyte
+
+# stop words and words in too many pages are left out; a query of nothing
+# but such words matches nothing, and they drop out of an andsequence
+echo
+echo "toscrape depth 1 with stop words and with --max-df"
+printf "# words that say little about a page\nthe for with\nfrom that\n" > ../data/stopwords.txt
+./indexer ../data/toscrape/1 ../data/toscrape-1-stop.index --stopwords ../data/stopwords.txt
+printf "the with\nthe or from\n" | ../querier/querier ../data/toscrape/1 ../data/toscrape-1-stop.index
+echo "bread the" | ../querier/querier ../data/toscrape/1 ../data/toscrape-1-stop.index | grep -v "^Query:" > ../data/stop.out
+echo "bread" | ../querier/querier ../data/toscrape/1 ../data/toscrape-1.txt | grep -v "^Query:" > ../data/nostop.out
+diff ../data/nostop.out ../data/stop.out && echo "bread the matches the pages bread does"
+./indexer ../data/toscrape/1 ../data/toscrape-1-maxdf.index --max-df 0.5
+echo "book" | ../querier/querier ../data/toscrape/1 ../data/toscrape-1-maxdf.index
+
+# invalid --max-df, --max-df on a sharded build, missing stop word file
+echo
+echo "invalid --max-df and --stopwords"
+./indexer ../data/toscrape/1 ../data/toscrape-1-maxdf.index --max-df 1.5
+./indexer ../data/toscrape/1 ../data/toscrape-1-maxdf.index --shards 3 --max-df 0.5
+./indexer ../data/toscrape/1 ../data/toscrape-1-stop.index --stopwords ../data/nonexistent.txt
+
+# a stemmed index answers the forms of a word alike, since the querier
+# stems the query as the index's pages were
+echo
+echo "toscrape depth 1 with --stem porter"
+./indexer ../data/toscrape/1 ../data/toscrape-1-stem.index --stem porter
+echo "crawled" | ../querier/querier ../data/toscrape/1 ../data/toscrape-1-stem.index | grep -v "^Query:" > ../data/crawled.out
+echo "crawling" | ../querier/querier ../data/toscrape/1 ../data/toscrape-1-stem.index | grep -v "^Query:" > ../data/crawling.out
+head -3 ../data/crawled.out
+diff ../data/crawled.out ../data/crawling.out && echo "crawled and crawling match the same pages"
+
+# unknown stemmer
+echo
+echo "invalid --stem"
+./indexer ../data/toscrape/1 ../data/toscrape-1-stem.index --stem snowball
+
 # valgrind checks on letters depth 10 and toscrape depth 1
 echo
 echo "valgrind: letters depth 10"
@@ -4,42 +4,86 @@
  * Bora Bozdogan, April 2025
  */
 
+#define _POSIX_C_SOURCE 200809L   // fdopen, fork, socketpair
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
-#include <limits.h>
 #include <unistd.h> 
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
 #include "mem.h"
 #include "webpage.h"
 #include "hashtable.h"
 #include "pagedir.h"
 #include "file.h"
+#include "reader.h"
 #include "index.h"
 #include "word.h"
-
-//struct used to get highest score while iterating counters
-typedef struct node {
-    int key;
+#include "query.h"
+#include "manifest.h"
+#include "stem.h"
+#include "dict.h"
+#include "trigram.h"
+
+//most words a prefix query (a word ending in '*') is expanded to
+static const int MAX_EXPANSIONS = 100;
+
+//one matching document: its docID and its score for the query
+typedef struct result {
+    int docID;
     int score;
-} node_t;
-
-//struct used for updateScores, holds two counters so they can be cross-checked
-typedef struct countersHolder {
-    counters_t* partialScores;
-    counters_t* newScores;
-} countersHolder_t;
+} result_t;
+
+//growable array of results, in rank order once sorted
+typedef struct resultList {
+    result_t* results;
+    int count;
+    int capacity;
+    int allocations;          // times results was grown, for --explain
+} resultList_t;
+
+//what one query took, for --explain: seconds in each stage
+typedef struct queryStats {
+    double parse;             // parsing, stemming and --fuzzy corrections
+    double evaluate;          // querier_process, or the shards' search
+    double rank;              // querier_rank
+    double lookup;            // loading each result's URL
+} queryStats_t;
+
+//a shard querier process, and the ends of the socket to it
+typedef struct shard {
+    pid_t pid;
+    FILE* to;                 // queries go out here
+    FILE* fromFp;             // results come back here
+    reader_t* from;
+    resultList_t results;     // the shard's results for the current query
+} shard_t;
 
 //function headers
 static bool querier_validateParams(char* pageDirectory, char* indexFilename);
-static char** querier_parse(char* line);
-static counters_t* querier_process(char** words, index_t* index);
-static void addScores(void* arg, const int key, const int count);
-static void updateScores(void* arg, const int key, const int count);
-static void initScores(void* arg, const int key, const int count);
-static void getHighestScore(void* arg, const int key, const int count);
-static bool querier_isLiteral(char* word);
+static query_t* querier_parse(char* line, const stemmer_t stemmer);
+static void querier_process(query_t* query, index_t* index, manifest_t* manifest,
+                            plan_t* plan, resultList_t* list);
+static void querier_rank(resultList_t* list);
+static void addResult(void* arg, const int key, const int count);
+static int compareResults(const void* a, const void* b);
+static void querier_print(char* pageDirectory, resultList_t* list, queryStats_t* stats);
+static void querier_explain(query_t* query, plan_t* plan, const int numShards,
+                            resultList_t* list, queryStats_t* stats);
+static double now(void);
+static shard_t* querier_startShards(char* indexFilename, const int numShards,
+                                    manifest_t* manifest);
+static void querier_serveShard(char* shardFilename, FILE* in, FILE* out, manifest_t* manifest);
+static void querier_gather(shard_t* shards, const int numShards, char** words, resultList_t* list);
+static void querier_stopShards(shard_t* shards, const int numShards);
+static void querier_correct(char** words, index_t* index, manifest_t* manifest,
+                            dict_t* dict, trigram_t* grams);
 int fileno(FILE *stream);
 static void prompt(void);
 
@@ -57,17 +101,39 @@ static void prompt(void);
  *    validates parameters, loads index, reads from stdin
  *    one line at a time, responds to queries with the most
  *    appropriate documents.
+ *    with --fuzzy, also loads the term dictionary and trigram index
+ *    beside the index, and replaces each query word that isn't in the
+ *    index with the closest word that is, see querier_correct.
+ *    with --explain, prints after each query's results how it was run
+ *    and what each stage took, see querier_explain.
+ *    if the indexer split the index into shards, starts one querier
+ *    process per shard instead, and acts as their coordinator: each
+ *    query goes to every shard, and their ranked results are merged.
  *   
  */
 int
 main (int argc, char* argv[])
 {   
-    if (argc != 3) {
-        fprintf(stderr, "Invalid argument number, input 2\n");
-        exit(1);   
-    }
     //argv[1] = pageDirectory - pathname of directory made by crawler
     //argv[2] = indexFilename - pathname of file produced by indexer
+    //then, in any order:
+    //--fuzzy, to search for misspelled words' closest words
+    //--explain, to print how each query was run, and what it took
+    bool fuzzy = false;
+    bool explain = false;
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--fuzzy") == 0 && !fuzzy) {
+            fuzzy = true;
+        } else if (strcmp(argv[i], "--explain") == 0 && !explain) {
+            explain = true;
+        } else {
+            argc = 0;
+        }
+    }
+    if (argc < 3) {
+        fprintf(stderr, "Invalid argument number, input 2 (and optionally --fuzzy, --explain)\n");
+        exit(1);   
+    }
     char* pageDirectory = argv[1];
     char* indexFilename = argv[2];
 
@@ -76,80 +142,108 @@ main (int argc, char* argv[])
         exit(1);
     }
 
-    //load index from indexFilename to internal data structure
-    //no need to check return value, querier_validateParams checks indexFilename
-    index_t* index = index_load(indexFilename);
+    //a sharded index is searched by one process per shard, see manifest.h;
+    //the manifest also lists the stop words left out of the index
+    manifest_t* manifest = manifest_load(indexFilename);
+    int numShards = manifest_getShards(manifest);
+    //query words must be stemmed as the index's were
+    stemmer_t stemmer;
+    if (!manifest_getStemmer(manifest, &stemmer)) {
+        fprintf(stderr, "%s was stemmed with a stemmer this querier doesn't know\n", indexFilename);
+        exit(1);
+    }
+    index_t* index = NULL;
+    shard_t* shards = NULL;
+    if (numShards > 1) {
+        shards = querier_startShards(indexFilename, numShards, manifest);
+    } else {
+        //load index from indexFilename to internal data structure
+        //querier_validateParams checks indexFilename can be read, but it may be corrupt
+        //with the segments of any incremental runs, see manifest.h
+        index = index_loadAll(indexFilename);
+        if (index == NULL) {
+            fprintf(stderr, "Couldn't load index %s\n", indexFilename);
+            exit(1);
+        }
+    }
 
-    //read from stdin, one per line, until eof
+    //the indexer writes both beside an unsharded base, see manifest.h
+    dict_t* dict = NULL;
+    trigram_t* grams = NULL;
+    if (fuzzy) {
+        char* dictName = manifest_dictName(indexFilename);
+        char* trigramName = manifest_trigramName(indexFilename);
+        dict = dict_load(dictName);
+        grams = trigram_load(trigramName);
+        free(dictName);
+        free(trigramName);
+        if (index == NULL || dict == NULL || grams == NULL) {
+            fprintf(stderr, "No term dictionary and trigram index beside %s; "
+                    "--fuzzy needs an unsharded index, built or compacted\n", indexFilename);
+            exit(1);
+        }
+    }
+
+    //read from stdin, one per line, until eof; queries are compiled into
+    //a plan, whose buffers are reused from query to query
+    reader_t* input = reader_new(stdin);
+    plan_t* plan = plan_new();
+    if (input == NULL || plan == NULL) {
+        fprintf(stderr, "Couldn't allocate memory\n");
+        exit(1);
+    }
     char* line;
-    char** words;
+    query_t* query;
+    resultList_t results = { NULL, 0, 0, 0 };
 
     //initially prompt the user
     prompt();
 
-    while ((line = file_readLine(stdin)) != NULL) {
+    //line lives in the reader's buffer until the next query is read
+    while ((line = reader_nextLine(input, NULL)) != NULL) {
         //clean and parse each query according to syntax
         //continue with algorithm if valid query
-        if ((words = querier_parse(line)) != NULL) {
-            //counter contains all docIDs with scores
-            counters_t* scores = querier_process(words, index);
-
-            node_t* highestScore = mem_malloc(sizeof(node_t));
-
-            if (highestScore == NULL) {
-                fprintf(stderr, "Couldn't allocate memory\n");
-                exit(1);
+        //each stage is timed whether or not it is printed, a clock
+        //read apiece, so --explain shows what an ordinary query takes
+        queryStats_t stats = { 0, 0, 0, 0 };
+        double start = now();
+        if ((query = querier_parse(line, stemmer)) != NULL) {
+            if (fuzzy) {
+                querier_correct(query_words(query), index, manifest, dict, grams);
             }
-            
-            //arbitary value to set to zero inside the while loop
-            highestScore->score = -1; 
-            highestScore->key = 0;
-
-            //boolean that will be false after the first iteration of while loop
-            bool firstIteration = true;
-
-            //if value 0, means that every counter value has set to 0
-            while (highestScore->score != 0) {
-                
-                //set highestScore to 0
-                highestScore->score = 0;
-                
-                //find highest score, save key and score to highestScore
-                counters_iterate(scores, highestScore, getHighestScore);
-            
-                //set value of counter with highest score to 0
-                counters_set(scores, highestScore->key, 0);
-
-                if (highestScore->score != 0) {
-                    //use webpage to get URL easily
-                    webpage_t* webpage = pagedir_load(pageDirectory, highestScore->key);
-                    webpage_fetch(webpage);
-                    
-                    //print highest score, doc ID, URL
-                    printf("%d %d %s\n", highestScore->score, highestScore->key, webpage_getURL(webpage));
-                    webpage_delete(webpage);
-                } 
-
-                //if on first iteration and highest score in counters is zero
-                if (firstIteration && highestScore->score == 0) {
-                    //no documents were found, print message
-                    printf("No documents match\n");
-                }
-
-                firstIteration = false;
-
+            double parsed = now();
+            stats.parse = parsed - start;
+            results.allocations = 0;
+            if (shards != NULL) {
+                //each shard ranks its own documents
+                querier_gather(shards, numShards, query_words(query), &results);
+                stats.evaluate = now() - parsed;
+            } else {
+                //results hold all docIDs with scores
+                querier_process(query, index, manifest, plan, &results);
+                double evaluated = now();
+                stats.evaluate = evaluated - parsed;
+                querier_rank(&results);
+                stats.rank = now() - evaluated;
             }
-            //free variables
-            free(highestScore);
-            counters_delete(scores);
-            freeWords(words);
+            querier_print(pageDirectory, &results, &stats);
+            if (explain) {
+                querier_explain(query, plan, numShards, &results, &stats);
+            }
+            query_delete(query);
         }
-        free(line);
 
         //prompt the user again for next query
         prompt();
     }
+    free(results.results);
+    plan_delete(plan);
+    querier_stopShards(shards, numShards);
+    manifest_delete(manifest);
     index_delete(index);
+    dict_delete(dict);
+    trigram_delete(grams);
+    reader_delete(input);
 
     //go next line after empty prompt message
     printf("\n");
@@ -158,29 +252,400 @@ main (int argc, char* argv[])
     exit(0);
 }
 
-/**************** getHighestScore() ****************                                                                                
- *  getHighestScore - main helper function,
- *      make node equal to highest score in scores
+/**************** querier_rank() ****************                                                                                
+ *  querier_rank - rank the documents that match a query
+ *
+ *  Parameters:
+ *     list - resultList_t* the results of querier_process, sorted in place
+ *
+ *  Returns:
+ *     void 
+ *
+ *  Behavior:
+ *     sorts the docIDs highest score first, lowest docID first among
+ *     equal scores; shards rank the same way, so their lists merge into
+ *     the order one index gives
+ *
+ */
+static void querier_rank(resultList_t* list) {
+    if (list->count > 1) {
+        qsort(list->results, list->count, sizeof(result_t), compareResults);
+    }
+}
+
+/**************** addResult() ****************                                                                                
+ *  addResult - querier_rank helper function,
+ *      append a docID and its score to a result list
+ *
+ *  Parameters:
+ *     arg - void* parameter used for reference to the resultList
+ *     key - const int docID
+ *     count - const int its score
+ *
+ *  Returns:
+ *     void 
+ *
+ */
+static void addResult(void* arg, const int key, const int count) {
+    resultList_t* list = arg;
+    if (count <= 0) {
+        //docID didn't satisfy the query
+        return;
+    }
+    if (list->count == list->capacity) {
+        list->capacity = (list->capacity == 0) ? 64 : list->capacity * 2;
+        list->allocations++;
+        list->results = mem_assert(realloc(list->results, list->capacity * sizeof(result_t)),
+                                   "Couldn't allocate memory");
+    }
+    list->results[list->count].docID = key;
+    list->results[list->count].score = count;
+    list->count++;
+}
+
+/**************** compareResults() ****************                                                                                
+ *  compareResults - qsort comparator, orders results by rank
+ *
+ *  Returns:
+ *     int - negative if a ranks before b: higher score, or equal score
+ *           and lower docID
+ */
+static int compareResults(const void* a, const void* b) {
+    const result_t* x = a;
+    const result_t* y = b;
+    if (x->score != y->score) {
+        return (x->score < y->score) - (x->score > y->score);
+    }
+    return (x->docID > y->docID) - (x->docID < y->docID);
+}
+
+/**************** querier_print() ****************                                                                                
+ *  querier_print - print ranked results
  *
  *  Parameters:
- *     arg - void* parameter used for reference to Node struct
- *     key - const char* key of counter's current loop 
- *     count - const int current value
+ *     pageDirectory - char* page directory, to look up URLs
+ *     list - resultList_t* ranked results
+ *     stats - queryStats_t* whose lookup time we add to
  *
  *  Returns:
  *     void 
  *
  *  Behavior:
- *     sets struct to highest value among the counters
+ *     prints score, docID and URL of each result, in rank order,
+ *     or a message if there are none
  *
  */
-static void getHighestScore(void* arg, const int key, const int count) {
-    node_t* highestScore = arg;
-    
-    if (count > highestScore->score) {
-        highestScore->score = count;
-        highestScore->key = key;
+static void querier_print(char* pageDirectory, resultList_t* list, queryStats_t* stats) {
+    if (list->count == 0) {
+        //no documents were found, print message
+        printf("No documents match\n");
+    }
+    for (int i = 0; i < list->count; i++) {
+        //use webpage to get URL easily
+        double start = now();
+        webpage_t* webpage = pagedir_load(pageDirectory, list->results[i].docID);
+        webpage_fetch(webpage);
+        stats->lookup += now() - start;
+
+        //print highest score, doc ID, URL
+        printf("%d %d %s\n", list->results[i].score, list->results[i].docID, webpage_getURL(webpage));
+        webpage_delete(webpage);
+    }
+}
+
+/**************** querier_explain() ****************                                                                                
+ *  querier_explain - print how a query was run, for --explain
+ *
+ *  Parameters:
+ *     query - query_t* the parsed query
+ *     plan - plan_t* it was compiled into and run, unless sharded
+ *     numShards - const int number of shards, 0 or 1 if unsharded
+ *     list - resultList_t* its ranked results
+ *     stats - queryStats_t* the time each stage took
+ *
+ *  Returns:
+ *     void 
+ *
+ *  Behavior:
+ *     prints, after the results, the plan's steps with the sizes of
+ *     the postings they read and the documents they gave (see
+ *     plan_explain), then the postings read, documents scored and
+ *     allocations made, and the milliseconds spent parsing, evaluating,
+ *     ranking and looking up URLs. Every line starts with a word, so
+ *     it can't be taken for a result. A sharded index is searched by
+ *     the shards, whose plans we don't see.
+ *
+ */
+static void querier_explain(query_t* query, plan_t* plan, const int numShards,
+                            resultList_t* list, queryStats_t* stats) {
+    if (numShards > 1) {
+        printf("Plan: searched by %d shards, %d matched\n", numShards, list->count);
+        printf("Allocations: %d for results\n", list->allocations);
+    } else {
+        planStats_t planStats;
+        plan_stats(plan, &planStats);
+        printf("Plan:\n");
+        plan_explain(plan, query, stdout);
+        printf("Postings: %d read, %d documents scored, %d matched\n",
+               planStats.postings, planStats.documents, list->count);
+        printf("Allocations: %d by the plan, %d for results\n",
+               planStats.allocations, list->allocations);
     }
+    printf("Time: parse %.3f ms, evaluate %.3f ms, rank %.3f ms, URL lookup %.3f ms\n",
+           stats->parse * 1000, stats->evaluate * 1000, stats->rank * 1000,
+           stats->lookup * 1000);
+}
+
+/**************** now() ****************                                                                                
+ *  now - read the clock, for --explain
+ *
+ *  Returns:
+ *     double - seconds since some fixed time, from a clock that only
+ *              goes forward
+ */
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**************** querier_startShards() ****************                                                                                
+ *  querier_startShards - start a querier process for each shard
+ *
+ *  Parameters:
+ *     indexFilename - char* file name of the sharded index
+ *     numShards - const int number of shards
+ *     manifest - manifest_t* of the index, for its stop words
+ *
+ *  Returns:
+ *     shard_t* array of numShards shards, exits nonzero on error
+ *
+ *  Behavior:
+ *     checks every shard file can be read, then forks a child per
+ *     shard, connected to us by a Unix socket pair, that loads only its
+ *     shard's index and answers queries until the socket closes
+ *
+ */
+static shard_t* querier_startShards(char* indexFilename, const int numShards,
+                                    manifest_t* manifest) {
+    shard_t* shards = mem_calloc_assert(numShards, sizeof(shard_t), "Couldn't allocate memory");
+    char** shardNames = mem_calloc_assert(numShards, sizeof(char*), "Couldn't allocate memory");
+    for (int i = 0; i < numShards; i++) {
+        shardNames[i] = manifest_shardName(indexFilename, i + 1);
+        FILE* fp = (shardNames[i] == NULL) ? NULL : fopen(shardNames[i], "r");
+        if (fp == NULL) {
+            fprintf(stderr, "Couldn't open shard %d of %s for reading\n", i + 1, indexFilename);
+            exit(1);
+        }
+        fclose(fp);
+    }
+
+    //a shard that stops makes writes to it fail, rather than kill us
+    signal(SIGPIPE, SIG_IGN);
+    fflush(NULL);   //or children would inherit, and repeat, buffered output
+
+    for (int i = 0; i < numShards; i++) {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0 || (shards[i].pid = fork()) < 0) {
+            fprintf(stderr, "Couldn't start shard %d\n", i + 1);
+            exit(1);
+        }
+        if (shards[i].pid == 0) {
+            //child: drop the sockets to the shards started before this one,
+            //so they see their socket close when we stop
+            for (int j = 0; j < i; j++) {
+                fclose(shards[j].to);
+                reader_delete(shards[j].from);
+                fclose(shards[j].fromFp);
+            }
+            close(fds[0]);
+            FILE* in = fdopen(fds[1], "r");
+            FILE* out = fdopen(dup(fds[1]), "w");
+            if (in == NULL || out == NULL) {
+                exit(1);
+            }
+            querier_serveShard(shardNames[i], in, out, manifest);
+            //and free what we inherited from the coordinator
+            for (int j = 0; j < numShards; j++) {
+                free(shardNames[j]);
+            }
+            free(shardNames);
+            free(shards);
+            manifest_delete(manifest);
+            exit(0);
+        }
+        //parent: talk over fds[0], one FILE for each direction
+        close(fds[1]);
+        shards[i].to = fdopen(fds[0], "w");
+        shards[i].fromFp = fdopen(dup(fds[0]), "r");
+        shards[i].from = reader_new(shards[i].fromFp);
+        if (shards[i].to == NULL || shards[i].from == NULL) {
+            fprintf(stderr, "Couldn't start shard %d\n", i + 1);
+            exit(1);
+        }
+    }
+
+    for (int i = 0; i < numShards; i++) {
+        free(shardNames[i]);
+    }
+    free(shardNames);
+    return shards;
+}
+
+/**************** querier_serveShard() ****************                                                                                
+ *  querier_serveShard - answer queries against one shard
+ *
+ *  Parameters:
+ *     shardFilename - char* index file of the shard
+ *     in - FILE* queries come in here, one per line, already parsed
+ *     out - FILE* results go out here
+ *     manifest - manifest_t* of the whole index, for its stop words
+ *
+ *  Returns:
+ *     void, once in reaches EOF
+ *
+ *  Behavior:
+ *     for each query, runs querier_process on the shard's index and
+ *     writes its ranked results as "docID score" lines, then an empty
+ *     line to end them
+ *
+ */
+static void querier_serveShard(char* shardFilename, FILE* in, FILE* out, manifest_t* manifest) {
+    index_t* index = index_loadAll(shardFilename);
+    reader_t* reader = reader_new(in);
+    plan_t* plan = plan_new();
+    resultList_t results = { NULL, 0, 0 };
+    char* line;
+    //a shard that can't be loaded answers nothing, and the coordinator stops
+    while (index != NULL && reader != NULL && plan != NULL
+           && (line = reader_nextLine(reader, NULL)) != NULL) {
+        //the coordinator sends only queries it parsed
+        char error[200];
+        char** words = query_tokens(line);
+        query_t* query = (words == NULL) ? NULL : query_new(words, error, sizeof(error));
+        results.count = 0;
+        if (query != NULL) {
+            querier_process(query, index, manifest, plan, &results);
+            querier_rank(&results);
+        } else if (words != NULL) {
+            freeWords(words);
+        }
+        for (int i = 0; i < results.count; i++) {
+            fprintf(out, "%d %d\n", results.results[i].docID, results.results[i].score);
+        }
+        fprintf(out, "\n");
+        fflush(out);
+        query_delete(query);
+    }
+    free(results.results);
+    plan_delete(plan);
+    reader_delete(reader);
+    index_delete(index);
+    fclose(in);
+    fclose(out);
+}
+
+/**************** querier_gather() ****************                                                                                
+ *  querier_gather - run a query on every shard and merge the results
+ *
+ *  Parameters:
+ *     shards - shard_t* the shard processes
+ *     numShards - const int number of shards
+ *     words - char** the parsed query
+ *     list - resultList_t* filled with the merged results
+ *
+ *  Returns:
+ *     void, exits nonzero if a shard stops
+ *
+ *  Behavior:
+ *     sends the query to all shards before reading any answer, so they
+ *     search at the same time; each shard's results come ranked, and a
+ *     document's score depends only on its own postings, so merging
+ *     the lists gives the ranking of the whole index
+ *
+ */
+static void querier_gather(shard_t* shards, const int numShards, char** words, resultList_t* list) {
+    //scatter
+    for (int i = 0; i < numShards; i++) {
+        for (char** word = words; *word != NULL; word++) {
+            fprintf(shards[i].to, (word == words) ? "%s" : " %s", *word);
+        }
+        fprintf(shards[i].to, "\n");
+        fflush(shards[i].to);
+    }
+
+    //gather each shard's ranked list, up to its empty line
+    for (int i = 0; i < numShards; i++) {
+        resultList_t* shardList = &shards[i].results;
+        shardList->count = 0;
+        char* line;
+        while ((line = reader_nextLine(shards[i].from, NULL)) != NULL && *line != '\0') {
+            int docID, score;
+            if (sscanf(line, "%d %d", &docID, &score) == 2) {
+                addResult(shardList, docID, score);
+            }
+        }
+        if (line == NULL) {
+            fprintf(stderr, "Shard %d stopped\n", i + 1);
+            exit(1);
+        }
+    }
+
+    //merge: repeatedly take the best of the shards' next results
+    list->count = 0;
+    int* next = mem_calloc_assert(numShards, sizeof(int), "Couldn't allocate memory");
+    while (true) {
+        result_t* best = NULL;
+        for (int i = 0; i < numShards; i++) {
+            if (next[i] < shards[i].results.count) {
+                result_t* candidate = &shards[i].results.results[next[i]];
+                if (best == NULL || compareResults(candidate, best) < 0) {
+                    best = candidate;
+                }
+            }
+        }
+        if (best == NULL) {
+            break;
+        }
+        addResult(list, best->docID, best->score);
+        for (int i = 0; i < numShards; i++) {
+            if (next[i] < shards[i].results.count && best == &shards[i].results.results[next[i]]) {
+                next[i]++;
+            }
+        }
+    }
+    free(next);
+}
+
+/**************** querier_stopShards() ****************                                                                                
+ *  querier_stopShards - stop the shard processes
+ *
+ *  Parameters:
+ *     shards - shard_t* the shard processes, or NULL if none
+ *     numShards - const int number of shards
+ *
+ *  Returns:
+ *     void 
+ *
+ *  Behavior:
+ *     closes each shard's socket, which ends its query loop, then
+ *     waits for it to exit
+ *
+ */
+static void querier_stopShards(shard_t* shards, const int numShards) {
+    if (shards == NULL) {
+        return;
+    }
+    for (int i = 0; i < numShards; i++) {
+        fclose(shards[i].to);
+        reader_delete(shards[i].from);
+        fclose(shards[i].fromFp);
+        free(shards[i].results.results);
+    }
+    for (int i = 0; i < numShards; i++) {
+        waitpid(shards[i].pid, NULL, 0);
+    }
+    free(shards);
 }
 
 /**************** querier_validateParams() ****************                                                                                
@@ -223,25 +688,33 @@ static bool querier_validateParams(char* pageDirectory, char* indexFilename) {
  *
  *  Parameters:
  *     line - char* input read from stdin
+ *     stemmer - const stemmer_t the index's words were stemmed with
  *
  *  Returns:
- *     char* - the parsed query
+ *     query_t* - the parsed query
  *
  *  Behavior:
  *     clean the query, ignore blank lines, convert to lowercase
- *     parses the input line from stdin according to the backus-naur syntax
+ *     parses the input line from stdin according to the backus-naur
+ *     syntax of query.h: words joined by 'and' (which may be left out),
+ *     'or' and 'not', grouped with parentheses
  *     if query syntax invalid, print error message, don't parse query
  *     if query empty, do nothing
+ *     a word may end in '*', a prefix query, if it has letters before
+ *     it; '*' anywhere else is an invalid character
+ *     words of a valid query are stemmed in place, as the indexer
+ *     stemmed the pages' words, but not prefixes, which match the
+ *     index's (stemmed) words as typed; the query is printed as typed
  */
-static char** querier_parse(char* line) {
-    
+static query_t* querier_parse(char* line, const stemmer_t stemmer) {
+
+    //split sentence into words, '(' and ')' apart from them
+    char** words = mem_assert(query_tokens(line), "Couldn't allocate memory");
     //check for blank lines, ignore if blank
-    if (countWords(line) == 0) {
+    if (words[0] == NULL) {
+        freeWords(words);
         return NULL;
     }
-
-    //not blank, split sentence into words
-    char** words = splitWords(line);
     //normalize each word, convert to lowercase
     for(char** currentWord = words; *currentWord != NULL; currentWord++) {
         normalizeWord(*currentWord);
@@ -255,255 +728,132 @@ static char** querier_parse(char* line) {
     printf("\n");
     fflush(stdout); //flush it out so testing.out looks proper order without buffers
 
-    /* loop over words, make sure it fits backus-naur by checking if
-    if it starts with a literal, or if two literals are together 
-    or if it has invalid characters*/
-    char* word = words[0]; // first word
-    if (querier_isLiteral(word)) {
-        //starts with 'and' or 'or', print error
-        fprintf(stderr, "Error: '%s' cannot be first\n", word);
+    /* make sure it fits backus-naur: operators where an operand belongs,
+    (starting or ending with one, or two together), unbalanced
+    parentheses, or an andsequence with nothing but 'not's */
+    char error[200];
+    query_t* query = query_new(words, error, sizeof(error));
+    if (query == NULL) {
+        fprintf(stderr, "%s\n", error);
         freeWords(words);
         return NULL;
     }
-    //loop over the words, to check if it has two adjacent literals, end with 
-    //literal, or has invalid characters
-    for(char** currentWord = words; *(currentWord + 1) != NULL; currentWord++) {
-        char* nextWord = *(currentWord + 1);
-        if (querier_isLiteral(nextWord) && querier_isLiteral(*currentWord)) {
-            //two adjacent literals, print error
-            fprintf(stderr, "Error: '%s' and '%s' cannot be adjacent\n", *currentWord, nextWord);
-            freeWords(words);
-            return NULL;
-        }
-        
-        //check if last word is a literal
-        if (*(currentWord + 2) == NULL) {
-            //nextWord is the last word
-            if (querier_isLiteral(nextWord)) {
-                fprintf(stderr, "Error: '%s' cannot be last\n", nextWord);
-                freeWords(words);
-                return NULL;
-            }
-        }
-    }
 
     //loop over words and check each word if it contains invalid characters
     for(char** currentWord = words; *(currentWord) != NULL; currentWord++) {
+        if (!query_isWord(*currentWord)) {
+            continue;
+        }
         //check if word has invalid characters
         for (char* c = *currentWord; *c != '\0'; c++) {
+            if (*c == '*' && c[1] == '\0' && c != *currentWord) {
+                //a prefix query
+                continue;
+            }
             if (isalpha((unsigned char)*c) == 0) {
                 //c is invalid
                 fprintf(stderr, "Error: invalid character '%c' in query\n", *c);
-                freeWords(words);
+                query_delete(query);
                 return NULL;
             }
         }   
     }
 
-    //return array of words
-    return words;
-}
-
-/**************** querier_process() ****************                                                                                
- *  querier_process - process the query
- *
- *  Parameters:
- *     words - char** array of words
- *     index - index_t* index of word counts
- *
- *  Returns:
- *     counter_t* counter containing all docIDs that satisfy any part of query
- *     with score as item    
- *
- *  Behavior:
- *     scores the document based on how well it fits the query. Keeps
- *     "partial score" for each andsequence seperated by 'or', where 
- *     it always sets partial score to lowest value seen in that
- *     andsequence. When it encounters an 'or', adds the partial score
- *     to total score. Holds counters that do this algortihm for any
- *     docID that contains any of the words.
- *
- */
-static counters_t* querier_process(char** words, index_t* index) {
-
-    //initialize counters holding docID as key, partial and total score as item
-    counters_t* partialScores = counters_new();
-    counters_t* totalScores = counters_new();
-
-    //variable only true on the first loop of a new andsequence
-    bool isFirstWord = true;
-
-
+    //stem the words, not operators or prefixes
     for(char** currentWord = words; *currentWord != NULL; currentWord++) {
-
-        if (strcmp(*currentWord, "and") == 0) {
-            //word equals 'and', don't do anything
-            continue;
-        } else if (strcmp(*currentWord, "or") == 0) {
-            //loop over all docIDs in partialScores, call addScores
-            counters_iterate(partialScores, totalScores, addScores);
-            //reset partialScores (the andsequence)
-            counters_delete(partialScores);
-            partialScores = counters_new();
-            //set true for next andsequence
-            isFirstWord = true;
-        } else {
-            //check if word in index, skip if not
-            if (index_check(index, *currentWord)) {
-                //get counter of word
-                counters_t* newScores = index_find(index, *currentWord);
-                if (isFirstWord) {
-                    /*
-                    first word of andsequence, can accept new docIDs
-                    initialize score of each docID
-                    */
-                    counters_iterate(newScores, partialScores, initScores);
-                    isFirstWord = false;
-                } else {
-                    /*
-                    if newScores doesn't have a key that exists in partialScores
-                    that key in partialScores must be set to 0
-                    
-                    following struct is required because counters_iterate must
-                    access both the newScores and partialScores
-                    */
-                    countersHolder_t* holder = mem_malloc(sizeof(countersHolder_t));
-
-                    if (holder == NULL) {
-                        fprintf(stderr, "Couldn't allocate memory\n");
-                        exit(1);
-                    }
-
-                    holder->partialScores = partialScores;
-                    holder->newScores = newScores;
-
-                    //iterate over partialScores, update scores based on newScores
-                    counters_iterate(partialScores, holder, updateScores);
-                    free(holder);
-                }
-            } else {
-                //word not in index, reset partialScores, andsequence 0 for all
-                counters_delete(partialScores);
-                partialScores = counters_new();
-
-                isFirstWord = false;
-            }
+        if (query_isWord(*currentWord) && !query_isPrefix(*currentWord)) {
+            stem_word(stemmer, *currentWord);
         }
     }
-    //add partialScores out of loop in case it never encounters an 'or'
-    counters_iterate(partialScores, totalScores, addScores);
-    //free unused counters
-    counters_delete(partialScores);
-
-    return totalScores;
-}
-
 
-
-/**************** querier_isLiteral() ****************                                                                                
- *  querier_isLiteral - check if the word is a literal (and - or)
- *
- *  Parameters:
- *     word - char* word to check
- *
- *  Returns:
- *     bool - true if word equals to 'and' or 'or'
- */
-static bool querier_isLiteral(char* word) {
-    if (strcmp(word, "and") == 0 || strcmp(word, "or" ) == 0) {
-        //it's a literal, return true
-        return true;
-    }
-    return false;
+    //return the parsed query
+    return query;
 }
 
-/**************** addScores() ****************                                                                                
- *  addScores - querier-process helper function,
- *      add the partial scores to total scores
+/**************** querier_correct() ****************                                                                                
+ *  querier_correct - replace misspelled query words
  *
  *  Parameters:
- *     arg - void* parameter used for reference to totalScores
- *     key - const char* key of counter's current loop 
- *     count - const int current value
+ *     words - char** the parsed query
+ *     index - index_t* index of word counts
+ *     manifest - manifest_t* of the index, for its stop words
+ *     dict - dict_t* the base's term dictionary
+ *     grams - trigram_t* its trigram index
  *
  *  Returns:
- *     void 
+ *     void
  *
  *  Behavior:
- *     adds the partial scores to totalScores
+ *     each word that isn't in the index, and isn't an operator, a
+ *     prefix or a stop word, is replaced with the word of dict fewest
+ *     edits from it, allowing one edit in words of 3 to 5 letters and
+ *     two in longer words; says so on stderr. A word with nothing
+ *     close enough is left, and matches nothing, as without --fuzzy.
+ *     Words only in segments newer than the base aren't suggested.
  *
  */
-static void addScores(void* arg, const int key, const int count) {
-    counters_t* totalScores = arg;
-    //increment the value of docID by partialScore
-    /*
-    this accounts for new docIDs as well since counters_get returns 0 for 
-    previously unencountered keys, new counter will be created at the right
-    value
-    */
-    //check if score infinite, if it stays infinite, andsequence wasn't satisfied
-    if (count != INT_MAX) {
-        counters_set(totalScores, key, counters_get(totalScores, key) + count);
+static void querier_correct(char** words, index_t* index, manifest_t* manifest,
+                            dict_t* dict, trigram_t* grams) {
+    for (char** currentWord = words; *currentWord != NULL; currentWord++) {
+        char* word = *currentWord;
+        if (!query_isWord(word) || query_isPrefix(word)
+            || manifest_isStopword(manifest, word) || index_check(index, word)) {
+            continue;
+        }
+        int length = strlen(word);
+        int maxDist = (length < 3) ? 0 : (length < 6) ? 1 : 2;
+        int distance = 0;
+        int id = trigram_match(grams, dict, word, maxDist, &distance);
+        char* closest = (id < 0) ? NULL : dict_word(dict, id);
+        if (closest != NULL) {
+            fprintf(stderr, "Note: '%s' isn't in the index, searching '%s'\n", word, closest);
+            free(word);
+            *currentWord = closest;
+        }
     }
 }
 
-/**************** initScores() ****************                                                                                
- *  initScores - querier-process helper function,
- *      gets called on first word of andsequence
- *      initialize previously unseen docIDs
+/**************** querier_process() ****************                                                                                
+ *  querier_process - process the query
  *
  *  Parameters:
- *     arg - void* parameter used for reference to partialScores
- *     key - const char* key of counter's current loop 
- *     count - const int current value
+ *     query - query_t* the parsed query
+ *     index - index_t* index of word counts
+ *     manifest - manifest_t* of the index, for its stop words; may be NULL
+ *     plan - plan_t* to compile the query into, reused from query to query
+ *     list - resultList_t* filled with the documents that match, and
+ *            their scores, in docID order
  *
  *  Returns:
- *     void 
+ *     void, exits nonzero if out of memory
  *
  *  Behavior:
- *     sets all partial scores to first word's value
- *
- */
-static void initScores(void* arg, const int key, const int count) {
-    //it's first word of andsequence, counter should be set to count regardless
-    counters_t* partialScores = arg;
-    counters_set(partialScores, key, count);
-}
-
-
-/**************** updateScores() ****************                                                                                
- *  updateScores - querier-process helper function,
- *     updates partial scores
- *
- *  Parameters:
- *     arg - void* parameter used for reference to partialScores
- *     key - const char* key of counter's current loop 
- *     count - const int current value
- *
- *  Returns:
- *     void 
+ *     scores the document based on how well it fits the query: an
+ *     andsequence scores the lowest of its words' counts, or nothing if
+ *     a word (not under 'not') is missing, and 'or' adds the scores of
+ *     its andsequences, the same at any depth of parentheses. The query
+ *     is compiled into a plan against the index (see query.h), which
+ *     looks up each word's postings, merged across the segments of the
+ *     index and leaving out deleted and outdated pages, and orders each
+ *     andsequence's words so the rarest goes first; then the plan runs.
+ *     Stop words, which the indexer left out, are true of every
+ *     document: they are skipped, and an andsequence of nothing but
+ *     stop words matches nothing.
+ *     Common words, those the index has a docset for, are probed in
+ *     their docsets, without merging their (long) postings.
+ *     A prefix query stands for the words it expands to, as if they
+ *     were one word: a document's count is the sum of theirs. Their
+ *     postings are united into a docset, probed as common words are.
  *
- *  Behavior:
- *     checks if the word seen occurs in previous partialScores
- *     sets the partialScore to 0 if not, if seen, sets it to min
  */
-static void updateScores(void* arg, const int key, const int count) {
-    countersHolder_t* holder = arg;
-    counters_t* partialScores = holder->partialScores;
-    counters_t* newScores = holder->newScores;
-
-    int newScore = counters_get(newScores, key);
-    if (newScore > 0) {
-        //docID in partialScores has the new word as well
-        if (newScore < count) {
-            //new value lower, set it to score for andsequence
-            counters_set(partialScores, key, newScore);
-        }
-    } else {
-        //docID in partialScores does not have new word, set to 0
-        counters_set(partialScores, key, 0);
+static void querier_process(query_t* query, index_t* index, manifest_t* manifest,
+                            plan_t* plan, resultList_t* list) {
+    list->count = 0;
+    if (!plan_compile(plan, query, index, manifest, MAX_EXPANSIONS)
+        || plan_run(plan, list, addResult) < 0) {
+        fprintf(stderr, "Couldn't allocate memory\n");
+        exit(1);
     }
-
 }
 
 /****** prompt() ******/
@@ -514,5 +864,7 @@ prompt(void)
   // print a prompt iff stdin is a tty (terminal)
   if (isatty(fileno(stdin))) {
     printf("Query? ");
+    //stdin is read with read(), which doesn't flush stdout as stdio does
+    fflush(stdout);
   }
 }
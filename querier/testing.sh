@@ -91,6 +91,78 @@ echo
 echo "random capitalization query"
 echo "bReaD oR bUtTeR" | ./querier ../data/toscrape/1/ ../data/indexes/toscrape1.index
 
+# the cases below run on a small page directory written here, rather
+# than the crawled website, so that their results are the same anywhere
+FIXTURE=../data/fixture
+mkdir -p $FIXTURE ../data/indexes
+touch $FIXTURE/.crawler
+page() {
+    printf "http://cs50tse.cs.dartmouth.edu/tse/fixture/%s.html\n0\n<html><body>\n%s\n</body></html>\n" "$1" "$2" > $FIXTURE/$1
+}
+page 1 "bread butter bread crawl capable wise"
+page 2 "bread ice cream crawled drawing"
+page 3 "butter ice street affairs crawling"
+page 4 "capable drawing applicants crawler bread"
+page 5 "wise applicants street crawls ice ice"
+page 6 "cream affairs drawing butter"
+#130 words starting 'pre', more than a prefix query searches
+page 7 "$(for a in {a..z}; do for b in a e i o u; do printf "pre%s%s " $a $b; done; done)"
+../indexer/indexer $FIXTURE/ ../data/indexes/fixture.index
+
+# parentheses query, same as the query without them distributed
+echo
+echo "parentheses query"
+echo "(capable or drawing) and (wise or applicants)" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+
+# not query
+echo
+echo "not query"
+echo "bread not (butter or ice)" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+
+# invalid parentheses and not queries
+echo
+echo "invalid parentheses and not queries"
+echo "(bread or butter" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+echo "bread ()" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+echo "bread or not butter" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+
+# prefix query: a word ending in '*' matches every word that begins so
+echo
+echo "prefix query"
+echo "crawl*" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+echo "crawl* not crawled" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+
+# prefix with more than 100 words: the query searches the first 100
+echo
+echo "prefix query matching more than 100 words"
+echo "pre*" | ./querier $FIXTURE/ ../data/indexes/fixture.index
+
+# fuzzy query: a word not in the index is searched as its closest word,
+# unless it is too short to correct
+echo
+echo "fuzzy query"
+echo "breod or ice" | ./querier $FIXTURE/ ../data/indexes/fixture.index --fuzzy
+echo "ic" | ./querier $FIXTURE/ ../data/indexes/fixture.index --fuzzy
+
+# explain: the plan and what each stage took, after the results
+echo
+echo "explain query"
+echo "capable wise or drawing and applicants" | ./querier $FIXTURE/ ../data/indexes/fixture.index --explain
+
+# sharded index: three shard processes on this host, same results as one index
+echo 
+echo "sharded index"
+../indexer/indexer $FIXTURE/ ../data/indexes/fixture-sharded.index --shards 3
+printf "capable wise or drawing and applicants\nbread not (butter or ice)\ncrawl*\n" > ../data/shardqueries.txt
+./querier $FIXTURE/ ../data/indexes/fixture.index < ../data/shardqueries.txt > ../data/unsharded.out
+./querier $FIXTURE/ ../data/indexes/fixture-sharded.index < ../data/shardqueries.txt > ../data/sharded.out
+diff ../data/unsharded.out ../data/sharded.out && echo "sharded results match"
+
+# fuzzy query on a sharded index, which has no term dictionary to correct from
+echo
+echo "fuzzy query on a sharded index"
+echo "breod" | ./querier $FIXTURE/ ../data/indexes/fixture-sharded.index --fuzzy
+
 # valgrind and query
 echo 
 echo "valgrind and query"